@@ -11,27 +11,118 @@
  *
  * Licence:    Open Source (Unlicensed) -- free to copy, distribute, modify
  *
- * Notes:   1. The value defined by the symbol NUMBER_OF_VOICES (see #define on line 21)
- *             should match the synth hardware configuration, typically 6, 8, 10 or 12 voices.
- *             (The symbol value may be lower than the actual number of voices.)
+ * Notes:   1. The voice modules present are discovered at run-time (see VoiceReplyService)
+ *             on MIDI channels 1..MAX_VOICES, typically 6, 8, 10 or 12 voices.  Voices which
+ *             stop replying to the status poll are removed from the voice allocation pool
+ *             and are added again when they reply.  NUMBER_OF_VOICES is the number of voices
+ *             assumed present if none reply (voice firmware prior to v1.6).
  *             
  *          2. The table of Preset patch definitions - g_PresetPatch[] - must be an exact
  *             copy of the respective table defined in the Poly-voice firmware code.
+ *
+ *          3. Voice modules reply to SysEx queries on their UART TX line. The voice TX lines
+ *             are wired-OR (diode per voice, pull-up at master) to the master voice reply
+ *             input (VOICE_REPLY_RX), serviced by a second UART (Serial2) on SERCOM2.
+ *             The master queries one voice at a time, so replies do not collide.
+ *
+ *          4. If VOICE_BUS_FAST is TRUE, messages to the voices are sent on the Serial2 TX
+ *             pin (VOICE_BUS_TX) at VOICE_BUS_BAUD, instead of the MIDI OUT pin (Serial1),
+ *             and voice replies are received at the same baud rate.  MIDI IN (Serial1)
+ *             remains at 31250 baud for external gear.  The voices must be built with the
+ *             same option (see m0_synth_def.h).  A 3-byte message takes 60us at 500k baud,
+ *             vs. 1ms at 31250, so a chord reaches all voices within a fraction of 1ms.
+ *
+ *          5. If USB_MIDI_INPUT is TRUE, the USB port is a composite device (CLI serial port
+ *             plus USB-MIDI class device), which requires the "MIDIUSB" library (install
+ *             via the Arduino Library Manager).  Channel messages received from USB-MIDI
+ *             are merged with MIDI IN (Serial1) into one message queue.  USB-MIDI packets
+ *             are read (and time-stamped) only when polled by the main loop, so a USB
+ *             message may be queued after a Serial1 message which arrived later.
+ *
+ *          6. If NOTE_LATENCY_TRACE is TRUE, the time from arrival of each Note-On (MIDI IN)
+ *             to its transmission to a voice is accumulated in a histogram.  Notes sent in
+ *             monophonic test mode are not traced.  The CLI command
+ *             'latency' lists it, with the histograms of the voice stages (receipt, envelope
+ *             trigger, first audible sample) queried from each voice module built with the
+ *             same option (see m0_synth_def.h).  The master and voices are not synchronized,
+ *             so each module measures its own stages;  the voice bus transfer time is fixed.
  */
 #include <Wire.h>
 #include <SPI.h>
+#include "wiring_private.h"  // for pinPeripheral()
 
-#define FIRMWARE_VERSION  "1.00"
+#define FIRMWARE_VERSION  "1.10"
 
-#define NUMBER_OF_VOICES   6  // Set according to hardware configuration
+#define USB_MIDI_INPUT  FALSE  // TRUE: USB-MIDI device input merged with MIDI IN (see note)
+#define POT_ADC_BACKGROUND  TRUE  // TRUE: Pots scanned by ADC interrupt (see PotScanInit)
+#define NOTE_LATENCY_TRACE  FALSE  // TRUE: Note-On latency histograms (see note)
+
+#define MAX_VOICES        15  // Max. voice modules, MIDI channels 1..15 (16 = broadcast)
+#define NUMBER_OF_VOICES   6  // Voices assumed present if none reply to status poll
+#define VOICE_SAMPLE_RATE_KHZ  32  // Voice audio sample rate: 32, 40 or 48 kHz
+#define VOICE_BUS_FAST      FALSE  // TRUE: Voice bus on Serial2 TX at VOICE_BUS_BAUD (see note)
+#define VOICE_BUS_BAUD     500000  // Fast voice bus baud rate (voice firmware v1.6+)
 
 #define MIDI_MSG_MAX_LENGTH  32
+#define MIDI_RX_QUEUE_SIZE   16    // MIDI IN message queue entries (power of 2)
 #define SYS_EXCLUSIVE_MSG  0xF0
 #define SYSTEM_MSG_EOX     0xF7
+#define SYS_EXCL_REMI_ID   0x73    // Bauer SysEx "manufacturer ID"
+#define SYSEX_ISR_STATS_QUERY  0x01  // SysEx msg type: Audio ISR stats query
+#define SYSEX_ISR_STATS_REPLY  0x41  // SysEx msg type: Audio ISR stats reply
+#define SYSEX_PATCH_DATA       0x02  // SysEx msg type: Patch data (PatchParamTable_t)
+#define VOICE_PATCH_BY_SYSEX   TRUE  // Favorite recall sends patch in SysEx msg (voice v1.6+)
+#define SYSEX_STATUS_POLL      0x03  // SysEx msg type: Voice status poll (broadcast)
+#define SYSEX_STATUS_REPLY     0x43  // SysEx msg type: Voice status reply
+#define SYSEX_LATENCY_QUERY    0x04  // SysEx msg type: Note latency histogram query
+#define SYSEX_LATENCY_REPLY    0x44  // SysEx msg type: Note latency histogram reply
+#define LATENCY_STAGES            3  // Voice latency stages (histograms), see 'latency'
+#define LATENCY_HIST_BINS         8  // Histogram bins:  < 32, 64, 128 .. 2048, >= 2048 us
+#define LATENCY_BIN0_US          32  // Upper limit of first bin (us);  doubled per bin
+#define TRACE_STAMP_QUEUE_SIZE   64  // Note-On arrival stamps queued for MIDI OUT (power of 2)
+#define VOICE_STATUS_SLOT_MS      5  // Status reply time slot per voice channel (ms)
+#define VOICE_STATUS_WINDOW_MS(n)  ((n) * VOICE_STATUS_SLOT_MS + 2)  // n = highest chan
+#define VOICE_STATUS_POLL_GAP_MS  10  // Time from end of reply window to next poll (ms)
+#define VOICE_DISCOVERY_MS     1000  // Period of status poll with window for all channels
+#define VOICE_DROPOUT_MS       2000  // Voice removed from pool if no reply for this time
+#define VOICE_ENV_IDLE            0  // Voice ENV1 phase:  Idle (zero output)
+#define VOICE_REPLY_TIMEOUT_MS   20  // Time allowed for a voice to reply (ms)
+#define CTRL_SEND_PERIOD_MS   2    // Min. time between msgs per continuous controller (ms)
+#define EEPROM_PAGE_SIZE     32    // 24LC64 page write buffer size (bytes)
+#define EEPROM_IMAGE_SIZE  0x500   // EEPROM data cached in RAM:  config + 8 User Presets
+#define EEPROM_IMAGE_PAGES  (EEPROM_IMAGE_SIZE / EEPROM_PAGE_SIZE)  // max. 64
+#define EEPROM_STORE_DELAY_MS  500   // Time from last store to start of write-behind (ms)
+#define EEPROM_WRITE_TIMEOUT_MS  10  // Max. time for page write cycle (24LC64: 5ms)
+#define EEPROM_WRITE_RETRIES   3     // Page write attempts before the page is dropped
+#define USER_PRESET_ADDR(fav)  (0x100 + (fav) * 128)  // fav = 0..7;  sizeof(g_Patch) <= 128
+#define CTRL_CACHE_SLOTS      9    // Pitch Bend + 8 CC numbers (see c_CoalescedCC[])
+
+// MIDI OUT transmit queues, one per priority level -- see MidiTransmit()
+#define TX_PRIORITY_GATE      0    // Note-On, Note-Off
+#define TX_PRIORITY_PITCH     1    // Pitch Bend
+#define TX_PRIORITY_CTRL      2    // Control Change, Program Change
+#define TX_PRIORITY_BULK      3    // Patch recall, voice initialization, SysEx
+#define TX_PRIORITY_LEVELS    4
+#define MIDI_TX_QUEUE_SIZE  256    // bytes per priority level (power of 2)
+#define MIDI_TX_BACKLOG_MAX   8    // Max. bytes pending in UART TX buffer (2.5ms at 31250)
+#define MIDI_TX_SYSEX_MAX_DATA  200  // Max. data bytes in SysEx message sent
+
+// Main loop task priorities -- see TaskScheduler()
+#define TASK_PRIORITY_MIDI    0    // MIDI routing:  run again after any long task
+#define TASK_PRIORITY_HIGH    1    // Pots, voice replies, EEPROM, display flush
+#define TASK_PRIORITY_LOW     2    // User interface, CLI
+#define TASK_PREEMPT_US     200    // Task run time (us) after which MIDI tasks run again
+
+#ifdef SERIAL_BUFFER_SIZE  // Arduino core Uart buffer size -- TX bytes not yet sent:
+#define MIDI_TX_BACKLOG()  (SERIAL_BUFFER_SIZE - 1 - VOICE_BUS.availableForWrite())
+#else
+#define MIDI_TX_BACKLOG()  0
+#endif
 #define OMNI_ON     1       // MIDI IN mode: Omni-On Poly
 #define OMNI_OFF    3       // MIDI IN mode: Omni-Off Poly
 #define BROADCAST   16      // MIDI OUT channel for broadcast
 #define GATE_OFF    0xFF    // Voice/Channel status
+#define VOICE_NONE  0xFF    // End of voice list;  note not assigned to a voice
 #define INVALID     0xFFFF  // Patch param value not assigned
 #define HOME_SCREEN_ID  2   // Defined in "poly_synth_panel.ino"
 
@@ -45,6 +136,8 @@
 
 // MCU I/O pin assignments.................
 #define EXTDIO_SS       8    // SPI slave-select: Ext. I/O port
+#define VOICE_REPLY_RX  3    // PA09 = SERCOM2 PAD1: Voice reply input (see note)
+#define VOICE_BUS_TX    4    // PA08 = SERCOM2 PAD0: Fast voice bus output (see note)
 #define TX_LED          27   // PA27 = on-board TX_LED (for 'heartbeat')
 
 #define GPIOA_PIN_MODE_OUT(bit)  (PORT_IOBUS->Group[0].DIRSET.reg = (1 << bit))
@@ -61,6 +154,21 @@
 
 #define DO_NOTHING()   {;}
 
+#if VOICE_BUS_FAST
+#define VOICE_BUS       Serial2    // UART for messages to voices and voice replies
+#define VOICE_BUS_RATE  VOICE_BUS_BAUD
+#else
+#define VOICE_BUS       Serial1    // MIDI OUT is the voice bus;  Serial2 is RX only
+#define VOICE_BUS_RATE  31250
+#endif
+
+#if USB_MIDI_INPUT
+#include <MIDIUSB.h>    // USB-MIDI class device (composite with CLI serial port)
+#endif
+
+// Number of SysEx data bytes to carry n bytes of 8-bit data (7 bytes => 8)
+#define SYSEX_PACKED_SIZE(n)  ((n) + ((n) + 6) / 7)
+
 
 typedef struct table_of_configuration_params
 {
@@ -80,6 +188,46 @@ typedef struct table_of_configuration_params
 
 ConfigParams_t  g_Config;  // structure holding configuration param's
 
+// MIDI IN message queue entry -- see MidiReceive() and MidiInputService()
+typedef  struct  midi_rx_message
+{
+  uint32_t  Time_us;              // Arrival time-stamp, TimeStamp_us()
+  uint8_t   Length;               // Message length (bytes)
+  uint8_t   Data[MIDI_MSG_MAX_LENGTH];  // Message bytes, status byte first
+
+} MidiRxMessage_t;
+
+MidiRxMessage_t  m_MidiRxQueue[MIDI_RX_QUEUE_SIZE];  // MIDI IN message queue
+volatile uint8_t  v_MidiRxHead;  // queue write index (MidiReceive)
+volatile uint8_t  v_MidiRxTail;  // queue read index (MidiInputService)
+volatile bool     v_MidiRxBusy;  // MidiReceive() running in background task
+
+// MIDI OUT queue entry:  <length> <message bytes...>  (status byte always queued)
+typedef  struct  midi_tx_queue
+{
+  uint8_t   Buffer[MIDI_TX_QUEUE_SIZE];
+  volatile uint16_t  Head;         // write index (MidiTxEnqueue)
+  volatile uint16_t  Tail;         // read index (MidiTransmit)
+
+} MidiTxQueue_t;
+
+MidiTxQueue_t  m_MidiTxQueue[TX_PRIORITY_LEVELS];
+uint8_t   m_MidiTxCtrlPriority = TX_PRIORITY_CTRL;  // priority for CC and Prog Change
+uint8_t   m_MidiTxCurQueue;      // queue of message being transmitted
+uint8_t   m_MidiTxRemain;        // bytes of message remaining to be transmitted
+uint8_t   m_MidiTxRunStatus;     // running status (last status byte sent, 0 = none)
+volatile bool     v_MidiTxBusy;  // MidiTransmit() running in background task
+volatile bool     v_SysTickHookActive;  // sysTickHook() running (see TimeStamp_us)
+uint32_t  m_MidiRxMsgTime;       // arrival time-stamp of MIDI IN msg being processed, or 0
+
+// Note latency trace:  arrival time of each Note-On in the gate queue, in queue order
+// (0 => Note-On not traced, i.e. not dispatched from a MIDI IN message)
+uint32_t  m_TraceStamp[TRACE_STAMP_QUEUE_SIZE];
+volatile uint8_t  m_TraceStampHead;  // write index (MIDI_SendNoteOn)
+volatile uint8_t  m_TraceStampTail;  // read index (MidiTransmit, on Note-On sent)
+bool      m_MidiTxNoteOn;        // message being transmitted is a traced Note-On
+bool      m_MidiTxStatusPoll;    // message being transmitted is a voice status poll
+
 // Data structure for active patch (g_Patch); also 'User Presets' in EEPROM:
 typedef  struct  synth_patch_param_table
 {
@@ -125,12 +273,96 @@ bool     g_DisplayEnabled;      // True if OLED display initialized OK
 bool     g_MidiRxSignal;        // Signal MIDI message received (for GUI icon)
 bool     g_EEpromFaulty;        // True if EEPROM error or not fitted
 bool     g_MonophonicTestMode;  // True in monophonic test mode (e.g. voice tuning)
-uint8_t  g_LastChannel;         // Last channel/voice allocated a note
 uint8_t  g_VoiceUnderTest;      // Voice-channel # in monophonic test mode
-uint8_t  g_NotePending;         // Note number of deferred Note-On (0 = none)
-uint8_t  g_ChannelPending;      // Voice-channel to use for Note Pending
-uint8_t  g_VelocityPending;     // Key velocity of deferred Note-On
-uint32_t g_NoteOnDelayBegin;    // Captured time (ms)
+uint8_t  g_VoiceQuery;          // Voice-channel being queried by CLI (0 = none)
+uint8_t  g_VoiceQueryType = SYSEX_ISR_STATS_QUERY;  // SysEx msg type of voice query
+uint8_t  g_VoiceQueryFlags;     // Data byte sent with voice query (bit0 = reset)
+bool     g_VoiceReplyRcvd;      // True if reply rec'd from voice being queried
+uint32_t g_MidiRxMsgCount;      // MIDI IN messages received (see 'midi' command)
+uint32_t g_MidiUsbMsgCount;     // MIDI IN messages received from USB-MIDI
+uint32_t g_MidiRxOverruns;      // MIDI IN messages lost (queue or UART buffer full)
+uint32_t g_MidiRxLatencyMax;    // MIDI IN max. time from arrival to processing (us)
+uint32_t g_CtrlCoalesced;       // Controller msgs superseded before sent (see 'midi')
+uint32_t g_MidiTxBytes;         // MIDI OUT bytes transmitted
+uint32_t g_MidiTxStatusSaved;   // MIDI OUT status bytes omitted (running status)
+uint32_t g_VoiceSteals;         // Notes which took a voice from a note still gated
+uint32_t g_EEpromPageWrites;    // EEPROM pages written (write-behind, see 'midi')
+uint32_t g_EEpromErrors;        // EEPROM page writes failed (IIC error or time-out)
+uint32_t g_VoiceDropOuts;       // Voices removed from the pool (no status reply)
+uint8_t  g_NumberOfVoices;      // Number of voice modules present (in allocation pool)
+bool     g_VoicesInitialized;   // True when voices have been sent config param's
+
+// Voice allocation lists, linked by voice index (0..N-1);  each voice is in one list:
+// Free list -- voices not gated, in order of note release (head = released longest ago);
+// Busy list -- voices gated, in order of note-on (head = oldest note, first to be stolen).
+typedef  struct  voice_list
+{
+  uint8_t  Head;
+  uint8_t  Tail;
+
+} VoiceList_t;
+
+// Voice status reported in reply to status poll (see VoiceReplyService)
+typedef  struct  voice_status
+{
+  uint32_t  TimeRcvd;             // time (ms) status reply received (0 = never)
+  uint8_t   Env1Phase;            // ENV1 segment:  0 = Idle, 1 = Attack, ... 5 = Release
+  uint8_t   Env1Level;            // ENV1 output level (0..127)
+  uint8_t   OutputLevel;          // Audio output level (0..127)
+  uint8_t   LoadPc;               // Audio ISR CPU load (%)
+  uint8_t   NotePlaying;          // MIDI note number of last note on
+
+} VoiceStatus_t;
+
+// Note latency histogram -- time unit is microseconds (see NOTE_LATENCY_TRACE)
+typedef  struct  note_latency_histogram
+{
+  uint32_t  Count;                // Number of notes measured
+  uint32_t  Total_us;             // Sum of latencies (for average)
+  uint32_t  Max_us;               // Max. latency
+  uint16_t  Bin[LATENCY_HIST_BINS];  // Notes per bin (saturated at 0xFFFF)
+
+} LatencyHist_t;
+
+LatencyHist_t  m_LatencyHist;    // Note-On arrival to transmit latency (master)
+VoiceStatus_t  m_VoiceStatus[MAX_VOICES];
+uint32_t  m_VoiceEventTime[MAX_VOICES];  // time (ms) of last note-on/off sent
+volatile uint32_t  v_StatusPollTime;  // time (ms) last status poll sent (see StatusPollSent)
+volatile bool  v_StatusPollPending;   // status poll queued, not yet sent
+uint32_t  m_DiscoveryPollTime;     // time (ms) last poll sent with full reply window
+uint8_t   m_StatusWindow;          // reply window (ms) of last status poll sent
+bool      m_VoicePresent[MAX_VOICES];  // voice is in the allocation pool
+bool      m_VoicesAssumed;         // voices assumed present (none replied to poll)
+
+VoiceList_t  m_FreeVoices;
+VoiceList_t  m_BusyVoices;
+uint8_t  m_VoiceNext[MAX_VOICES];  // next voice in list (VOICE_NONE = last)
+uint8_t  m_VoicePrev[MAX_VOICES];  // previous voice in list (VOICE_NONE = first)
+uint8_t  m_NoteVoice[128];               // voice playing note (VOICE_NONE if none)
+
+// Continuous controllers forwarded to the voices via the "latest value wins" cache:
+// Slot 0 is Pitch Bend;  slots 1..8 are the CC numbers listed, MSB before LSB, so that
+// the voices receive the LSB after the MSB when both are pending.
+const uint8_t  c_CoalescedCC[CTRL_CACHE_SLOTS] = { 0, 1, 33, 2, 34, 7, 39, 11, 43 };
+
+uint16_t  m_CtrlCacheValue[CTRL_CACHE_SLOTS];  // latest value rec'd (PB: 14 bits)
+uint32_t  m_CtrlCacheSent[CTRL_CACHE_SLOTS];   // time (ms) slot value last sent
+uint16_t  m_CtrlCacheDirty;      // bit N set => slot N value not yet sent
+
+// RAM image of EEPROM data (config at 0x000, User Presets at 0x100 + 128 x favNum);
+// pages changed in the image are written back to the EEPROM by EEpromService().
+uint8_t   m_EEpromImage[EEPROM_IMAGE_SIZE];
+uint64_t  m_EEpromDirty;         // bit N set => image page N not yet written to EEPROM
+uint32_t  m_EEpromStoreTime;     // time (ms) of last change to the image
+uint32_t  m_EEpromWriteTime;     // time (ms) page write started
+uint8_t   m_EEpromWritePage;     // page being written (write cycle), 0xFF if none
+uint8_t   m_EEpromRetries;       // failed write attempts on current page
+
+Uart  Serial2(&sercom2, VOICE_REPLY_RX, VOICE_BUS_TX, SERCOM_RX_PAD_1, UART_TX_PAD_0);
+
+extern "C" int  sysTickHook(void);  // Arduino core SysTick hook (MIDI IN/OUT)
+
+void  SERCOM2_Handler()  { Serial2.IrqHandler(); }  // Voice reply UART ISR
 
 //---------------------------------------------------------------------------------------
 
@@ -140,15 +372,25 @@ void  setup()
 
   Serial.begin(57600);         // initialize USB port for serial CLI
   Serial1.begin(31250);        // initialize UART for MIDI IN/OUT
+  Serial2.begin(VOICE_BUS_RATE);  // initialize UART for voice replies (and fast bus)
+  pinPeripheral(VOICE_REPLY_RX, PIO_SERCOM_ALT);
+#if VOICE_BUS_FAST
+  pinPeripheral(VOICE_BUS_TX, PIO_SERCOM_ALT);
+#endif
   Wire.begin();                // initialize IIC as master
   Wire.setClock(400*1000);     // set IIC clock to 400kHz
   SPI.begin();                 // initialize SPI port
   analogReadResolution(10);    // set ADC resolution to 10 bits
+#if POT_ADC_BACKGROUND
+  PotScanInit();               // start background ADC scan of pots
+#endif
   GPIOA_PIN_MODE_OUT(TX_LED);  // Heartbeat LED (PA27)
   ButtonLEDstate(88, ON);      // Turn ON all FAV Preset LED indicators
   
   if (EEpromACKresponse() == FALSE)
     { g_EEpromFaulty = TRUE; }  // IIC bus error or EEprom not fitted
+  else  EEpromImageLoad();     // read EEPROM data into RAM image
+  m_EEpromWritePage = 0xFF;    // no page write cycle in progress
 
   if (FetchConfigData() == 0 || g_Config.EEpromCheckWord != 0xABCDE090)  // Data corrupted
   {
@@ -177,85 +419,251 @@ void  setup()
   if (g_Config.MidiChannel == 0)  g_MidiMode = OMNI_ON;
   else  g_MidiMode = OMNI_OFF;
   
-  for (n = 0; n < NUMBER_OF_VOICES; n++)  g_channelStatus[n] = GATE_OFF;
+  VoiceAllocInit();
 
   g_NumberOfPresets = GetNumberOfPresets();
   PresetSelect(g_Config.PresetLastSelected);
   ButtonLEDstate(88, OFF);  // Turn off all FAV Preset LED indicators
+  TaskStatsReset();         // main loop tasks due at once
 }
 
 
+// Main loop task table -- in order of priority (highest first), which is the order the
+// tasks are run in each pass of the main loop.  See TaskScheduler().
+//
+// A task with period 0 runs on every pass;  it is "due" as soon as its previous run has
+// ended, so the deadline is the max. time allowed between runs.  A periodic task is due
+// every (period) ms;  the deadline is the max. time from due to the end of the run.
+// Run time statistics are listed by the CLI command 'tasks'.
+//
+typedef  struct  main_loop_task
+{
+  void      (*Function)(void);   // task function
+  const char  *Name;             // task name (CLI 'tasks' command)
+  uint8_t   Priority;            // TASK_PRIORITY_xxx
+  uint16_t  Period_ms;           // run interval (ms), 0 => every pass of main loop
+  uint32_t  Deadline_us;         // max. time (us) from due to end of run
+  uint32_t  DueTime;             // time (us) next run is due
+  uint32_t  RunCount;            // number of runs
+  uint64_t  TotalTime;           // sum of run times (us), for average
+  uint32_t  MaxTime;             // max. run time (us)
+  uint32_t  MaxLatency;          // max. time (us) from due to start of run
+  uint32_t  Misses;              // number of runs ended after the deadline
+
+} MainLoopTask_t;
+
+MainLoopTask_t  m_Task[] =
+{
+  // MIDI IN first, then the controller cache, so notes go out ahead of controller data
+  { MidiInputService,        "MIDI IN",      TASK_PRIORITY_MIDI,   0,   1000 },
+  { ControllerCacheService,  "Ctrl cache",   TASK_PRIORITY_MIDI,   0,   2000 },
+  { MidiOutputService,       "MIDI OUT",     TASK_PRIORITY_MIDI,   0,   2000 },
+  { PotService,              "Pots",         TASK_PRIORITY_HIGH,   1,   2000 },
+  { VoiceReplyService,       "Voice reply",  TASK_PRIORITY_HIGH,   0,   4000 },
+  { EEpromService,           "EEPROM",       TASK_PRIORITY_HIGH,   0,  20000 },
+  { DisplayFlushTask,        "Disp flush",   TASK_PRIORITY_HIGH,   0,  20000 },
+  { ButtonScan,              "Buttons",      TASK_PRIORITY_LOW,   50,  10000 },
+  { PanelDisplayTask,        "UI screen",    TASK_PRIORITY_LOW,   50,  50000 },
+  { ServicePortRoutine,      "CLI",          TASK_PRIORITY_LOW,    0, 100000 },
+  { HeartbeatLedTask,        "Heartbeat",    TASK_PRIORITY_LOW,   50,  50000 },
+};
+
+#define TASK_COUNT  (sizeof(m_Task) / sizeof(MainLoopTask_t))
+
+
 // Main background process loop...
 //
 void  loop()
 {
-  static uint32_t startPeriod_5ms, startPeriod_50ms, count_to_10;
-  static uint32_t lastMillisec;
+  TaskScheduler();
+}
 
-  MidiInputService();
-  ServicePortRoutine();
 
-  if (millis() != lastMillisec)  // 1ms interval ended
-  {
-    lastMillisec = millis();
-    PotService();
-  }
+/*
+ * Function:     TaskScheduler()
+ *
+ * Overview:     Co-operative scheduler for the main loop tasks in m_Task[].  Each task
+ *               which is due is run, in order of priority.  A task is not interrupted;
+ *               but after any lower priority task which ran for TASK_PREEMPT_US or more
+ *               (e.g. a UI screen update), the MIDI tasks are run again, before the next
+ *               task, so MIDI messages received in the meantime are routed without
+ *               waiting for the rest of the pass.
+ *
+ * Called by:    loop(), once per pass.
+ */
+void  TaskScheduler()
+{
+  uint8_t  task, midiTask;
 
-  if ((millis() - startPeriod_5ms) >= 5)  // 5ms period ended
+  for (task = 0;  task < TASK_COUNT;  task++)
   {
-    startPeriod_5ms = millis();
-    // No task to execute here yet, but keep this place-holder
+    if (TaskRun(task) >= TASK_PREEMPT_US && m_Task[task].Priority != TASK_PRIORITY_MIDI)
+    {
+      for (midiTask = 0;  m_Task[midiTask].Priority == TASK_PRIORITY_MIDI;  midiTask++)
+      {
+        TaskRun(midiTask);
+      }
+    }
   }
+}
+
+
+/*
+ * Function:     TaskRun()
+ *
+ * Overview:     Runs a task in m_Task[] if it is due, and updates its run time stats:
+ *               run count, total and max. run time, max. latency (start of run after due
+ *               time) and missed deadlines.  A periodic task which has fallen behind by
+ *               more than one period is re-synchronized (runs skipped).
+ *
+ * Entry arg:    task = index of task in m_Task[]
+ *
+ * Return val:   Run time (us), or 0 if the task was not due.
+ */
+uint32_t  TaskRun(uint8_t task)
+{
+  MainLoopTask_t  *pTask = &m_Task[task];
+  uint32_t  period_us = (uint32_t) pTask->Period_ms * 1000;
+  uint32_t  startTime = micros();
+  uint32_t  runTime, latency;
+
+  if ((int32_t)(startTime - pTask->DueTime) < 0)  return 0;  // not due yet
+
+  pTask->Function();
+
+  runTime = micros() - startTime;
+  latency = startTime - pTask->DueTime;
+  pTask->RunCount++;
+  pTask->TotalTime += runTime;
+  if (runTime > pTask->MaxTime)  pTask->MaxTime = runTime;
+  if (latency > pTask->MaxLatency)  pTask->MaxLatency = latency;
+  if ((latency + runTime) > pTask->Deadline_us)  pTask->Misses++;
+
+  if (period_us == 0)  pTask->DueTime = startTime + runTime;  // due again now
+  else if (latency >= period_us)  pTask->DueTime = startTime + period_us;  // re-sync
+  else  pTask->DueTime += period_us;
+
+  return  (runTime != 0) ? runTime : 1;
+}
+
+
+// Clear main loop task run time stats;  all tasks are due at once.
+//
+void  TaskStatsReset()
+{
+  uint8_t  task;
 
-  if ((millis() - startPeriod_50ms) >= 50)  // 50ms period ended
+  for (task = 0;  task < TASK_COUNT;  task++)
   {
-    startPeriod_50ms = millis();
-    ButtonScan();
-    if (g_DisplayEnabled) UserInterfaceTask();
-    ////
-    if (count_to_10 == 0)  GPIOA_PIN_SET_LOW(TX_LED);   // Heartbeat LED on
-    if (count_to_10 == 2)  GPIOA_PIN_SET_HIGH(TX_LED);  // Heartbeat LED off
-    if (++count_to_10 == 10) count_to_10 = 0;  // Reset heartbeat LED period
+    m_Task[task].DueTime = micros();
+    m_Task[task].RunCount = 0;
+    m_Task[task].TotalTime = 0;
+    m_Task[task].MaxTime = 0;
+    m_Task[task].MaxLatency = 0;
+    m_Task[task].Misses = 0;
   }
 }
 
 
+// Main loop task:  Write display changes to the OLED, a chunk at a time
+//
+void  DisplayFlushTask()
+{
+  if (g_DisplayEnabled)  Disp_FlushService();
+}
+
+
+// Main loop task:  Front panel user interface screen update (every 50ms)
+//
+void  PanelDisplayTask()
+{
+  if (g_DisplayEnabled)  UserInterfaceTask();
+}
+
+
+// Main loop task:  Heartbeat LED flash -- on for 100ms every 500ms
+//
+void  HeartbeatLedTask()
+{
+  static uint8_t  count_to_10;
+
+  if (count_to_10 == 0)  GPIOA_PIN_SET_LOW(TX_LED);   // Heartbeat LED on
+  if (count_to_10 == 2)  GPIOA_PIN_SET_HIGH(TX_LED);  // Heartbeat LED off
+  if (++count_to_10 == 10) count_to_10 = 0;  // Reset heartbeat LED period
+}
+
+
 // Wait 5 seconds (min.) after power-on/reset before calling this function
 // to allow voice modules time to start up.  Called from UI screen 'Startup'
 //
+// Voices which replied to the status poll in the meantime are in the allocation pool;
+// if none replied, NUMBER_OF_VOICES are assumed present (voice firmware prior to v1.6).
+//
 void  InitializeVoiceModules()
 {
-  MIDI_SendControlChange(BROADCAST, 86, 2);   // Ampld Control: always ENV1*VELO
-  MIDI_SendControlChange(BROADCAST, 89, g_Config.ReverbMix_pc);
-  MIDI_SendControlChange(BROADCAST, 88, g_Config.PitchBendEnable);
+  uint8_t  voice;
+
+  if (g_NumberOfVoices == 0)
+  {
+    for (voice = 0;  voice < NUMBER_OF_VOICES;  voice++)  { VoiceJoin(voice); }
+    m_VoicesAssumed = TRUE;
+  }
+  VoiceConfigure(BROADCAST);
+  g_VoicesInitialized = TRUE;
+}
+
+
+// Send configuration param's and the active preset to a voice channel (1..15), e.g. a
+// voice which has joined the pool, or to all voices (chan = BROADCAST).
+//
+void  VoiceConfigure(uint8_t chan)
+{
+  MidiTxBulkBegin();
+  // Sample rate first -- a change re-initializes the voice synth engine.
+  // A voice will refuse 40 or 48 kHz if its audio ISR load measured at boot is too high;
+  // use the 'cpu' command to check the sample rate in effect in each voice.
+  MIDI_SendControlChange(chan, 90, VOICE_SAMPLE_RATE_KHZ);
+  MIDI_SendControlChange(chan, 86, 2);   // Ampld Control: always ENV1*VELO
+  MIDI_SendControlChange(chan, 89, g_Config.ReverbMix_pc);
+  MIDI_SendControlChange(chan, 88, g_Config.PitchBendEnable);
   // If pitch bend enabled, send MIDI msg to disable vibrato, and vice-versa...
-  if (g_Config.PitchBendEnable) MIDI_SendControlChange(BROADCAST, 87, 0);   // Vibrato disabled
-  else  MIDI_SendControlChange(BROADCAST, 87, 3);   // Vibrato auto-ramp
-  // The following 2 messages must be sent in sequence...
-  MIDI_SendControlChange(BROADCAST, 100, 0);  // Reg. Param 0 = Pitch-Bend range
-  MIDI_SendControlChange(BROADCAST, 38, g_Config.PitchBendRange);  // Data Entry
+  if (g_Config.PitchBendEnable) MIDI_SendControlChange(chan, 87, 0);   // Vibrato disabled
+  else  MIDI_SendControlChange(chan, 87, 3);   // Vibrato auto-ramp
+  MIDI_SendRegisteredParam(chan, 0, g_Config.PitchBendRange);  // Reg. Param 0 = PB range
   // Send fine tuning param's to voice modules
-  ExecuteVoiceTuning();
-  MIDI_SendProgramChange(BROADCAST, g_Config.PresetLastSelected);
+  if (chan == BROADCAST)  ExecuteVoiceTuning();
+  else  SendVoiceTuning(chan - 1);
+  MIDI_SendProgramChange(chan, g_Config.PresetLastSelected);
+#if VOICE_PATCH_BY_SYSEX
+  if (g_FavoriteSelected || g_PatchModified)  MIDI_SendPatchData(chan, &g_Patch);
+#endif
+  MidiTxBulkEnd();
 }
 
 
 void  ExecuteVoiceTuning()
 {
-  short  voice, tuningValue;
+  uint8_t  voice;
 
-  for (voice = 0;  voice < NUMBER_OF_VOICES;  voice++)
+  for (voice = 0;  voice < MAX_VOICES;  voice++)
   {
-    tuningValue = (short) g_Config.VoiceTuning[voice] - 64;  // signed (0 +/- 60 cents)
-    tuningValue += (short) g_Config.MasterTuneOffset - 64;
-    if (tuningValue < -60)  tuningValue = 0 - 60;  // min.
-    if (tuningValue > 60)  tuningValue = 60;  // max.
-    MIDI_SendControlChange(voice+1, 100, 1);  // Reg. Param 1 = Fine Tuning
-    MIDI_SendControlChange(voice+1, 38, (uint8_t)(tuningValue + 64));
+    if (m_VoicePresent[voice])  SendVoiceTuning(voice);
   }
 }
 
 
+void  SendVoiceTuning(uint8_t voice)
+{
+  short  tuningValue;
+
+  tuningValue = (short) g_Config.VoiceTuning[voice] - 64;  // signed (0 +/- 60 cents)
+  tuningValue += (short) g_Config.MasterTuneOffset - 64;
+  if (tuningValue < -60)  tuningValue = 0 - 60;  // min.
+  if (tuningValue > 60)  tuningValue = 60;  // max.
+  MIDI_SendRegisteredParam(voice+1, 1, (uint8_t)(tuningValue + 64));  // 1 = Fine Tuning
+}
+
+
 /**
  * Function:   Send MIDI Program Change message to all voice-channels;
  *             Save preset/program number as PresetLastSelected in EEPROM.
@@ -288,12 +696,25 @@ void  PresetSelect(uint8_t preset)
  * The configuration parameter g_Config.PresetLastSelected is *never* replaced by a User
  * Preset base, so that at power-on/restart, the last selected Voice Preset is reloaded
  * regardless of whether a Favorite may have been selected at the time of power-off.
+ *
+ * If VOICE_PATCH_BY_SYSEX is TRUE, the complete patch is sent to the voices in one SysEx
+ * message;  otherwise the base preset is selected (Program Change) and the param's which
+ * may have been modified are sent in CC messages (quantized to the CC data units).
  */
 void  RecallUserPreset(uint8_t favNum)  // favNum = 0..7
 {
+#if !VOICE_PATCH_BY_SYSEX
   uint8_t  basePreset = g_Config.UserPresetBase[favNum];
   uint8_t  oscNum, dataValue;
+#endif
 
+  MidiTxBulkBegin();
+#if VOICE_PATCH_BY_SYSEX
+  FetchUserPreset(favNum);  // Load active patch from EEPROM
+  g_FavoriteSelected = favNum + 1;  // 1..8
+  g_PatchModified = FALSE;  // pending changes
+  MIDI_SendPatchData(BROADCAST, &g_Patch);  // Voice patch := active patch (exact)
+#else
   MIDI_SendProgramChange(BROADCAST, basePreset);  // Voice patch := User Preset base
   FetchUserPreset(favNum);  // Load active patch from EEPROM
   g_FavoriteSelected = favNum + 1;  // 1..8
@@ -316,98 +737,237 @@ void  RecallUserPreset(uint8_t favNum)  // favNum = 0..7
     dataValue = (oscNum << 4) + ((uint8_t)g_Patch.MixerInputStep[oscNum] & 0x0F);
     MIDI_SendControlChange(BROADCAST, 80, dataValue);
   }
+#endif
+  MidiTxBulkEnd();
 }
 
 
 /*````````````````````````````````````````````````````````````````````````````````````````
- * Function:  MidiInputService()
+ * Function:  sysTickHook()
  *
- * MIDI IN service routine, executed frequently from within main loop.
- * This routine monitors the serial MIDI INPUT stream and whenever a complete message
- * is received, it is processed.
+ * Called by the Arduino core SysTick interrupt handler every 1ms, before the millis()
+ * counter is updated.  MIDI IN bytes buffered by the Serial1 (UART RX interrupt) driver
+ * are parsed into the MIDI IN message queue, so that no byte is lost and each message is
+ * time-stamped within 1ms of its arrival, however long the UI holds up the main loop.
+ * (The millis() count is not yet advanced here, so micros() reads 1ms early;  time-
+ * stamps are taken by TimeStamp_us(), which corrects for this.)
+ * Also, queued MIDI OUT messages are moved into the voice bus UART TX buffer (see
+ * MidiTransmit) so the TX interrupt keeps the bus busy while the main loop is held up.
  *
- * The Master responds to valid messages addressed to the configured MIDI IN channel
- * and, if MIDI mode is set to 'Omni On' (MIDI IN channel = 0), it will respond to any
- * message received, regardless of which channel the message is addressed to.
+ * Return val:   0  => continue with the default SysTick handler
  */
-void  MidiInputService()
+int  sysTickHook(void)
+{
+  v_SysTickHookActive = TRUE;
+  if (!v_MidiRxBusy)  MidiReceive();  // not already running in background task
+  if (!v_MidiTxBusy)  MidiTransmit();
+  v_SysTickHookActive = FALSE;
+  return  0;
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  TimeStamp_us()
+ *
+ * Return the time (us) for a time-stamp, i.e. micros() corrected for sysTickHook():
+ * the hook runs after the SysTick pending flag is cleared and before the ms count is
+ * advanced, so micros() called from within the hook (or from an ISR which pre-empts it)
+ * reads 1000us early.
+ */
+uint32_t  TimeStamp_us()
+{
+  uint32_t  t_us = micros();
+
+  if (v_SysTickHookActive)  t_us += 1000;  // ms count not yet advanced
+  return  t_us;
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiReceive()
+ *
+ * Drain all bytes available in the Serial1 RX buffer through the MIDI message parser.
+ * Called by the SysTick interrupt (sysTickHook) and by MidiInputService() in the main
+ * loop, which sets v_MidiRxBusy so that the two callers cannot both run the parser.
+ *
+ * If the UART RX buffer is found full, bytes may have been lost -- this is counted as an
+ * overrun in g_MidiRxOverruns.
+ */
+void  MidiReceive()
+{
+  int  count = Serial1.available();
+
+#ifdef SERIAL_BUFFER_SIZE
+  if (count >= SERIAL_BUFFER_SIZE - 1)  g_MidiRxOverruns++;  // UART buffer full
+#endif
+  while (count-- > 0)  MidiRxParse(Serial1.read());
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiRxParse()
+ *
+ * Incremental MIDI message parser -- one byte per call.  When a message is complete, it
+ * is time-stamped and put into the MIDI IN message queue, regardless of channel.
+ * Running status is supported;  Real-Time messages are ignored.  If the queue is full,
+ * the message is discarded and counted as an overrun.
+ *
+ * Entry arg:  msgByte = byte received on MIDI IN (Serial1)
+ */
+void  MidiRxParse(uint8_t msgByte)
 {
   static  uint8_t  midiMessage[MIDI_MSG_MAX_LENGTH];
   static  short  msgBytesExpected;
   static  short  msgByteCount;
-  static  short  msgIndex;
   static  uint8_t  msgStatus;  // last command/status byte rx'd
-  static  bool   msgComplete;  // flag: got msg status & data set
-
-  uint8_t  msgByte;
-  uint8_t  msgChannel;  // 1..16 !
-  uint8_t  setChannel = g_Config.MidiChannel;
-  bool     gotSysExMsg = FALSE;
 
-  if (Serial1.available() > 0)  // unread byte(s) available in Rx buffer
+  if (msgByte & 0x80)  // command/status byte received (bit7 High)
   {
-    msgByte = Serial1.read();
-
-    if (msgByte & 0x80)  // command/status byte received (bit7 High)
+    if (msgByte == SYSTEM_MSG_EOX)
     {
-      if (msgByte == SYSTEM_MSG_EOX)
-      {
-        msgComplete = TRUE;
-        gotSysExMsg = TRUE;
-        midiMessage[msgIndex++] = SYSTEM_MSG_EOX;
-        msgByteCount++;
-      }
-      else if (msgByte <= SYS_EXCLUSIVE_MSG)  // Ignore Real-Time messages
-      {
-        msgStatus = msgByte;
-        msgComplete = FALSE;  // expecting data byte(s))
-        midiMessage[0] = msgStatus;
-        msgIndex = 1;
-        msgByteCount = 1;  // have cmd already
-        msgBytesExpected = MIDI_GetMessageLength(msgStatus);
-      }
+      if (msgStatus != SYS_EXCLUSIVE_MSG || msgByteCount == 0)  return;  // no SysEx
+      if (msgByteCount < MIDI_MSG_MAX_LENGTH)  midiMessage[msgByteCount++] = SYSTEM_MSG_EOX;
+      msgBytesExpected = msgByteCount;  // complete
     }
-    else  // data byte received (bit7 LOW)
+    else if (msgByte <= SYS_EXCLUSIVE_MSG)  // Ignore Real-Time messages
     {
-      if (msgComplete && msgStatus != SYS_EXCLUSIVE_MSG)
-      {
-        if (msgByteCount == 0)  // start of new data set -- running status
-        {
-          msgIndex = 1;
-          msgByteCount = 1;
-          msgBytesExpected = MIDI_GetMessageLength(msgStatus);
-        }
-      }
-      if (msgIndex < MIDI_MSG_MAX_LENGTH)
-      {
-        midiMessage[msgIndex++] = msgByte;
-        msgByteCount++;
-      }
+      msgStatus = msgByte;
+      midiMessage[0] = msgStatus;
+      msgByteCount = 1;  // have cmd already
+      msgBytesExpected = MIDI_GetMessageLength(msgStatus);
     }
-
-    if (msgByteCount != 0 && msgByteCount == msgBytesExpected)
+    else  return;
+  }
+  else  // data byte received (bit7 LOW)
+  {
+    if (msgByteCount == 0)  // start of new data set -- running status
     {
-      msgComplete = TRUE;
-      msgChannel = (midiMessage[0] & 0x0F) + 1;  // 1..16
-
-      if (msgChannel == setChannel || msgChannel == 16 || g_MidiMode == OMNI_ON)
-      {
-        ProcessMidiMessage(midiMessage, msgByteCount);
-        g_MidiRxSignal = TRUE;  // signal to GUI to flash MIDI Rx icon
-        msgBytesExpected = 0;
-        msgByteCount = 0;
-        msgIndex = 0;
-      }
+      if (msgStatus == 0 || msgStatus == SYS_EXCLUSIVE_MSG)  return;  // no status
+      midiMessage[0] = msgStatus;
+      msgByteCount = 1;
+      msgBytesExpected = MIDI_GetMessageLength(msgStatus);
     }
+    if (msgByteCount < MIDI_MSG_MAX_LENGTH)  midiMessage[msgByteCount++] = msgByte;
+  }
+
+  if (msgByteCount != 0 && msgByteCount == msgBytesExpected)  // message complete
+  {
+    MidiRxEnqueue(midiMessage, msgByteCount);
+    msgByteCount = 0;  // ready for next message (or running status)
+    if (msgStatus == SYS_EXCLUSIVE_MSG)  msgStatus = 0;
+  }
+}
+
+
+/*
+ * Function:     Put a complete MIDI message into the MIDI IN queue, time-stamped.
+ *               If the queue is full, the message is discarded and counted as an overrun.
+ *               Called by MidiRxParse() and MidiUsbReceive() only, so that the queue has
+ *               one writer at a time (see v_MidiRxBusy).
+ *
+ * Entry args:   pMsg = pointer to message, status byte first
+ *               length = number of bytes in message (max. MIDI_MSG_MAX_LENGTH)
+ */
+void  MidiRxEnqueue(uint8_t *pMsg, short length)
+{
+  MidiRxMessage_t  *pEntry;
+  uint8_t  head = v_MidiRxHead;
+
+  if (((head + 1) & (MIDI_RX_QUEUE_SIZE - 1)) == v_MidiRxTail)  g_MidiRxOverruns++;
+  else  // queue not full
+  {
+    pEntry = &m_MidiRxQueue[head];
+    pEntry->Time_us = TimeStamp_us();
+    pEntry->Length = length;
+    memcpy(pEntry->Data, pMsg, length);
+    v_MidiRxHead = (head + 1) & (MIDI_RX_QUEUE_SIZE - 1);
+  }
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiUsbReceive()
+ *
+ * Read all USB-MIDI event packets received and put the channel messages (Note On/Off,
+ * CC, Program Change, Pitch Bend, etc) into the MIDI IN queue, merged with messages
+ * from Serial1.  The packet Code Index Number gives the message
+ * length;  SysEx, System Common and Real-Time packets are ignored, as is the cable number.
+ * Called by MidiInputService() only (not by the SysTick hook) with v_MidiRxBusy set,
+ * because the USB-MIDI library may not be called from an interrupt handler.  Hence USB
+ * messages are time-stamped and queued when the main loop polls, not on arrival:
+ * while the main loop is held up, Serial1 messages which arrive later may be queued
+ * (and processed) ahead of them, and the latency measured excludes the hold-up.
+ */
+void  MidiUsbReceive()
+{
+#if USB_MIDI_INPUT
+  // Message length for each Code Index Number (packet header bits 3:0) -- 0 => ignored
+  static const uint8_t  msgLengthForCIN[16] = { 0, 0, 0, 0, 0, 0, 0, 0,
+                                                 3, 3, 3, 3, 2, 2, 3, 0 };
+  midiEventPacket_t  packet;
+  uint8_t  midiMessage[3];
+  short    length;
+
+  while (TRUE)
+  {
+    packet = MidiUSB.read();
+    if (packet.header == 0)  break;  // no more packets
+
+    length = msgLengthForCIN[packet.header & 0x0F];
+    if (length == 0 || (packet.byte1 & 0xF0) < NOTE_OFF_CMD)  continue;
+    midiMessage[0] = packet.byte1;
+    midiMessage[1] = packet.byte2 & 0x7F;
+    midiMessage[2] = packet.byte3 & 0x7F;
+    MidiRxEnqueue(midiMessage, length);
+    g_MidiUsbMsgCount++;
   }
+#endif
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiInputService()
+ *
+ * MIDI IN service routine, executed frequently from within main loop.
+ * Bytes received are parsed (see MidiReceive), USB-MIDI packets received are queued (see
+ * MidiUsbReceive), then every complete message in the MIDI IN queue is processed in
+ * queue order, i.e. the queue is drained in one pass.  The time from arrival
+ * to processing of each message is measured;  the max. is listed by the 'midi' command.
+ *
+ * The Master responds to valid messages addressed to the configured MIDI IN channel
+ * and, if MIDI mode is set to 'Omni On' (MIDI IN channel = 0), it will respond to any
+ * message received, regardless of which channel the message is addressed to.
+ */
+void  MidiInputService()
+{
+  MidiRxMessage_t  *pEntry;
+  uint8_t  msgChannel;  // 1..16 !
+  uint8_t  setChannel = g_Config.MidiChannel;
+  uint8_t  tail = v_MidiRxTail;
+  uint32_t latency;
 
-  // Check for deferred Note-On pending and delay-time expired:
-  if (g_NotePending && (millis() - g_NoteOnDelayBegin) >= 5)  // 5ms up
+  v_MidiRxBusy = TRUE;   // hold off sysTickHook()
+  MidiReceive();
+  MidiUsbReceive();
+  v_MidiRxBusy = FALSE;
+
+  while (tail != v_MidiRxHead)  // process all messages in queue
   {
-    MIDI_SendNoteOn(g_ChannelPending+1, g_NotePending, g_VelocityPending);
-    g_channelStatus[g_ChannelPending] = g_NotePending;
-    g_LastChannel = g_ChannelPending;
-    g_NotePending = 0;  // signal done
+    pEntry = &m_MidiRxQueue[tail];
+    msgChannel = (pEntry->Data[0] & 0x0F) + 1;  // 1..16
+
+    if (msgChannel == setChannel || msgChannel == 16 || g_MidiMode == OMNI_ON)
+    {
+      m_MidiRxMsgTime = pEntry->Time_us;  // for note latency trace
+      ProcessMidiMessage(pEntry->Data, pEntry->Length);
+      m_MidiRxMsgTime = 0;
+      g_MidiRxSignal = TRUE;  // signal to GUI to flash MIDI Rx icon
+    }
+    latency = micros() - pEntry->Time_us;
+    if (latency > g_MidiRxLatencyMax)  g_MidiRxLatencyMax = latency;
+    g_MidiRxMsgCount++;
+    tail = (tail + 1) & (MIDI_RX_QUEUE_SIZE - 1);
+    v_MidiRxTail = tail;  // free the entry
   }
 }
 
@@ -418,12 +978,10 @@ void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
   uint8_t  noteNumber = midiMessage[1];
   uint8_t  velocity = midiMessage[2];
   uint8_t  program = midiMessage[1];
-  uint16_t data14bits = ((uint16_t)midiMessage[1] << 8) + midiMessage[2];
+  uint16_t data14bits = ((uint16_t)midiMessage[2] << 7) + midiMessage[1];  // MSB, LSB
   bool     executeNoteOff = FALSE;
   bool     executeNoteOn = FALSE;
-  uint8_t  count = 0;
-  uint8_t  voice = g_LastChannel;
-  uint8_t  oldestNote;
+  uint8_t  voice;
 
   switch (statusByte)
   {
@@ -450,7 +1008,7 @@ void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
     }
     case PITCH_BEND_CMD:
     {
-      if (g_Config.PitchBendEnable) MIDI_SendPitchBend(BROADCAST, data14bits);
+      if (g_Config.PitchBendEnable) ControllerCacheUpdate(0, data14bits);
       break;
     }
     default:  break;
@@ -466,14 +1024,15 @@ void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
     }
 
     // Normal polyphonic mode...
-    for (voice = 0;  voice < NUMBER_OF_VOICES;  voice++)
-    {
-      if (g_channelStatus[voice] == noteNumber)
-      {
-        MIDI_SendNoteOff(voice+1, noteNumber);
-        g_channelStatus[voice] = GATE_OFF;
-      }
-    }
+    voice = m_NoteVoice[noteNumber & 0x7F];
+    if (voice == VOICE_NONE)  return;  // note not playing (stolen)
+
+    MIDI_SendNoteOff(voice+1, noteNumber);
+    m_VoiceEventTime[voice] = millis();
+    g_channelStatus[voice] = GATE_OFF;
+    m_NoteVoice[noteNumber & 0x7F] = VOICE_NONE;
+    VoiceListRemove(&m_BusyVoices, voice);
+    VoiceListAppend(&m_FreeVoices, voice);  // newest released
     return;
   }
 
@@ -482,158 +1041,855 @@ void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
     if (g_MonophonicTestMode)
     {
       voice = g_VoiceUnderTest;  // 0..N-1
+      m_MidiRxMsgTime = 0;  // not traced (voice allocation bypassed)
       MIDI_SendNoteOn(voice+1, noteNumber, velocity);
       return;
     }
 
     // Normal polyphonic mode...
-    voice = g_LastChannel + 1;  // oldest channel last active
-    for (count = 0; count < NUMBER_OF_VOICES; count++, voice++)
+    noteNumber &= 0x7F;
+    voice = m_NoteVoice[noteNumber];  // note already playing (re-struck)?
+    if (voice == VOICE_NONE)
     {
-      if (voice >= NUMBER_OF_VOICES) voice = 0;  // wrap
-      if (g_channelStatus[voice] == GATE_OFF)
+      if (m_FreeVoices.Head != VOICE_NONE)  voice = VoiceListQuietest(&m_FreeVoices);
+      else  // all voices are busy (gated) -- steal the quietest (or oldest) note
       {
-        MIDI_SendNoteOn(voice+1, noteNumber, velocity);
-        g_channelStatus[voice] = noteNumber;
-        g_LastChannel = voice;
-        break;  // activate one voice only
+        voice = VoiceListQuietest(&m_BusyVoices);
+        if (voice == VOICE_NONE)  return;  // no voice present
+        m_NoteVoice[g_channelStatus[voice]] = VOICE_NONE;
+        g_VoiceSteals++;
       }
     }
-    // Following code implements "N-key rollover" algorithm:
-    if (count == NUMBER_OF_VOICES)  // all channels are busy (gated)...
-    {
-      voice = (g_LastChannel + 1) % NUMBER_OF_VOICES;  // oldest used
-      oldestNote = g_channelStatus[voice];
-      MIDI_SendNoteOff(voice+1, oldestNote);  // Terminate the oldest note
-      g_channelStatus[voice] = GATE_OFF;  // voice is now free to use
-      g_ChannelPending = voice;
-      g_NotePending = noteNumber;  // Initiate deferred Note-On
-      g_VelocityPending = velocity;
-      g_NoteOnDelayBegin = millis();
-    }
-  }
-}
-
-
-// A few received CC messages are intended for the Master Controller only;
-// some others are filtered out, i.e. not passed through;
-// the rest are passed through to the voice channels in a broadcast msg.
-//
-void  ProcessControlChange(uint8_t *midiMessage)
-{
-  uint8_t CCnumber = midiMessage[1];
-  uint8_t dataByte = midiMessage[2];  // CC data value
 
-  if (CCnumber == 100)  g_MidiRegisParam = dataByte; // "Registered Param" ID
-  else if (CCnumber == 38)  // Parameter "Data Entry" message
-  {
-    if (g_MidiRegisParam == 0x00 && dataByte <= 12) 
+    if (g_channelStatus[voice] != GATE_OFF)  // voice gated (stolen or re-struck)...
     {
-      g_Config.PitchBendRange = dataByte;
-      StoreConfigData();
-      MIDI_SendControlChange(BROADCAST, 100, 0);  // Reg. Param 0 = Pitch-Bend range
-      MIDI_SendControlChange(BROADCAST, 38, g_Config.PitchBendRange);  // Data Entry
-    }
-    if (g_MidiRegisParam == 0x01)  // Master Tune param
-    {
-      g_Config.MasterTuneOffset = dataByte;
-      StoreConfigData();
-      ExecuteVoiceTuning();
+      // Terminate the note, then re-trigger at once (no deferred Note-On).  The Note-On
+      // arrives about 1ms after the Note-Off (3 bytes at 31250 baud), so the voice may
+      // begin the release for a SynthProcess tick;  the new note then attacks from the
+      // present envelope level.  (A Note-On alone would be a legato change, no attack.)
+      MIDI_SendNoteOff(voice+1, g_channelStatus[voice]);
+      VoiceListRemove(&m_BusyVoices, voice);
     }
+    else  VoiceListRemove(&m_FreeVoices, voice);
+
+    MIDI_SendNoteOn(voice+1, noteNumber, velocity);
+    m_VoiceEventTime[voice] = millis();
+    g_channelStatus[voice] = noteNumber;
+    m_NoteVoice[noteNumber] = voice;
+    VoiceListAppend(&m_BusyVoices, voice);  // newest note
   }
-  else if (CCnumber == 80) { ; }   // Set Osc. mixer level - blocked
-  else if (CCnumber == 112) { ; }  // LFO phase sync. - blocked
 }
 
 
-uint8_t  MIDI_GetMessageLength(uint8_t statusByte)
+/*
+ * Function:     Initialize voice allocation:  no voices present (see VoiceJoin), i.e.
+ *               both lists empty;  no notes assigned.
+ */
+void  VoiceAllocInit()
 {
-  uint8_t  command = statusByte & 0xF0;
-  uint8_t  length = 0;  // assume unsupported or unknown msg type
+  uint8_t  voice;
+  short    note;
 
-  if (command == PROGRAM_CHANGE_CMD || command == CHAN_PRESSURE_CMD)  length = 2;
-  if (command == NOTE_ON_CMD || command == NOTE_OFF_CMD
-  ||  command == CONTROL_CHANGE_CMD || command == PITCH_BEND_CMD)
+  m_FreeVoices.Head = m_FreeVoices.Tail = VOICE_NONE;
+  m_BusyVoices.Head = m_BusyVoices.Tail = VOICE_NONE;
+
+  for (voice = 0;  voice < MAX_VOICES;  voice++)
   {
-    length = 3;
+    g_channelStatus[voice] = GATE_OFF;
+    m_VoicePresent[voice] = FALSE;
   }
-  return  length;
+  for (note = 0;  note < 128;  note++)  { m_NoteVoice[note] = VOICE_NONE; }
+  g_NumberOfVoices = 0;
 }
 
+
 /*
- * Function:     Transmit MIDI Note-On/Velocity message.
+ * Function:     Add a voice to the allocation pool (free list), e.g. on its first reply
+ *               to the status poll.  If the voice modules have been initialized already,
+ *               the voice is sent the configuration param's and active preset, in case
+ *               it has re-started.  No effect if the voice is present already.
  *
- * Entry args:   chan = MIDI channel number (1..16)
- *               noteNum = MIDI standard note number. (Note #60 = C4 = middle-C.)
- *               velocity = output level of ampld envelope shaper (DCA)
+ * Entry arg:    voice = voice index (0..MAX_VOICES-1)
  */
-void  MIDI_SendNoteOn(uint8_t chan, uint8_t noteNum, uint8_t velocity)
+void  VoiceJoin(uint8_t voice)
 {
-  uint8_t statusByte = 0x90 | ((chan - 1) & 0xF);
+  if (voice >= MAX_VOICES || m_VoicePresent[voice])  return;
 
-  Serial1.write(statusByte);
-  Serial1.write(noteNum & 0x7F);
-  Serial1.write(velocity & 0x7F);
+  m_VoicePresent[voice] = TRUE;
+  g_channelStatus[voice] = GATE_OFF;
+  VoiceListAppend(&m_FreeVoices, voice);
+  g_NumberOfVoices++;
+  if (g_VoicesInitialized)  VoiceConfigure(voice+1);
 }
 
+
 /*
- * Function:     Transmit MIDI Note-Off message.
+ * Function:     Remove a voice from the allocation pool, e.g. when it has not replied to
+ *               the status poll for VOICE_DROPOUT_MS.  A note assigned to the voice is
+ *               terminated (note-off sent, in case the voice is still playing).
  *
- * Entry args:   chan = MIDI channel number (1..16)
- *               noteNum = MIDI note number.
+ * Entry arg:    voice = voice index (0..MAX_VOICES-1)
  */
-void  MIDI_SendNoteOff(uint8_t chan, uint8_t noteNum)
+void  VoiceDropOut(uint8_t voice)
 {
-  uint8_t statusByte = 0x80 | ((chan - 1) & 0xF);
+  if (voice >= MAX_VOICES || !m_VoicePresent[voice])  return;
+
+  if (g_channelStatus[voice] != GATE_OFF)
+  {
+    MIDI_SendNoteOff(voice+1, g_channelStatus[voice]);
+    m_NoteVoice[g_channelStatus[voice]] = VOICE_NONE;
+    g_channelStatus[voice] = GATE_OFF;
+    VoiceListRemove(&m_BusyVoices, voice);
+  }
+  else  VoiceListRemove(&m_FreeVoices, voice);
 
-  Serial1.write(statusByte);
-  Serial1.write(noteNum & 0x7F);
-  Serial1.write((const uint8_t) 0);
+  m_VoicePresent[voice] = FALSE;
+  g_NumberOfVoices--;
+  g_VoiceDropOuts++;
 }
 
-/*
- * Function:     Transmit MIDI Pitch Bend message.
- *
- * Entry args:   chan = MIDI channel number (1..16)
+
+// Index of the first voice present after the given voice (-1 for the first voice);
+// VOICE_NONE if there is none.
+//
+uint8_t  VoiceNextPresent(short voice)
+{
+  for (++voice;  voice < MAX_VOICES;  voice++)
+  {
+    if (m_VoicePresent[voice])  return  (uint8_t) voice;
+  }
+  return  VOICE_NONE;
+}
+
+
+/*
+ * Function:     Find the quietest voice in a voice list, i.e. the lowest audio output
+ *               level reported by the voice since its last note-on/off (see VoiceLevel).
+ *               A voice with no such report is taken to be louder than any voice with one.
+ *               Of voices at the same level, the first in the list (oldest) is chosen, so
+ *               if no voice reports status, the choice is the same as by list order alone.
+ *
+ * Return val:   voice index (0..N-1);  VOICE_NONE if the list is empty
+ */
+uint8_t  VoiceListQuietest(VoiceList_t *list)
+{
+  uint8_t  voice;
+  uint8_t  quietest = list->Head;
+  short    level, lowest = 999;
+
+  for (voice = list->Head;  voice != VOICE_NONE;  voice = m_VoiceNext[voice])
+  {
+    level = VoiceLevel(voice);
+    if (level < lowest)  { quietest = voice;  lowest = level; }
+  }
+  return  quietest;
+}
+
+
+// Voice output level (0..127) as last reported;  0 if ENV1 idle;  128 if not known, i.e.
+// no status received since the last note-on/off sent to the voice (allowing one slot
+// time for the message to be processed before the status reply).
+//
+short  VoiceLevel(uint8_t voice)
+{
+  VoiceStatus_t  *pStatus = &m_VoiceStatus[voice];
+
+  if (pStatus->TimeRcvd == 0)  return  128;
+  if ((int32_t)(pStatus->TimeRcvd - m_VoiceEventTime[voice]) < VOICE_STATUS_SLOT_MS)  return  128;
+  if (pStatus->Env1Phase == VOICE_ENV_IDLE)  return  0;
+  return  pStatus->OutputLevel;
+}
+
+
+// Voice list operations -- append voice at tail of list;  remove voice from list.
+//
+void  VoiceListAppend(VoiceList_t *list, uint8_t voice)
+{
+  m_VoiceNext[voice] = VOICE_NONE;
+  m_VoicePrev[voice] = list->Tail;
+  if (list->Tail != VOICE_NONE)  m_VoiceNext[list->Tail] = voice;
+  else  list->Head = voice;
+  list->Tail = voice;
+}
+
+void  VoiceListRemove(VoiceList_t *list, uint8_t voice)
+{
+  if (m_VoicePrev[voice] != VOICE_NONE)  m_VoiceNext[m_VoicePrev[voice]] = m_VoiceNext[voice];
+  else  list->Head = m_VoiceNext[voice];
+  if (m_VoiceNext[voice] != VOICE_NONE)  m_VoicePrev[m_VoiceNext[voice]] = m_VoicePrev[voice];
+  else  list->Tail = m_VoicePrev[voice];
+}
+
+
+// A few received CC messages are intended for the Master Controller only;
+// some others are filtered out, i.e. not passed through;
+// continuous controllers (modulation, breath, volume, expression) are passed through
+// to the voice channels in a broadcast msg, via the controller cache.
+//
+void  ProcessControlChange(uint8_t *midiMessage)
+{
+  uint8_t CCnumber = midiMessage[1];
+  uint8_t dataByte = midiMessage[2];  // CC data value
+  uint8_t slot;
+
+  for (slot = 1;  slot < CTRL_CACHE_SLOTS;  slot++)
+  {
+    if (CCnumber == c_CoalescedCC[slot])  break;
+  }
+
+  if (slot < CTRL_CACHE_SLOTS)  ControllerCacheUpdate(slot, dataByte);
+  else if (CCnumber == 100)  g_MidiRegisParam = dataByte; // "Registered Param" ID
+  else if (CCnumber == 38)  // Parameter "Data Entry" message
+  {
+    if (g_MidiRegisParam == 0x00 && dataByte <= 12) 
+    {
+      g_Config.PitchBendRange = dataByte;
+      StoreConfigData();
+      MIDI_SendRegisteredParam(BROADCAST, 0, g_Config.PitchBendRange);  // PB range
+    }
+    if (g_MidiRegisParam == 0x01)  // Master Tune param
+    {
+      g_Config.MasterTuneOffset = dataByte;
+      StoreConfigData();
+      ExecuteVoiceTuning();
+    }
+  }
+  else if (CCnumber == 80) { ; }   // Set Osc. mixer level - blocked
+  else if (CCnumber == 112) { ; }  // LFO phase sync. - blocked
+}
+
+
+/*
+ * Function:     Put a continuous controller value into the controller cache, to be sent
+ *               to the voices by ControllerCacheService().  If the previous value in
+ *               the slot is not yet sent, it is superseded ("latest value wins").
+ *
+ * Entry args:   slot = cache slot (0: Pitch Bend, 1..8: CC number, see c_CoalescedCC[])
+ *               value = controller value (7 bits;  Pitch Bend 14 bits)
+ */
+void  ControllerCacheUpdate(uint8_t slot, uint16_t value)
+{
+  if (m_CtrlCacheDirty & (1 << slot))  g_CtrlCoalesced++;
+  m_CtrlCacheValue[slot] = value;
+  m_CtrlCacheDirty |= (1 << slot);
+}
+
+
+/*
+ * Function:     Send pending controller values to the voices (broadcast), limited to one
+ *               message per controller per CTRL_SEND_PERIOD_MS.  Called from the main
+ *               loop after MidiInputService().
+ *
+ * A controller value is queued for MIDI OUT only when the previous message of the same
+ * type (Pitch Bend or CC) has left the transmit queue, so controller data never builds up
+ * in the queues, however fast the player rides the wheels.  Note-On/Off messages have
+ * a higher transmit priority anyway (see MidiTransmit).
+ */
+void  ControllerCacheService()
+{
+  uint32_t  timeNow = millis();
+  uint8_t   slot;
+
+  if (m_CtrlCacheDirty == 0)  return;  // nothing to send
+
+  for (slot = 0;  slot < CTRL_CACHE_SLOTS;  slot++)
+  {
+    if ((m_CtrlCacheDirty & (1 << slot)) == 0)  continue;
+    if ((timeNow - m_CtrlCacheSent[slot]) < CTRL_SEND_PERIOD_MS)  continue;
+    if (!MidiTxQueueEmpty(slot == 0 ? TX_PRIORITY_PITCH : TX_PRIORITY_CTRL))  continue;
+    if (slot == 0)  MIDI_SendPitchBend(BROADCAST, m_CtrlCacheValue[0]);
+    else  MIDI_SendControlChange(BROADCAST, c_CoalescedCC[slot], m_CtrlCacheValue[slot]);
+    m_CtrlCacheSent[slot] = timeNow;
+    m_CtrlCacheDirty &= ~(1 << slot);
+  }
+}
+
+
+uint8_t  MIDI_GetMessageLength(uint8_t statusByte)
+{
+  uint8_t  command = statusByte & 0xF0;
+  uint8_t  length = 0;  // assume unsupported or unknown msg type
+
+  if (command == PROGRAM_CHANGE_CMD || command == CHAN_PRESSURE_CMD)  length = 2;
+  if (command == NOTE_ON_CMD || command == NOTE_OFF_CMD
+  ||  command == CONTROL_CHANGE_CMD || command == PITCH_BEND_CMD)
+  {
+    length = 3;
+  }
+  return  length;
+}
+
+/*
+ * Function:     Transmit MIDI Note-On/Velocity message.
+ *
+ * Entry args:   chan = MIDI channel number (1..16)
+ *               noteNum = MIDI standard note number. (Note #60 = C4 = middle-C.)
+ *               velocity = output level of ampld envelope shaper (DCA)
+ */
+void  MIDI_SendNoteOn(uint8_t chan, uint8_t noteNum, uint8_t velocity)
+{
+  uint8_t  msg[3];
+
+  msg[0] = 0x90 | ((chan - 1) & 0xF);
+  msg[1] = noteNum & 0x7F;
+  msg[2] = velocity & 0x7F;
+#if NOTE_LATENCY_TRACE
+  // Stamp queued before the message, so it is there when MidiTransmit() sends the note
+  m_TraceStamp[m_TraceStampHead & (TRACE_STAMP_QUEUE_SIZE - 1)] = m_MidiRxMsgTime;
+  m_TraceStampHead++;
+#endif
+  MidiTxEnqueue(TX_PRIORITY_GATE, msg, 3);
+}
+
+/*
+ * Function:     Transmit MIDI Note-Off message.
+ *
+ * Entry args:   chan = MIDI channel number (1..16)
+ *               noteNum = MIDI note number.
+ */
+void  MIDI_SendNoteOff(uint8_t chan, uint8_t noteNum)
+{
+  uint8_t  msg[3];
+
+  msg[0] = 0x80 | ((chan - 1) & 0xF);
+  msg[1] = noteNum & 0x7F;
+  msg[2] = 0;
+  MidiTxEnqueue(TX_PRIORITY_GATE, msg, 3);
+}
+
+/*
+ * Function:     Transmit MIDI Pitch Bend message.
+ *
+ * Entry args:   chan = MIDI channel number (1..16)
  *               value = Pitch deviation value (14 bits).
  */
 void  MIDI_SendPitchBend(uint8_t chan, uint16_t value)
 {
-  uint8_t statusByte = 0xE0 | ((chan - 1) & 0xF);
+  uint8_t  msg[3];
+
+  msg[0] = 0xE0 | ((chan - 1) & 0xF);
+  msg[1] = value & 0x7F;           // 7 LS bits
+  msg[2] = (value >> 7) & 0x7F;    // 7 MS bits
+  MidiTxEnqueue(TX_PRIORITY_PITCH, msg, 3);
+}
+
+/*
+ * Function:     Transmit MIDI Control Change message.
+ *
+ * Entry args:   chan = MIDI channel number (1..16)
+ *               ctrlNum = Control Number (0..119) -- not range checked.
+ *               value = Controller data value (MSB or LSB).
+ */
+void  MIDI_SendControlChange(uint8_t chan, uint8_t ctrlNum, uint8_t value)
+{
+  uint8_t  msg[3];
+
+  msg[0] = 0xB0 | ((chan - 1) & 0xF);
+  msg[1] = ctrlNum & 0x7F;
+  msg[2] = value & 0x7F;
+  MidiTxEnqueue(m_MidiTxCtrlPriority, msg, 3);
+}
+
+/*
+ * Function:     Transmit a Registered Parameter setting:  Control Change 100 (param number)
+ *               followed by Control Change 38 (data entry), using running status.
+ *
+ * Both CC messages are queued as one entry, so MidiTransmit() sends them back to back;
+ * an RPN select from one queue cannot be followed by data entry from another queue.
+ *
+ * Entry args:   chan = MIDI channel number (1..16)
+ *               paramNum = Registered Parameter number (0: PB range, 1: Fine Tuning)
+ *               value = Parameter data value (0..127)
+ */
+void  MIDI_SendRegisteredParam(uint8_t chan, uint8_t paramNum, uint8_t value)
+{
+  uint8_t  msg[5];
+
+  msg[0] = 0xB0 | ((chan - 1) & 0xF);
+  msg[1] = 100;
+  msg[2] = paramNum & 0x7F;
+  msg[3] = 38;  // running status
+  msg[4] = value & 0x7F;
+  MidiTxEnqueue(m_MidiTxCtrlPriority, msg, 5);
+}
+
+/*
+ * Function:     Transmit MIDI Program Change message.
+ *
+ * Entry args:   chan = MIDI channel number (1..16)
+ *               progNum = Program (instrument/voice) number. Depends on MIDI device.
+ */
+void  MIDI_SendProgramChange(uint8_t chan, uint8_t progNum)
+{
+  uint8_t  msg[2];
+
+  msg[0] = 0xC0 | ((chan - 1) & 0xF);
+  msg[1] = progNum & 0x7F;
+  MidiTxEnqueue(m_MidiTxCtrlPriority, msg, 2);
+}
+
+/*
+ * Function:     Transmit Bauer (REMI) System Exclusive message.
+ *
+ * Message format:  F0 73 <msgType> <chan> [data bytes...] F7
+ *
+ * Entry args:   msgType = message type code (3rd byte of message)
+ *               chan = MIDI channel number of target device (1..16)
+ *               pData = pointer to data bytes (7 bits) -- may be NULL if count == 0
+ *               count = number of data bytes (max. MIDI_TX_SYSEX_MAX_DATA)
+ */
+void  MIDI_SendSysExMessage(uint8_t msgType, uint8_t chan, uint8_t *pData, short count)
+{
+  uint8_t  msg[MIDI_TX_SYSEX_MAX_DATA + 5];
+  short    length = 0;
+
+  if (count > MIDI_TX_SYSEX_MAX_DATA)  count = MIDI_TX_SYSEX_MAX_DATA;
+  msg[length++] = SYS_EXCLUSIVE_MSG;
+  msg[length++] = SYS_EXCL_REMI_ID;
+  msg[length++] = msgType & 0x7F;
+  msg[length++] = chan & 0x7F;
+  while (count-- > 0)  msg[length++] = *pData++ & 0x7F;
+  msg[length++] = SYSTEM_MSG_EOX;
+  MidiTxEnqueue(TX_PRIORITY_BULK, msg, length);
+}
+
+
+/*
+ * Function:     Transmit a complete patch to voice module(s) in one SysEx message.
+ *
+ * Message format:  F0 73 02 <chan> <size> <packed patch data> <checksum> F7
+ * where <size> = sizeof(PatchParamTable_t), 2 bytes (MS byte first), patch data is packed
+ * as 7-bit bytes (see SysExPackData) and <checksum> is chosen such that the sum of all
+ * bytes from <size> to <checksum> inclusive is zero (modulo 128).
+ *
+ * The voice applies the patch with a fade-out/fade-in, as for a Program Change;  all
+ * param's are sent at full resolution, i.e. not quantized as in individual CC messages.
+ *
+ * Entry args:   chan = MIDI channel number of target voice (1..16, 16 = broadcast)
+ *               patch = pointer to patch param table to be sent
+ */
+void  MIDI_SendPatchData(uint8_t chan, PatchParamTable_t *patch)
+{
+  uint8_t  data[2 + SYSEX_PACKED_SIZE(sizeof(PatchParamTable_t)) + 1];
+  uint8_t  checksum = 0;
+  short    count, i;
+
+  data[0] = (sizeof(PatchParamTable_t) >> 7) & 0x7F;
+  data[1] = sizeof(PatchParamTable_t) & 0x7F;
+  count = 2 + SysExPackData(&data[2], (uint8_t *) patch, sizeof(PatchParamTable_t));
+
+  for (i = 0;  i < count;  i++)  { checksum += data[i]; }
+  data[count++] = (0 - checksum) & 0x7F;
+
+  MIDI_SendSysExMessage(SYSEX_PATCH_DATA, chan, data, count);
+}
+
+
+/*
+ * Function:     Pack 8-bit data into SysEx message data (7-bit bytes).  Each group of
+ *               up to 7 data bytes is preceded by a byte holding their MS bits, bit0 for
+ *               the first byte of the group, bit1 for the next, etc.
+ *
+ * Entry args:   pDest  = pointer to next free location in SysEx data buffer
+ *               pSrc   = pointer to 8-bit data to be packed
+ *               nbytes = number of 8-bit data bytes
+ *
+ * Return val:   number of SysEx data bytes output, = SYSEX_PACKED_SIZE(nbytes)
+ */
+short  SysExPackData(uint8_t *pDest, uint8_t *pSrc, short nbytes)
+{
+  uint8_t  *pMSbits = pDest;
+  short    count = 0;
+  short    i;
+
+  for (i = 0;  i < nbytes;  i++)
+  {
+    if ((i % 7) == 0)  // start of group
+    {
+      pMSbits = &pDest[count++];
+      *pMSbits = 0;
+    }
+    if (pSrc[i] & 0x80)  *pMSbits |= (1 << (i % 7));
+    pDest[count++] = pSrc[i] & 0x7F;
+  }
+  return  count;
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiTxEnqueue()
+ *
+ * Put a MIDI message into the transmit queue for the given priority level.  The message
+ * is sent by MidiTransmit() when all higher priority queues are empty.
+ * If there is no room in the queue, this function waits for queued messages to be sent,
+ * as Serial1.write() would when the UART TX buffer is full.
+ *
+ * Entry args:   priority = TX_PRIORITY_GATE, _PITCH, _CTRL or _BULK
+ *               pMsg = pointer to complete message, status byte first
+ *               length = number of bytes in message (max. MIDI_TX_SYSEX_MAX_DATA + 5)
+ */
+void  MidiTxEnqueue(uint8_t priority, uint8_t *pMsg, short length)
+{
+  MidiTxQueue_t  *pQueue = &m_MidiTxQueue[priority];
+  uint16_t  head = pQueue->Head;
+
+  while (((pQueue->Tail - head - 1) & (MIDI_TX_QUEUE_SIZE - 1)) < (length + 1))
+  {
+    MidiOutputService();  // wait for room in queue
+  }
+  pQueue->Buffer[head] = (uint8_t) length;
+  head = (head + 1) & (MIDI_TX_QUEUE_SIZE - 1);
+  while (length-- > 0)
+  {
+    pQueue->Buffer[head] = *pMsg++;
+    head = (head + 1) & (MIDI_TX_QUEUE_SIZE - 1);
+  }
+  pQueue->Head = head;  // message is now visible to MidiTransmit()
+}
+
+
+bool  MidiTxQueueEmpty(uint8_t priority)
+{
+  return  (m_MidiTxQueue[priority].Head == m_MidiTxQueue[priority].Tail);
+}
+
+
+// Control Change and Program Change messages sent between MidiTxBulkBegin() and
+// MidiTxBulkEnd() are queued at bulk priority, behind notes and real-time controllers.
+// Bulk messages stay in sequence.
+//
+void  MidiTxBulkBegin()
+{
+  m_MidiTxCtrlPriority = TX_PRIORITY_BULK;
+}
+
+void  MidiTxBulkEnd()
+{
+  m_MidiTxCtrlPriority = TX_PRIORITY_CTRL;
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiOutputService()
+ *
+ * MIDI OUT service routine, executed frequently from within main loop.
+ * Calls MidiTransmit(), with the SysTick hook held off.
+ */
+void  MidiOutputService()
+{
+  v_MidiTxBusy = TRUE;   // hold off sysTickHook()
+  MidiTransmit();
+  v_MidiTxBusy = FALSE;
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiTransmit()
+ *
+ * Move queued MIDI OUT messages into the voice bus (VOICE_BUS) UART TX buffer, which is
+ * drained by the UART TX interrupt.  This function never waits for the UART.  Called by
+ * the SysTick interrupt (sysTickHook) and by MidiOutputService() in the main loop.
+ *
+ * The next message is taken from the highest priority queue not empty, and it is started
+ * only while the UART TX buffer holds less than MIDI_TX_BACKLOG_MAX bytes, so a Note-On
+ * waits behind a few bytes at most.  A message, once started, is completed before another
+ * is started, so messages are never interleaved.
+ *
+ * Running status:  the status byte of a channel message is omitted if it is the same as
+ * the last status byte sent.  System messages (SysEx) cancel running status.
+ */
+void  MidiTransmit()
+{
+  MidiTxQueue_t  *pQueue;
+  uint8_t  priority;
+  uint8_t  statusByte;
+  int      room;
+
+  while (TRUE)
+  {
+    if (m_MidiTxRemain == 0)  // start next message, if any
+    {
+      if (MIDI_TX_BACKLOG() >= MIDI_TX_BACKLOG_MAX)  break;
+      for (priority = 0;  priority < TX_PRIORITY_LEVELS;  priority++)
+      {
+        if (!MidiTxQueueEmpty(priority))  break;
+      }
+      if (priority == TX_PRIORITY_LEVELS)  break;  // all queues empty
+
+      pQueue = &m_MidiTxQueue[priority];
+      m_MidiTxRemain = pQueue->Buffer[pQueue->Tail];  // message length
+      pQueue->Tail = (pQueue->Tail + 1) & (MIDI_TX_QUEUE_SIZE - 1);
+      m_MidiTxCurQueue = priority;
+
+      statusByte = pQueue->Buffer[pQueue->Tail];
+      if (statusByte == m_MidiTxRunStatus)  // omit status byte
+      {
+        pQueue->Tail = (pQueue->Tail + 1) & (MIDI_TX_QUEUE_SIZE - 1);
+        m_MidiTxRemain--;
+        g_MidiTxStatusSaved++;
+      }
+      else  m_MidiTxRunStatus = (statusByte < SYS_EXCLUSIVE_MSG) ? statusByte : 0;
+#if NOTE_LATENCY_TRACE
+      m_MidiTxNoteOn = (priority == TX_PRIORITY_GATE && (statusByte & 0xF0) == NOTE_ON_CMD);
+#endif
+      m_MidiTxStatusPoll = (statusByte == SYS_EXCLUSIVE_MSG  // SysEx type is 3rd byte
+          && pQueue->Buffer[(pQueue->Tail + 2) & (MIDI_TX_QUEUE_SIZE - 1)] == SYSEX_STATUS_POLL);
+    }
+
+    pQueue = &m_MidiTxQueue[m_MidiTxCurQueue];
+#ifdef SERIAL_BUFFER_SIZE
+    room = VOICE_BUS.availableForWrite();
+#else
+    room = m_MidiTxRemain;
+#endif
+    while (m_MidiTxRemain != 0 && room-- > 0)
+    {
+      VOICE_BUS.write(pQueue->Buffer[pQueue->Tail]);
+      pQueue->Tail = (pQueue->Tail + 1) & (MIDI_TX_QUEUE_SIZE - 1);
+      m_MidiTxRemain--;
+      g_MidiTxBytes++;
+    }
+#if NOTE_LATENCY_TRACE
+    if (m_MidiTxRemain == 0 && m_MidiTxNoteOn)  LatencyTraceSent();
+#endif
+    if (m_MidiTxRemain == 0 && m_MidiTxStatusPoll)  StatusPollSent();
+    if (m_MidiTxRemain != 0)  break;  // UART TX buffer full
+  }
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  VoiceReplyService()
+ *
+ * Voice reply input service routine, executed frequently from within main loop.
+ * This routine monitors the voice reply serial stream (Serial2) and whenever a complete
+ * SysEx message is received, it is processed.  Other message types are ignored.
+ *
+ * If a voice query (from the CLI) is in progress, the next voice is queried when a reply
+ * is received from the voice under query, or the reply time-out expires.
+ *
+ * Otherwise, a voice status poll is broadcast VOICE_STATUS_POLL_GAP_MS after the reply
+ * window of the previous poll has ended.  Each voice replies in its own time slot
+ * (VOICE_STATUS_SLOT_MS x (channel - 1) after the poll), so replies do not collide.
+ * A CLI query is not started until the slots have ended.
+ *
+ * Voice discovery:  The reply window normally ends after the slot of the highest voice
+ * channel present.  Until the voices are initialized, and every VOICE_DISCOVERY_MS
+ * thereafter, the window covers all channels (1..MAX_VOICES), so that a voice which is
+ * not yet present can reply without a collision;  on its first reply, it is added to
+ * the voice allocation pool (see ProcessVoiceReply).  A voice which has not replied for
+ * VOICE_DROPOUT_MS is removed from the pool, so the synth keeps going with the voices
+ * remaining.  The poll is deferred while bulk data is queued for MIDI OUT.
+ * The reply window is timed from when the poll is sent, not queued (see StatusPollSent).
+ */
+void  VoiceReplyService()
+{
+  static  uint8_t  replyMessage[MIDI_MSG_MAX_LENGTH];
+  static  short  msgIndex;
+  static  bool   gotSysExStatus;  // flag: SysEx message in progress
+  static  bool   awaitingReply;   // flag: query sent to voice g_VoiceQuery
+  static  uint32_t  queryTime;    // time query was sent (ms)
+
+  uint8_t  msgByte, nextVoice;
+
+  if (Serial2.available() > 0)  // unread byte(s) available in Rx buffer
+  {
+    msgByte = Serial2.read();
+
+    if (msgByte == SYS_EXCLUSIVE_MSG)
+    {
+      gotSysExStatus = TRUE;
+      replyMessage[0] = msgByte;
+      msgIndex = 1;
+    }
+    else if (gotSysExStatus && msgByte == SYSTEM_MSG_EOX)
+    {
+      gotSysExStatus = FALSE;
+      replyMessage[msgIndex++] = msgByte;
+      ProcessVoiceReply(replyMessage, msgIndex);
+    }
+    else if (msgByte & 0x80)  gotSysExStatus = FALSE;  // not a SysEx msg
+    else if (gotSysExStatus && msgIndex < (MIDI_MSG_MAX_LENGTH - 1))
+      replyMessage[msgIndex++] = msgByte;
+  }
+
+  if (g_VoiceQuery == 0)  // no CLI voice query in progress...
+  {
+    if (!v_StatusPollPending
+    &&  (int32_t)(millis() - v_StatusPollTime) >= (m_StatusWindow + VOICE_STATUS_POLL_GAP_MS)
+    &&  MidiTxQueueEmpty(TX_PRIORITY_BULK))
+    {
+      VoiceDropOutCheck();
+      if (!g_VoicesInitialized || g_NumberOfVoices == 0
+      ||  (millis() - m_DiscoveryPollTime) >= VOICE_DISCOVERY_MS)
+      {
+        m_StatusWindow = VOICE_STATUS_WINDOW_MS(MAX_VOICES);
+        m_DiscoveryPollTime = millis();
+      }
+      else  m_StatusWindow = VOICE_STATUS_WINDOW_MS(VoiceHighestPresent() + 1);
+      v_StatusPollPending = TRUE;  // until sent (StatusPollSent)
+      MIDI_SendSysExMessage(SYSEX_STATUS_POLL, BROADCAST, NULL, 0);
+    }
+  }
+  else  // CLI voice query in progress...
+  {
+    if (!awaitingReply)
+    {
+      if (v_StatusPollPending || (int32_t)(millis() - v_StatusPollTime) < m_StatusWindow)
+        return;  // wait
+      g_VoiceReplyRcvd = FALSE;
+      MIDI_SendSysExMessage(g_VoiceQueryType, g_VoiceQuery, &g_VoiceQueryFlags, 1);
+      queryTime = millis();
+      awaitingReply = TRUE;
+    }
+    else if (g_VoiceReplyRcvd || (millis() - queryTime) >= VOICE_REPLY_TIMEOUT_MS)
+    {
+      if (!g_VoiceReplyRcvd)
+      {
+        Serial.print("  ");
+        Serial.print((int) g_VoiceQuery);
+        Serial.println("\t-- no reply --");
+      }
+      awaitingReply = FALSE;
+      // A latency query is sent for each stage in turn (flags bits 2:1), then next voice
+      if (g_VoiceReplyRcvd && g_VoiceQueryType == SYSEX_LATENCY_QUERY
+      &&  (g_VoiceQueryFlags >> 1) < (LATENCY_STAGES - 1))
+      {
+        g_VoiceQueryFlags += 2;  // next stage, same voice
+        return;
+      }
+      g_VoiceQueryFlags &= 1;  // stage 0 for next voice (reset flag kept)
+      nextVoice = VoiceNextPresent(g_VoiceQuery - 1);
+      if (nextVoice != VOICE_NONE)  g_VoiceQuery = nextVoice + 1;
+      else  // done
+      {
+        g_VoiceQuery = 0;
+        Serial.print("\r\n> ");  // prompt
+      }
+    }
+  }
+}
+
+
+// Status poll written to the voice bus UART (TX buffer) -- record the time its last byte
+// will have been sent, i.e. after the bytes ahead of it in the UART TX buffer, since the
+// voices time their reply slots from its arrival.  The time may be a few ms ahead of
+// millis(), so it is compared as a signed difference.  Called by MidiTransmit() only.
+//
+void  StatusPollSent()
+{
+  m_MidiTxStatusPoll = FALSE;
+  v_StatusPollTime = millis() + (MIDI_TX_BACKLOG() * 10000UL) / VOICE_BUS_RATE;  // 10 bits/byte
+  v_StatusPollPending = FALSE;
+}
+
+
+// Remove voices from the pool which have not replied to a status poll sent in the last
+// VOICE_DROPOUT_MS, i.e. before the latest poll.  Not if voices are assumed present.
+//
+void  VoiceDropOutCheck()
+{
+  uint8_t  voice;
+
+  if (m_VoicesAssumed)  return;
+
+  for (voice = 0;  voice < MAX_VOICES;  voice++)
+  {
+    if (m_VoicePresent[voice]
+    &&  (int32_t)(v_StatusPollTime - m_VoiceStatus[voice].TimeRcvd) > VOICE_DROPOUT_MS)
+      VoiceDropOut(voice);
+  }
+}
+
+
+// Index of the highest voice present (0..MAX_VOICES-1);  0 if none.
+//
+uint8_t  VoiceHighestPresent()
+{
+  uint8_t  voice;
 
-  Serial1.write(statusByte);
-  Serial1.write(value & 0x7F);           // 7 LS bits
-  Serial1.write((value >> 7) & 0x7F);    // 7 MS bits
+  for (voice = MAX_VOICES - 1;  voice > 0;  voice--)
+  {
+    if (m_VoicePresent[voice])  break;
+  }
+  return  voice;
 }
 
+
 /*
- * Function:     Transmit MIDI Control Change message.
+ * Function:     Process a SysEx message received from a voice module.
  *
- * Entry args:   chan = MIDI channel number (1..16)
- *               ctrlNum = Control Number (0..119) -- not range checked.
- *               value = Controller data value (MSB or LSB).
+ * A Bauer (REMI) message type ISR_STATS_REPLY contains audio ISR load statistics,
+ * which are printed on the CLI (USB serial port).  See ListVoiceIsrStats().
+ * A message type LATENCY_REPLY contains a note latency histogram, printed likewise.
+ * A message type STATUS_REPLY (with valid checksum, see VoiceReplyChecksumOK) is stored
+ * in m_VoiceStatus[] for use by the voice allocator;
+ * a voice not present is added to the allocation pool (see VoiceJoin).  The first reply
+ * from a voice when voices are assumed present ends the assumption, so voices which do
+ * not reply are removed from the pool in time.
  */
-void  MIDI_SendControlChange(uint8_t chan, uint8_t ctrlNum, uint8_t value)
+void  ProcessVoiceReply(uint8_t *replyMessage, short msgLength)
+{
+  uint8_t  msgType = replyMessage[2];
+  uint8_t  msgChannel = replyMessage[3];  // replying voice channel (1..16)
+  VoiceStatus_t  *pStatus;
+
+  if (replyMessage[1] != SYS_EXCL_REMI_ID)  return;  // not a Bauer message
+
+  if (msgType == SYSEX_ISR_STATS_REPLY && msgLength >= 25)
+  {
+    ListVoiceIsrStats(msgChannel, &replyMessage[4], msgLength - 5);
+    if (msgChannel == g_VoiceQuery)  g_VoiceReplyRcvd = TRUE;
+  }
+
+  if (msgType == SYSEX_LATENCY_REPLY && msgLength == 31)
+  {
+    ListVoiceLatency(msgChannel, &replyMessage[4]);
+    if (msgChannel == g_VoiceQuery)  g_VoiceReplyRcvd = TRUE;
+  }
+
+  if (msgType == SYSEX_STATUS_REPLY && msgLength == 11
+  &&  msgChannel >= 1 && msgChannel <= MAX_VOICES && VoiceReplyChecksumOK(replyMessage))
+  {
+    pStatus = &m_VoiceStatus[msgChannel - 1];
+    pStatus->Env1Phase = replyMessage[4];
+    pStatus->Env1Level = replyMessage[5];
+    pStatus->OutputLevel = replyMessage[6];
+    pStatus->LoadPc = replyMessage[7];
+    pStatus->NotePlaying = replyMessage[8];
+    pStatus->TimeRcvd = millis() | 1;  // non-zero
+    m_VoicesAssumed = FALSE;
+    VoiceJoin(msgChannel - 1);
+  }
+}
+
+
+// Status reply:  F0 73 43 <chan> <ENV1 phase> <ENV1 level> <output level> <ISR load %>
+// <note> <checksum> F7 -- the sum of bytes from <ENV1 phase> to <checksum> inclusive must
+// be zero (modulo 128), otherwise the reply was corrupted (e.g. by a slot collision).
+//
+bool  VoiceReplyChecksumOK(uint8_t *replyMessage)
 {
-  uint8_t statusByte = 0xB0 | ((chan - 1) & 0xF);
+  uint8_t  i, sum = 0;
 
-  Serial1.write(statusByte);
-  Serial1.write(ctrlNum & 0x7F);
-  Serial1.write(value & 0x7F);
+  for (i = 4;  i < 10;  i++)  sum += replyMessage[i];
+  return  ((sum & 0x7F) == 0);
 }
 
+
 /*
- * Function:     Transmit MIDI Program Change message.
+ * Function:     Get an unsigned value from a SysEx message comprising 7-bit data bytes,
+ *               MS byte first.
  *
- * Entry args:   chan = MIDI channel number (1..16)
- *               progNum = Program (instrument/voice) number. Depends on MIDI device.
+ * Entry args:   pData  = pointer to first data byte of value in message
+ *               nbytes = number of data bytes (1..4)
  */
-void  MIDI_SendProgramChange(uint8_t chan, uint8_t progNum)
+uint32_t  SysExGetValue(uint8_t *pData, int nbytes)
 {
-  uint8_t statusByte = 0xC0 | ((chan - 1) & 0xF);
+  uint32_t  value = 0;
 
-  Serial1.write(statusByte);
-  Serial1.write(progNum & 0x7F);
+  while (nbytes--)  { value = (value << 7) | (*pData++ & 0x7F); }
+  return  value;
 }
 
 
@@ -657,72 +1913,157 @@ void  DefaultConfigData(void)
   g_Config.DisplayBrightness = 30;   // %
   g_Config.EEpromCheckWord = 0xABCDE090;
 
-  for (voice = 0; voice < 12; voice++)  // max. 12 voices
+  for (voice = 0; voice < MAX_VOICES; voice++)
     { g_Config.VoiceTuning[voice] = 64; }  // Reset (64 = zero offset)
 }
 
+/*
+ * Config param's and User Presets are stored in a RAM image of the EEPROM data, loaded
+ * at start-up.  Store functions update the image and mark the pages changed as "dirty";
+ * EEpromService() writes them to the EEPROM in the background (write-behind), so the
+ * main loop is not held up for the EEPROM write cycle (up to 5ms per page).  Fetch
+ * functions copy data from the image;  the EEPROM is not accessed.
+ */
 void  StoreConfigData()
 {
-  uint16_t  promAddr = 0;
-  uint8_t  *pData = (uint8_t *) &g_Config;
-  short  bytesToCopy = (short) sizeof(g_Config);
-  int    errorCode;
-
-  while (bytesToCopy > 0)
-  {
-    errorCode = EEpromWriteData(pData, promAddr, (bytesToCopy >= 32) ? 32 : bytesToCopy);
-    if (errorCode != 0)  break;
-    promAddr += 32;  pData += 32;  bytesToCopy -= 32;
-  }
+  EEpromImageUpdate(0, (uint8_t *) &g_Config, sizeof(g_Config));
 }
 
 uint8_t  FetchConfigData()
 {
-  uint16_t  promAddr = 0;
-  short  bytesToCopy = (short) sizeof(g_Config);
-  uint8_t  *pData = (uint8_t *) &g_Config;
-  uint8_t  count = 0;
-
-  while (bytesToCopy > 0)
-  {
-    count += EEpromReadData(pData, promAddr, (bytesToCopy >= 32) ? 32 : bytesToCopy);
-    if (count == 0)  break;
-    promAddr += 32;  pData += 32;  bytesToCopy -= 32;
-  }
-  return  count;  // number of bytes read;  0 if an error occurred
+  if (g_EEpromFaulty)  return 0;
+  memcpy(&g_Config, &m_EEpromImage[0], sizeof(g_Config));
+  return  sizeof(g_Config);  // number of bytes read;  0 if an error occurred
 }
 
 
 void  StoreUserPreset(uint8_t favNum)  // Favorite number, favNum = 0..7
 {
-  uint16_t promAddr = 0x100 + favNum * 128;  // assume sizeof(g_Patch) <= 128
-  uint8_t  *pData = (uint8_t *) &g_Patch;  // active patch addr
-  short  bytesToCopy = (short) sizeof(g_Patch);
+  uint16_t promAddr = USER_PRESET_ADDR(favNum);
 
   if (g_EEpromFaulty || favNum > 7)  return;
 
-  while (bytesToCopy > 0)
-  {
-    EEpromWriteData(pData, promAddr, (bytesToCopy >= 32) ? 32 : bytesToCopy);
-    promAddr += 32;  pData += 32;  bytesToCopy -= 32;
-  }
+  EEpromImageUpdate(promAddr, (uint8_t *) &g_Patch, sizeof(g_Patch));
 }
 
 void  FetchUserPreset(uint8_t favNum)  // Favorite number, favNum = 0..7
 {
-  uint16_t promAddr = 0x100 + favNum * 128;  // assume sizeof(g_Patch) <= 128
-  uint8_t  *pData = (uint8_t *) &g_Patch;  // active patch addr
-  short  bytesToCopy = (short) sizeof(g_Patch);
-  uint8_t  count = 0;
+  uint16_t promAddr = USER_PRESET_ADDR(favNum);
 
   if (g_EEpromFaulty || favNum > 7)  return;
 
-  while (bytesToCopy > 0)
+  memcpy(&g_Patch, &m_EEpromImage[promAddr], sizeof(g_Patch));
+}
+
+
+/*
+ * Function:    Copy data into the EEPROM RAM image;  mark the pages changed as dirty and
+ *              re-start the store delay.  Data which is unchanged is not re-written, and
+ *              repeated stores to a page not yet written are coalesced into one write.
+ *
+ * Entry arg's: promAddr = EEPROM address of data (0..EEPROM_IMAGE_SIZE-1)
+ *              pData = pointer to source data
+ *              nbytes = number of bytes to copy
+ */
+void  EEpromImageUpdate(uint16_t promAddr, uint8_t *pData, uint16_t nbytes)
+{
+  while (nbytes-- && promAddr < EEPROM_IMAGE_SIZE)
+  {
+    if (m_EEpromImage[promAddr] != *pData)
+    {
+      m_EEpromImage[promAddr] = *pData;
+      m_EEpromDirty |= (uint64_t) 1 << (promAddr / EEPROM_PAGE_SIZE);
+      m_EEpromStoreTime = millis();
+    }
+    promAddr++;  pData++;
+  }
+}
+
+
+// Read the EEPROM data into the RAM image (at start-up).  If a read error occurs, the
+// EEPROM is flagged as faulty.
+//
+void  EEpromImageLoad()
+{
+  uint16_t  promAddr;
+
+  for (promAddr = 0;  promAddr < EEPROM_IMAGE_SIZE;  promAddr += EEPROM_PAGE_SIZE)
+  {
+    if (EEpromReadData(&m_EEpromImage[promAddr], promAddr, EEPROM_PAGE_SIZE) == 0)
+    {
+      g_EEpromFaulty = TRUE;
+      break;
+    }
+  }
+  m_EEpromDirty = 0;
+}
+
+
+/*````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  EEpromService()
+ *
+ * EEPROM write-behind service routine, executed from within the main loop.  Dirty pages
+ * of the RAM image are written to the EEPROM, one page per call, starting when no data
+ * has been stored for EEPROM_STORE_DELAY_MS (so that a sequence of changes, e.g. a knob
+ * sweep, results in one write per page).  The page write cycle is not waited for:
+ * the EEPROM is ACK-polled once per millisecond, and the next page is written when it
+ * responds.  A page changed while being written is marked dirty again, so it is re-written.
+ * If a page write fails (IIC error or ACK-poll time-out), the page is marked dirty again
+ * and re-tried, up to EEPROM_WRITE_RETRIES attempts, after which it is dropped (the data
+ * is kept in the RAM image only).
+ */
+void  EEpromService()
+{
+  static  uint32_t  pollTime;  // time (ms) of last ACK poll
+  uint8_t   page;
+
+  if (m_EEpromWritePage != 0xFF)  // write cycle in progress
+  {
+    if (millis() == pollTime)  return;  // poll once per ms
+    pollTime = millis();
+    if (EEpromACKresponse())  // done
+    {
+      m_EEpromWritePage = 0xFF;
+      m_EEpromRetries = 0;
+    }
+    else if ((millis() - m_EEpromWriteTime) >= EEPROM_WRITE_TIMEOUT_MS)
+    {
+      EEpromWriteFailed(m_EEpromWritePage);
+      m_EEpromWritePage = 0xFF;
+    }
+    return;
+  }
+
+  if (m_EEpromDirty == 0 || (millis() - m_EEpromStoreTime) < EEPROM_STORE_DELAY_MS)  return;
+
+  if (g_EEpromFaulty)  { m_EEpromDirty = 0;  return; }  // changes kept in RAM only
+
+  for (page = 0;  page < EEPROM_IMAGE_PAGES;  page++)  // find first dirty page
+  {
+    if (m_EEpromDirty & ((uint64_t) 1 << page))  break;
+  }
+  m_EEpromDirty &= ~((uint64_t) 1 << page);
+
+  if (EEpromWriteData(&m_EEpromImage[page * EEPROM_PAGE_SIZE],
+                      page * EEPROM_PAGE_SIZE, EEPROM_PAGE_SIZE) == 0)
   {
-    count += EEpromReadData(pData, promAddr, (bytesToCopy >= 32) ? 32 : bytesToCopy);
-    if (count == 0)  break;  // error
-    promAddr += 32;  pData += 32;  bytesToCopy -= 32;
+    m_EEpromWritePage = page;
+    m_EEpromWriteTime = pollTime = millis();
+    g_EEpromPageWrites++;
   }
+  else  EEpromWriteFailed(page);
+}
+
+
+// Page write failed:  mark the page dirty again to be re-tried, unless the retry limit
+// has been reached, in which case the page is dropped.
+//
+void  EEpromWriteFailed(uint8_t page)
+{
+  g_EEpromErrors++;
+  if (++m_EEpromRetries < EEPROM_WRITE_RETRIES)
+    m_EEpromDirty |= (uint64_t) 1 << page;
+  else  m_EEpromRetries = 0;
 }
 
 
@@ -750,13 +2091,15 @@ bool  EEpromACKresponse(void)
  *              nbytes = number of bytes to write (max. 32 - see note)
  *
  * <!> Note:    24LC64 page buffer is 32 bytes.
+ *              The function returns when the data is sent, i.e. at the start of the page
+ *              write cycle.  The EEPROM does not respond (ACK) until the write cycle is
+ *              complete -- the caller must poll EEpromACKresponse() (see EEpromService).
  *
- * Returns:     Error code, 0xBE if I2C bus error detected;  0 if write OK
+ * Returns:     Error code, IIC error (Wire) or 0xBE if EEPROM not responding;  0 if OK
  */
 int  EEpromWriteData(uint8_t *pData, uint16_t begAddr, uint8_t nbytes)
 {
-  short  npolls = 1000;  // time-out = 25ms @ 400kHz SCK
-  int    errcode = 0;
+  int    errcode = 0xBE;
 
   EEPROM_WRITE_ENABLE();   // Set WP Low
 
@@ -766,11 +2109,7 @@ int  EEpromWriteData(uint8_t *pData, uint16_t begAddr, uint8_t nbytes)
     Wire.write(begAddr >> 8);  // Addr Hi byte
     Wire.write(begAddr & 0xFF);  // Addr Lo byte
     Wire.write(pData, nbytes);
-    errcode = Wire.endTransmission();  // Stop
-    while (npolls--)  // ACK polling -- exit when ACK rec'd
-      { if (EEpromACKresponse()) break; }
-    if (npolls == 0)  errcode = 0xBE;
-    else  EEpromACKresponse();  // (redundant ???)
+    errcode = Wire.endTransmission();  // Stop -- write cycle starts
   }
 
   EEPROM_WRITE_INHIBIT();  // Set WP High (or float)
@@ -823,6 +2162,21 @@ char  argStr1[CLI_ARG_MAX_LEN + 1];    // Command argument #1 (if any)
 char  argStr2[CLI_ARG_MAX_LEN + 1];    // Command argument #2 (if any)
 
 
+// Binary bulk dump/load frame -- see DumpCommand() and BulkLoadService()
+#define BULK_FORMAT_VERSION   1
+#define BULK_HEADER_SIZE      7    // "S6B", version, config size, patch size, preset count
+#define BULK_PRESET_COUNT     8    // User Presets (Favorites)
+#define BULK_FRAME_SIZE  (BULK_HEADER_SIZE + sizeof(ConfigParams_t) \
+                          + BULK_PRESET_COUNT * sizeof(PatchParamTable_t) + 2)
+#define BULK_RX_TIMEOUT_MS  1000   // Max. time between bytes received in bulk load
+
+uint8_t   m_BulkRxBuffer[BULK_FRAME_SIZE];  // bulk load frame received
+uint16_t  m_BulkRxCount;         // bytes of frame received
+uint32_t  m_BulkRxTime;          // time (ms) last byte received
+bool      m_BulkLoadActive;      // CLI input is a bulk load frame (not command line)
+const char  *m_BulkRxError;      // error message if frame rejected (NULL if none)
+
+
 bool  GetCommandLine(char *buffer, uint8_t maxlen)
 {
 	static uint8_t  index;  // index into buffer[] - saved across calls
@@ -875,6 +2229,8 @@ void  ServicePortRoutine()
 	uint8_t  argCount;     // Number of cmd "arguments" incl. cmdName
 	uint8_t  cmdLineLength = strlen(cmdLine);
 
+  if (m_BulkLoadActive)  { BulkLoadService();  return; }  // binary input, not commands
+
   if (GetCommandLine(cmdLine, CMD_LINE_MAX_LEN))  // TRUE => have complete command 
   {
     cmdName[0] = 0;  // clear cmd string
@@ -896,10 +2252,17 @@ void  ServicePortRoutine()
       if (strMatch(cmdName, "help"))  HelpCommand();
       else if (strMatch(cmdName, "patch"))  PatchCommand();
       else if (strMatch(cmdName, "save"))  SaveCommand();
+      else if (strMatch(cmdName, "cpu"))  CpuLoadCommand();
+      else if (strMatch(cmdName, "midi"))  MidiStatsCommand();
+      else if (strMatch(cmdName, "voices"))  VoiceStatusCommand();
+      else if (strMatch(cmdName, "tasks"))  TaskStatsCommand();
+      else if (strMatch(cmdName, "latency"))  LatencyCommand();
+      else if (strMatch(cmdName, "dump"))  DumpCommand();
+      else if (strMatch(cmdName, "load"))  LoadCommand();
 	  else if (strMatch(cmdName, "sysinfo"))  SysInfoCommand();  // Hidden cmd!
       else  Serial.println("! Undefined command !");
     }
-    Serial.print("\r\n> ");  // prompt
+    if (!m_BulkLoadActive)  Serial.print("\r\n> ");  // prompt (after load, if any)
   }
 }
 
@@ -910,6 +2273,13 @@ void  HelpCommand()
   Serial.println("``````````````");
   Serial.println("help     | Show available commands ");
   Serial.println("patch    | List active patch param's ");
+  Serial.println("cpu  [reset]  | List voice audio ISR load stats (reset min/max) ");
+  Serial.println("midi [reset]  | Show MIDI IN/OUT message stats (reset counts) ");
+  Serial.println("voices   | List voice status (as last reported to allocator) ");
+  Serial.println("tasks [reset] | List main loop task run time stats (reset stats) ");
+  Serial.println("latency [reset] | List Note-On latency histograms (reset histograms) ");
+  Serial.println("dump     | Send config + User Presets as binary frame (librarian) ");
+  Serial.println("load     | Receive config + User Presets as binary frame ");
   Serial.println("save  <fav#>  [name]   | Save active patch as Fav. Preset");
   Serial.println("... where <fav#> = Fav. Preset number (1..8) ");
   Serial.println("    and name (optional) = 20 chars max. (no spaces) ");
@@ -942,6 +2312,517 @@ void  SaveCommand()
 }
 
 
+// Query each voice module for audio ISR load statistics.  Replies are listed on arrival
+// by VoiceReplyService(), which also sends the queries, one voice at a time.
+//
+void  CpuLoadCommand()
+{
+  g_VoiceQueryType = SYSEX_ISR_STATS_QUERY;
+  g_VoiceQueryFlags = strMatch(argStr1, "reset") ? 1 : 0;
+  Serial.println("Voice\tISR cycles per sample\tCPU load\tSynthProcess\tOverruns\tRate\tMIDI IN");
+  Serial.println("     \tMin   Avg   Max  (period)\t(%)\t\t(max. us)\t\t(kHz)\t(overruns)");
+  uint8_t  voice = VoiceNextPresent(-1);  // start query at first voice present
+
+  if (voice != VOICE_NONE)  g_VoiceQuery = voice + 1;
+  else  Serial.println("  -- no voices present --");
+}
+
+
+/*
+ * Binary bulk dump/load of the configuration param's and the 8 User Presets, for a
+ * librarian application on the PC.  The data is transferred in one frame as follows:
+ *
+ *   "S6B" <version> <config size> <patch size> <preset count> <ConfigParams_t>
+ *         <PatchParamTable_t x 8> <CRC-16 Hi> <CRC-16 Lo>
+ *
+ * The sizes are in bytes;  the data is binary, as stored in the EEPROM (little-endian).
+ * The CRC is CRC-16/CCITT (poly 0x1021, initial value 0xFFFF) of all bytes preceding it.
+ *
+ * Command 'dump' sends the frame following the command echo (CR+LF), then the prompt.
+ * Command 'load' receives the frame, sent after the command line (CR);  the reply is a
+ * message line ("Load OK" or "! Load error: ...") then the prompt.  A frame which has a
+ * wrong header, size or CRC, or a check word not matching this firmware, is rejected.
+ * Data is written via the EEPROM RAM image (write-behind), as by the Store functions.
+ */
+void  DumpCommand()
+{
+  uint8_t   header[BULK_HEADER_SIZE] = { 'S', '6', 'B', BULK_FORMAT_VERSION,
+            sizeof(ConfigParams_t), sizeof(PatchParamTable_t), BULK_PRESET_COUNT };
+  uint16_t  crc = 0xFFFF;
+  uint8_t   fav;
+
+  if (g_EEpromFaulty)  { Serial.println("! EEPROM error or not fitted");  return; }
+
+  Serial.write(header, BULK_HEADER_SIZE);
+  crc = Crc16Update(crc, header, BULK_HEADER_SIZE);
+  Serial.write(&m_EEpromImage[0], sizeof(ConfigParams_t));
+  crc = Crc16Update(crc, &m_EEpromImage[0], sizeof(ConfigParams_t));
+
+  for (fav = 0;  fav < BULK_PRESET_COUNT;  fav++)
+  {
+    Serial.write(&m_EEpromImage[USER_PRESET_ADDR(fav)], sizeof(PatchParamTable_t));
+    crc = Crc16Update(crc, &m_EEpromImage[USER_PRESET_ADDR(fav)], sizeof(PatchParamTable_t));
+  }
+  Serial.write((uint8_t)(crc >> 8));
+  Serial.write((uint8_t)(crc & 0xFF));
+}
+
+
+void  LoadCommand()
+{
+  if (g_EEpromFaulty)  { Serial.println("! EEPROM error or not fitted");  return; }
+
+  m_BulkRxCount = 0;
+  m_BulkRxError = NULL;
+  m_BulkRxTime = millis();
+  m_BulkLoadActive = TRUE;
+}
+
+
+/*
+ * Function:     Receive a bulk load frame on the CLI port -- all bytes available per call
+ *               (called by ServicePortRoutine while a load is in progress).  The header is
+ *               checked as soon as it is received;  if it is wrong, the rest of the frame
+ *               is discarded.  The load ends when the frame is complete, or when no byte
+ *               has been received for BULK_RX_TIMEOUT_MS.  A LF before the frame is
+ *               skipped, because the "load" command line may be terminated by CR+LF.
+ */
+void  BulkLoadService()
+{
+  uint8_t   header[BULK_HEADER_SIZE] = { 'S', '6', 'B', BULK_FORMAT_VERSION,
+            sizeof(ConfigParams_t), sizeof(PatchParamTable_t), BULK_PRESET_COUNT };
+  uint16_t  crc;
+  uint8_t   rxb;
+
+  while (Serial.available())
+  {
+    rxb = Serial.read();
+    m_BulkRxTime = millis();
+    if (m_BulkRxError != NULL)  continue;  // discard rest of frame
+
+    if (m_BulkRxCount == 0 && rxb == '\n')  continue;  // LF after "load" CR (CRLF)
+
+    m_BulkRxBuffer[m_BulkRxCount++] = rxb;
+    if (m_BulkRxCount == BULK_HEADER_SIZE
+    &&  memcmp(m_BulkRxBuffer, header, BULK_HEADER_SIZE) != 0)
+      m_BulkRxError = "wrong header (format or data size)";
+    else if (m_BulkRxCount == BULK_FRAME_SIZE)  break;
+  }
+
+  if (m_BulkRxError == NULL && m_BulkRxCount == BULK_FRAME_SIZE)
+  {
+    crc = Crc16Update(0xFFFF, m_BulkRxBuffer, BULK_FRAME_SIZE - 2);
+    if (m_BulkRxBuffer[BULK_FRAME_SIZE - 2] != (crc >> 8)
+    ||  m_BulkRxBuffer[BULK_FRAME_SIZE - 1] != (crc & 0xFF))
+      m_BulkRxError = "CRC mismatch";
+    else  m_BulkRxError = BulkLoadApply();
+    if (m_BulkRxError == NULL)  Serial.println("Load OK");
+  }
+  else if ((millis() - m_BulkRxTime) >= BULK_RX_TIMEOUT_MS)  // frame ended
+  {
+    if (m_BulkRxError == NULL)  m_BulkRxError = "time-out (frame incomplete)";
+  }
+  else  return;  // frame not yet complete
+
+  if (m_BulkRxError != NULL)
+  {
+    Serial.print("! Load error: ");
+    Serial.println(m_BulkRxError);
+  }
+  m_BulkLoadActive = FALSE;
+  Serial.print("\r\n> ");  // prompt
+}
+
+
+// Copy the config param's and User Presets from a valid bulk load frame into the EEPROM
+// RAM image and g_Config.  The new config is applied to the display, MIDI IN mode and the
+// voices.  The active patch is not changed.  Returns an error message, or NULL if OK;
+// if the config or any User Preset is rejected (see BulkConfigCheck, BulkPatchCheck),
+// nothing is changed.
+//
+const char  *BulkLoadApply()
+{
+  uint8_t   *pData = &m_BulkRxBuffer[BULK_HEADER_SIZE];
+  ConfigParams_t  config;
+  PatchParamTable_t  patch;
+  const char  *error;
+  uint8_t   fav;
+
+  // The frame data is not word-aligned, so the config and patches are copied to be checked
+  memcpy(&config, pData, sizeof(ConfigParams_t));
+  error = BulkConfigCheck(&config);
+  if (error != NULL)  return  error;
+
+  for (fav = 0;  fav < BULK_PRESET_COUNT;  fav++)
+  {
+    memcpy(&patch, pData + sizeof(ConfigParams_t) + fav * sizeof(PatchParamTable_t),
+           sizeof(PatchParamTable_t));
+    error = BulkPatchCheck(&patch);
+    if (error != NULL)  return  error;
+  }
+
+  memcpy(&g_Config, &config, sizeof(ConfigParams_t));
+  StoreConfigData();
+  pData += sizeof(ConfigParams_t);
+
+  for (fav = 0;  fav < BULK_PRESET_COUNT;  fav++)
+  {
+    EEpromImageUpdate(USER_PRESET_ADDR(fav), pData, sizeof(PatchParamTable_t));
+    pData += sizeof(PatchParamTable_t);
+  }
+
+  if (g_DisplayEnabled)  SSD1309_SetContrast(g_Config.DisplayBrightness);
+  if (g_Config.MidiChannel == 0)  g_MidiMode = OMNI_ON;
+  else  g_MidiMode = OMNI_OFF;
+  if (g_VoicesInitialized)  VoiceConfigure(BROADCAST);
+  return  NULL;
+}
+
+
+// Check the config param's in a bulk load frame:  the check word must match and every
+// field must be within the range allowed by the UI and MIDI settings.
+// Returns an error message, or NULL if OK.
+//
+const char  *BulkConfigCheck(ConfigParams_t *pConfig)
+{
+  uint8_t  n;
+
+  if (pConfig->EEpromCheckWord != g_Config.EEpromCheckWord)  return  "config check word mismatch";
+  if (pConfig->MidiChannel > 16)  return  "config MidiChannel out of range";
+  if (pConfig->PitchBendEnable > 1)  return  "config PitchBendEnable out of range";
+  if (pConfig->PitchBendRange > 12)  return  "config PitchBendRange out of range";
+  if (pConfig->ReverbMix_pc > 100)  return  "config ReverbMix_pc out of range";
+  if (pConfig->PresetLastSelected >= g_NumberOfPresets)
+    return  "config PresetLastSelected out of range";
+  if (pConfig->MasterTuneOffset > 127)  return  "config MasterTuneOffset out of range";
+  if (pConfig->DisplayBrightness < 5 || pConfig->DisplayBrightness > 100)
+    return  "config DisplayBrightness out of range";
+  for (n = 0;  n < 16;  n++)
+  {
+    if (pConfig->VoiceTuning[n] > 127)  return  "config VoiceTuning out of range";
+  }
+  for (n = 0;  n < 8;  n++)
+  {
+    if (pConfig->UserPresetBase[n] >= g_NumberOfPresets)
+      return  "config UserPresetBase out of range";
+  }
+  return  NULL;
+}
+
+
+// Check a User Preset in a bulk load frame:  the name must be NUL-terminated and every
+// patch param must be within the range a voice module accepts (see PatchParamsValid()
+// in the voice firmware), i.e. the range allowed by the panel UI, the patch CC messages
+// and the preset table.  Returns an error message, or NULL if OK.
+//
+const char  *BulkPatchCheck(PatchParamTable_t *patch)
+{
+  uint8_t  osc;
+
+  if (memchr(patch->PresetName, 0, sizeof(patch->PresetName)) == NULL)
+    return  "preset name not terminated";
+  for (osc = 0;  osc < 6;  osc++)
+  {
+    if (patch->OscFreqMult[osc] >= 12)  return  "preset OscFreqMult out of range";
+    if (patch->OscAmpldModSource[osc] >= 10)  return  "preset OscAmpldModSource out of range";
+    if (patch->OscDetune[osc] < -600 || patch->OscDetune[osc] > 600)
+      return  "preset OscDetune out of range";
+    if (patch->MixerInputStep[osc] > 16)  return  "preset MixerInputStep out of range";
+  }
+  if (patch->EnvAttackTime < 5 || patch->EnvAttackTime > 10000)
+    return  "preset EnvAttackTime out of range";
+  if (patch->EnvHoldTime > 10000)  return  "preset EnvHoldTime out of range";
+  if (patch->EnvDecayTime < 5 || patch->EnvDecayTime > 10000)
+    return  "preset EnvDecayTime out of range";
+  if (patch->EnvSustainLevel > 100)  return  "preset EnvSustainLevel out of range";
+  if (patch->EnvReleaseTime < 5 || patch->EnvReleaseTime > 10000)
+    return  "preset EnvReleaseTime out of range";
+  if (patch->AmpControlMode >= 4)  return  "preset AmpControlMode out of range";
+  if (patch->ContourStartLevel > 100)  return  "preset ContourStartLevel out of range";
+  if (patch->ContourDelayTime > 10000)  return  "preset ContourDelayTime out of range";
+  if (patch->ContourRampTime < 5 || patch->ContourRampTime > 10000)
+    return  "preset ContourRampTime out of range";
+  if (patch->ContourHoldLevel > 100)  return  "preset ContourHoldLevel out of range";
+  if (patch->Env2DecayTime < 5 || patch->Env2DecayTime > 10000)
+    return  "preset Env2DecayTime out of range";
+  if (patch->Env2SustainLevel > 100)  return  "preset Env2SustainLevel out of range";
+  if (patch->LFO_Freq_x10 < 5 || patch->LFO_Freq_x10 > 500)
+    return  "preset LFO_Freq_x10 out of range";
+  if (patch->LFO_RampTime > 10000)  return  "preset LFO_RampTime out of range";
+  if (patch->LFO_FM_Depth > 600)  return  "preset LFO_FM_Depth out of range";
+  if (patch->LFO_AM_Depth > 100)  return  "preset LFO_AM_Depth out of range";
+  if (patch->MixerOutGain_x10 > 127)  return  "preset MixerOutGain_x10 out of range";
+  if (patch->LimiterLevelPc > 95)  return  "preset LimiterLevelPc out of range";
+  return  NULL;
+}
+
+
+// CRC-16/CCITT (poly 0x1021, MSB first) -- returns the CRC updated with nbytes of data.
+//
+uint16_t  Crc16Update(uint16_t crc, uint8_t *pData, uint16_t nbytes)
+{
+  uint8_t  bit;
+
+  while (nbytes--)
+  {
+    crc ^= (uint16_t) *pData++ << 8;
+    for (bit = 0;  bit < 8;  bit++)
+    {
+      if (crc & 0x8000)  crc = (crc << 1) ^ 0x1021;
+      else  crc = crc << 1;
+    }
+  }
+  return  crc;
+}
+
+
+/*
+ * Note latency trace (NOTE_LATENCY_TRACE):  List the master histogram, i.e. Note-On
+ * arrival (MIDI IN) to the last byte written to the voice bus UART, and the fixed time
+ * to transfer a Note-On (3 bytes) on the voice bus;  then query each voice module for
+ * its histograms:  receipt to envelope trigger, trigger to first audible sample, and
+ * receipt to first audible sample.  Voice replies are listed on arrival by
+ * VoiceReplyService(), which sends the queries, one voice and stage at a time.
+ */
+void  LatencyCommand()
+{
+#if NOTE_LATENCY_TRACE
+  LatencyHist_t  hist;
+  char     textBuf[80];
+  uint8_t  bin;
+  uint8_t  voice;
+
+  noInterrupts();  // histogram is updated by MidiTransmit() in SysTick hook
+  memcpy(&hist, &m_LatencyHist, sizeof(hist));
+  if (strMatch(argStr1, "reset"))  memset(&m_LatencyHist, 0, sizeof(m_LatencyHist));
+  interrupts();
+
+  Serial.println("Voice\tStage\t\tNotes\tMean\tMax\t<32\t<64\t<128\t<256\t<512\t<1k\t<2k\t>=2k");
+  Serial.println("     \t     \t\t\t(us)\t(us)\t(number of notes in range, us)");
+  sprintf(textBuf, "  M\tArrive-Send\t%d\t%d\t%d", (int) hist.Count,
+          (int)((hist.Count != 0) ? (hist.Total_us / hist.Count) : 0), (int) hist.Max_us);
+  Serial.print(textBuf);
+  for (bin = 0;  bin < LATENCY_HIST_BINS;  bin++)
+  {
+    sprintf(textBuf, "\t%d", (int) hist.Bin[bin]);
+    Serial.print(textBuf);
+  }
+  Serial.println();
+  sprintf(textBuf, "  -\tVoice bus\t\t%d\t\t(Note-On transfer time, fixed)",
+          (int)(30000000 / VOICE_BUS_RATE));  // 3 bytes x 10 bits
+  Serial.println(textBuf);
+
+  g_VoiceQueryType = SYSEX_LATENCY_QUERY;
+  g_VoiceQueryFlags = strMatch(argStr1, "reset") ? 1 : 0;  // stage 0 first
+  voice = VoiceNextPresent(-1);  // start query at first voice present
+
+  if (voice != VOICE_NONE)  g_VoiceQuery = voice + 1;
+  else  Serial.println("  -- no voices present --");
+#else
+  Serial.println("! Note latency trace not in build (NOTE_LATENCY_TRACE)");
+#endif
+}
+
+
+// Add a time interval (us) to a latency histogram.  Bin n holds intervals less than
+// LATENCY_BIN0_US x 2^n;  the last bin holds all longer intervals.
+//
+void  LatencyHistAdd(LatencyHist_t *pHist, uint32_t time_us)
+{
+  uint32_t  t = time_us / LATENCY_BIN0_US;
+  uint8_t   bin = 0;
+
+  while (t != 0 && bin < LATENCY_HIST_BINS - 1)  { t >>= 1;  bin++; }
+
+  if (pHist->Bin[bin] < 0xFFFF)  pHist->Bin[bin]++;
+  pHist->Count++;
+  pHist->Total_us += time_us;
+  if (time_us > pHist->Max_us)  pHist->Max_us = time_us;
+}
+
+
+// Note-On sent to the voice bus UART (TX buffer) -- record the time since its arrival,
+// unless the note is not traced (stamp = 0).  Called by MidiTransmit() only, so the
+// stamp queue and histogram have one writer.
+//
+void  LatencyTraceSent()
+{
+  uint32_t  stamp;
+
+  m_MidiTxNoteOn = FALSE;
+  if (m_TraceStampTail == m_TraceStampHead)  return;  // no stamp (not expected)
+
+  stamp = m_TraceStamp[m_TraceStampTail & (TRACE_STAMP_QUEUE_SIZE - 1)];
+  m_TraceStampTail++;
+  if (stamp != 0)  LatencyHistAdd(&m_LatencyHist, TimeStamp_us() - stamp);
+}
+
+
+/*
+ * Function:     List a voice module note latency histogram on the CLI (one line):
+ *               Voice# | stage | notes | mean us | max us | notes in each bin
+ *
+ * Entry args:   voice = voice channel number (1..16)
+ *               pData = pointer to data in LATENCY_REPLY message:  <stage> <count>
+ *                       <mean> <max> (3 bytes each) <bin 0..7> (2 bytes each)
+ */
+void  ListVoiceLatency(uint8_t voice, uint8_t *pData)
+{
+  static const char *stageName[] = { "Rx-Trigger", "Trigger-Audio", "Rx-Audio" };
+  char     textBuf[80];
+  uint8_t  stage = pData[0];
+  uint8_t  bin;
+
+  sprintf(textBuf, "  %d\t%-13s\t%d\t%d\t%d", (int) voice,
+          (stage < LATENCY_STAGES) ? stageName[stage] : "?",
+          (int) SysExGetValue(&pData[1], 3), (int) SysExGetValue(&pData[4], 3),
+          (int) SysExGetValue(&pData[7], 3));
+  Serial.print(textBuf);
+  for (bin = 0;  bin < LATENCY_HIST_BINS;  bin++)
+  {
+    sprintf(textBuf, "\t%d", (int) SysExGetValue(&pData[10 + bin * 2], 2));
+    Serial.print(textBuf);
+  }
+  Serial.println();
+}
+
+
+// Show MIDI IN statistics:  messages received, overruns (messages lost) and max. latency,
+// i.e. time from message arrival (SysTick parser) to processing in the main loop;  also
+// the number of controller messages superseded in the cache (not sent to voices), and
+// MIDI OUT bytes sent and status bytes saved by running status.
+//
+void  MidiStatsCommand()
+{
+  char  textBuf[80];
+
+  sprintf(textBuf, "MIDI IN messages: %d,  Overruns: %d,  Max. latency: %d us",
+          (int) g_MidiRxMsgCount, (int) g_MidiRxOverruns, (int) g_MidiRxLatencyMax);
+  Serial.println(textBuf);
+#if USB_MIDI_INPUT
+  sprintf(textBuf, "MIDI IN messages from USB-MIDI: %d", (int) g_MidiUsbMsgCount);
+  Serial.println(textBuf);
+#endif
+  sprintf(textBuf, "Controller msgs coalesced: %d,  Voice steals: %d",
+          (int) g_CtrlCoalesced, (int) g_VoiceSteals);
+  Serial.println(textBuf);
+  sprintf(textBuf, "MIDI OUT bytes: %d,  Status bytes omitted (running status): %d",
+          (int) g_MidiTxBytes, (int) g_MidiTxStatusSaved);
+  Serial.println(textBuf);
+  sprintf(textBuf, "EEPROM pages written: %d,  Write errors: %d,  Pending: %s",
+          (int) g_EEpromPageWrites, (int) g_EEpromErrors, m_EEpromDirty ? "Yes" : "No");
+  Serial.println(textBuf);
+  if (strMatch(argStr1, "reset"))
+  {
+    g_MidiTxBytes = 0;
+    g_MidiTxStatusSaved = 0;
+    g_CtrlCoalesced = 0;
+    g_VoiceSteals = 0;
+    g_MidiRxMsgCount = 0;
+    g_MidiUsbMsgCount = 0;
+    g_MidiRxOverruns = 0;
+    g_MidiRxLatencyMax = 0;
+  }
+}
+
+
+// List main loop task run time statistics (see TaskRun):  priority, period, deadline,
+// run count, average and max. run time, max. latency (start after due) and the number
+// of missed deadlines.  Times in microseconds.
+//
+void  TaskStatsCommand()
+{
+  char     textBuf[100];
+  uint8_t  task;
+  MainLoopTask_t  *pTask;
+
+  Serial.println("Task		Prio	Period	Deadline	Runs		Avg	Max	Latency	Missed");
+  Serial.println("    			(ms)	(us)				(us)	(us)	(us)");
+  for (task = 0;  task < TASK_COUNT;  task++)
+  {
+    pTask = &m_Task[task];
+    sprintf(textBuf, "%-12s	%d	%d	%-8d	%-10d	%d	%d	%d	%d", pTask->Name,
+            (int) pTask->Priority, (int) pTask->Period_ms, (int) pTask->Deadline_us,
+            (int) pTask->RunCount,
+            (int)((pTask->RunCount != 0) ? (pTask->TotalTime / pTask->RunCount) : 0),
+            (int) pTask->MaxTime, (int) pTask->MaxLatency, (int) pTask->Misses);
+    Serial.println(textBuf);
+  }
+  if (strMatch(argStr1, "reset"))  TaskStatsReset();
+}
+
+
+// List voice status as last reported in reply to the status poll (see VoiceReplyService):
+// gate (note assigned by master), note, ENV1 phase and level, output level, ISR load and
+// age of the report.
+//
+void  VoiceStatusCommand()
+{
+  static const char *phaseName[] = { "Idle", "Attack", "Hold", "Decay", "Sustain", "Release" };
+  VoiceStatus_t  *pStatus;
+  char     textBuf[80];
+  uint8_t  voice;
+
+  sprintf(textBuf, "Voices present: %d%s,  drop-outs: %d", (int) g_NumberOfVoices,
+          m_VoicesAssumed ? " (assumed)" : "", (int) g_VoiceDropOuts);
+  Serial.println(textBuf);
+  Serial.println("Voice\tGate\tNote\tENV1 phase\tENV1\tOutput\tLoad(%)\tAge(ms)");
+  for (voice = 0;  voice < MAX_VOICES;  voice++)
+  {
+    if (!m_VoicePresent[voice] && m_VoiceStatus[voice].TimeRcvd == 0)  continue;
+    pStatus = &m_VoiceStatus[voice];
+    if (pStatus->TimeRcvd == 0)
+    {
+      sprintf(textBuf, "  %d\t-- no status --", (int)(voice + 1));
+      Serial.println(textBuf);
+      continue;
+    }
+    sprintf(textBuf, "  %d\t%s\t%d\t%-8s\t%d\t%d\t%d\t%d", (int)(voice + 1),
+            !m_VoicePresent[voice] ? "(out)" : (g_channelStatus[voice] == GATE_OFF) ? "Off" : "On",
+            (int) pStatus->NotePlaying,
+            (pStatus->Env1Phase <= 5) ? phaseName[pStatus->Env1Phase] : "?",
+            (int) pStatus->Env1Level, (int) pStatus->OutputLevel, (int) pStatus->LoadPc,
+            (int)(millis() - pStatus->TimeRcvd));
+    Serial.println(textBuf);
+  }
+}
+
+
+/*
+ * Function:     List voice module audio ISR stats on the CLI (one line) as follows:
+ *               Voice# ISR cycles (min, avg, max, period) | load % | SynthProcess us | overruns
+ *               | sample rate kHz | MIDI IN overruns (if sent by voice)
+ *
+ * Entry args:   voice = voice channel number (1..16)
+ *               pData = pointer to data in ISR_STATS_REPLY message (7 values, 8 with MIDI IN)
+ *               dataLength = number of data bytes in message (20, or 23 with MIDI IN stats)
+ */
+void  ListVoiceIsrStats(uint8_t voice, uint8_t *pData, short dataLength)
+{
+  char  textBuf[100];
+  uint32_t  cyclesMin = SysExGetValue(&pData[0], 3);
+  uint32_t  cyclesAvg = SysExGetValue(&pData[3], 3);
+  uint32_t  cyclesMax = SysExGetValue(&pData[6], 3);
+  uint32_t  load_x10 = SysExGetValue(&pData[9], 2);
+  uint32_t  synthProcMax = SysExGetValue(&pData[11], 3);
+  uint32_t  overruns = SysExGetValue(&pData[14], 3);
+  uint32_t  sampleRate = SysExGetValue(&pData[17], 3);
+  uint32_t  period = (sampleRate != 0) ? (F_CPU / sampleRate) : 0;
+
+  sprintf(textBuf, "  %d\t%-5d %-5d %-5d (%d)\t%d.%d\t\t%d\t\t%d\t\t%d",
+          (int) voice, (int) cyclesMin, (int) cyclesAvg, (int) cyclesMax, (int) period,
+          (int)(load_x10 / 10), (int)(load_x10 % 10), (int)(synthProcMax / (F_CPU / 1000000)),
+          (int) overruns, (int)(sampleRate / 1000));
+  Serial.print(textBuf);
+  if (dataLength >= 23)  // voice firmware v1.6+ appends MIDI IN overrun count
+  {
+    sprintf(textBuf, "\t%d", (int) SysExGetValue(&pData[20], 3));
+    Serial.print(textBuf);
+  }
+  Serial.println();
+}
+
+
 void  SysInfoCommand()  // Hidden
 {
   static uint16_t *SYSCTRL_XOSC32K = (uint16_t *)0x40000814;  // register address	
@@ -19,6 +19,12 @@ typedef unsigned char  bitmap_t;
 #define SSD1309_I2C_ADDRESS  0x3D  // (pin SA0 tied High)
 */
 
+// Build option:  TRUE => text in 8 pixel fonts at a Y-coord which is a multiple of 8 is
+// written to a page-format buffer using pre-converted glyphs (see Disp_PutChar8());
+// FALSE => all text is rendered into the (row-major) screen buffer, as other graphics.
+//
+#define OLED_FAST_TEXT  TRUE
+
 // Rendering modes for display write functions...
 #define CLEAR_PIXELS    0
 #define SET_PIXELS      1
@@ -57,6 +63,7 @@ enum  Graphics_character_fonts
 #define Disp_GetMaxY()       (63)
 
 void     Disp_ClearScreen(void);              // Clear OLED GDRAM and MCU RAM buffer
+bool     Disp_FlushService(void);             // Write next chunk of changes to GDRAM
 void     Disp_Mode(uint8_t mode);             // Set pixel write mode (set, clear, flip)
 void     Disp_PosXY(uint16_t x, uint16_t y);  // Set graphics cursor position (x, y)
 uint16_t Disp_GetX(void);                     // Return cursor x-coord
@@ -92,7 +99,7 @@ void  SSD1309_WriteData(uint8_t data);
 bool  SSD1309_Init();  // returns TRUE if SSD1309 responds
 void  SSD1309_SetContrast(uint8_t level_pc);  // %
 void  SSD1309_ClearGDRAM();
-void  SSD1309_WriteBlock(uint16_t *scnBuf, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void  SSD1309_SetAddress(uint8_t page, uint8_t segAddr);  // GDRAM write address
 void  SSD1309_Test_Pattern();
 
 #define OLED_Display_Init()    SSD1309_Init()    
@@ -126,6 +133,7 @@ void  SSD1309_Test_Pattern();
 #define SSD1309_EXTERNALVCC 0x01
 #define SSD1309_SWITCHCAPVCC 0x02
 #define SSD1309_MESSAGETYPE_COMMAND 0x80
+#define SSD1309_MESSAGETYPE_COMMAND_STREAM 0x00
 #define SSD1309_MESSAGETYPE_DATA 0x40
 #define SSD1309_READMODIFYWRITE_START 0xE0
 #define SSD1309_READMODIFYWRITE_END 0xEE
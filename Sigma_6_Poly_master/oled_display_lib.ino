@@ -12,11 +12,17 @@
 */
 #include <Wire.h> 
 #include "oled_display_lib.h"
+#include "oled_font_pages.h"
 
 // "Private" functions -- not meant to be called directly from the application
 void  Disp_PutChar8(uint8_t uc);
 void  Disp_PutChar12(uint8_t uc);
 void  Disp_PutChar16(uint8_t uc);
+void  Disp_MarkDirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void  Disp_CellToSegments(uint8_t page, uint8_t col, uint8_t *pSeg);
+void  Disp_SegmentsToCell(uint8_t page, uint8_t col, const uint8_t *pSeg);
+void  Disp_CellsToRows(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void  Disp_PutGlyphPage(const uint8_t *pColumn, uint8_t width);
 
 /*```````````````````````````````````````````````````````````````````````````````````````
     Font definition -- 5 x 8 pixels -- MONO-SPACED;  96 ASCII characters
@@ -255,6 +261,17 @@ const  uint8_t  font_table_prop_5x8[] =
   0x05, 0xA8, 0x50, 0xA8, 0x50, 0xA8, 0x50, 0xA8    // del
 };
 
+#if OLED_FAST_TEXT
+// The 5 x 8 fonts above in GDRAM page format -- generated at compile-time, see file
+// "oled_font_pages.h".  Table entry:  font_pages_xxx.v[(uc - 32) * 6 + column]
+//
+constexpr ConstTable<uint8_t, GLYPH_PAGE_CHARS * GLYPH_PAGE_COLUMNS>  font_pages_mono_5x8 =
+    MonoGlyphPagesGen(MakeIndexSeq<GLYPH_PAGE_CHARS * GLYPH_PAGE_COLUMNS>::type(), font_table_mono_5x8);
+
+constexpr ConstTable<uint8_t, GLYPH_PAGE_CHARS * GLYPH_PAGE_COLUMNS>  font_pages_prop_5x8 =
+    PropGlyphPagesGen(MakeIndexSeq<GLYPH_PAGE_CHARS * GLYPH_PAGE_COLUMNS>::type(), font_table_prop_5x8);
+#endif
+
 
 /*`````````````````````````````````````````````````````````````````````````````````````````````````
   |    Font definition -- 10 x 14 pixels -- Decimal digits 0 ~ 9 only.
@@ -472,6 +489,21 @@ const  uint8_t  font_table_prop_7x12[] =
 // Display buffer:  64 rows x 8 cols x 16 bits (1 bit/pixel)
 static  uint16_t screenBuffer[64][8];
 
+// Cells of the screen buffer changed, but not yet written to the OLED controller GDRAM.
+// A cell is 16 x 8 pixels:  one column-word (col) of the 8 rows in a GDRAM page.
+#define FLUSH_CELLS_PER_CALL  2     // cells (16 bytes each) sent per IIC transaction
+static  uint8_t  DirtyCells[8];    // bit N set => cell at column N of page to be written
+static  uint8_t  FlushPage = 0xFF; // page of run of cells being written (0xFF: none)
+static  uint8_t  FlushCol;         // next cell (column) of run to be written
+static  uint8_t  FlushEndCol;      // last cell (column) of run
+
+#if OLED_FAST_TEXT
+// A cell written by Disp_PutGlyphPage() is held in the page buffer, in GDRAM format, until
+// it is drawn on by a (row-major) graphics function, which converts it back to rows.
+static  uint8_t  pageBuffer[8][128];  // 8 pages x 128 segment bytes (bit 0 at the top)
+static  uint8_t  PageCells[8];        // bit N set => cell at column N of page is in pageBuffer
+#endif
+
 static  uint8_t  PixelMode;     // Pixel writing mode (see Disp_SetMode())
 static  uint16_t CursorPosX;    // screen cursor position, X-coord
 static  uint16_t CursorPosY;    // screen cursor position, Y-coord
@@ -487,6 +519,7 @@ static  uint8_t  NotBoldCharList[] = { '"', '#', 39, ',', '.', ':', ';', '@' };
   |  Name         :  Disp_ClearScreen()
   |  Function     :  Clear OLED module GDRAM and MCU screen buffer.
   |                  Position graphics cursor at upper LHS = (0, 0).
+  |                  The GDRAM is cleared in the background (see Disp_FlushService).
   |  Input        :  --
   |  Return       :  --
   +-----------------------------------------------------------------------------------*/
@@ -500,7 +533,17 @@ void  Disp_ClearScreen(void)
     *pBuf++ = 0;
   }
 
-  SSD1309_ClearGDRAM();
+  for (wordcount = 0;  wordcount < 8;  wordcount++)  // GDRAM to be cleared (all cells)
+  {
+    DirtyCells[wordcount] = 0xFF;
+  }
+  FlushPage = 0xFF;  // re-start from top of screen
+#if OLED_FAST_TEXT
+  for (wordcount = 0;  wordcount < 8;  wordcount++)  // screen buffer holds all cells
+  {
+    PageCells[wordcount] = 0;
+  }
+#endif
 
   PixelMode = SET_PIXELS;
   FontSize = 8;
@@ -586,6 +629,9 @@ void  Disp_BlockFill(uint16_t w, uint16_t h)
 
   if (x > 127)  x = 0;            // prevent writing past end-of-row
   if ((x + w) > 128) w = 128 - x;
+#if OLED_FAST_TEXT
+  Disp_CellsToRows(x, y, w, h);
+#endif
 
   firstCol = x / 16;
   lastCol = (x + w - 1) / 16;
@@ -643,8 +689,8 @@ void  Disp_BlockFill(uint16_t w, uint16_t h)
     }
   }
 
-  // Update OLED module -- write block (w x h) pixels of screen buffer at (x, y) to GDRAM
-  SSD1309_WriteBlock((uint16_t *) screenBuffer, x, y, w, h);
+  // Update OLED module -- block (w x h) pixels at (x, y) to be written to GDRAM
+  Disp_MarkDirty(x, y, w, h);
 }
 
 /*----------------------------------------------------------------------------------
@@ -705,6 +751,9 @@ uint8_t  Disp_PutImage(uint8_t *imageData, uint16_t w, uint16_t h)
 
   if (x > 127)  x = 0;            // prevent writing past end-of-row
   if ((x + w) > 128) w = 128 - x;
+#if OLED_FAST_TEXT
+  Disp_CellsToRows(x, y, w, h);
+#endif
 
   firstCol = x / 16;
   lastCol = (x + w - 1) / 16;
@@ -765,8 +814,8 @@ uint8_t  Disp_PutImage(uint8_t *imageData, uint16_t w, uint16_t h)
     }
   }
 
-  // Update OLED module -- write block (w x h) pixels of screen buffer at (x, y) to GDRAM
-  SSD1309_WriteBlock((uint16_t *) screenBuffer, x, y, w, h);
+  // Update OLED module -- block (w x h) pixels at (x, y) to be written to GDRAM
+  Disp_MarkDirty(x, y, w, h);
 
   return  collision;
 }
@@ -1022,6 +1071,10 @@ void  DrawBox(short w, short h)
   |                  at current cursor position.
   |                  On return, CursorPosX is advanced (6 pixels if mono-spaced)
   |
+  |                  If OLED_FAST_TEXT is TRUE and the Y-coord is a multiple of 8, the
+  |                  char is written in page format from the pre-converted glyph table;
+  |                  the result is the same as the bitmap image path (any pixel mode).
+  |
   |  Input        :  uint8_t uc = ASCII char code
   |  Return       :  --
 */
@@ -1035,6 +1088,23 @@ void  Disp_PutChar8(uint8_t uc)
 
   if (uc < 32) return;  // non-printable
 
+#if OLED_FAST_TEXT
+  if ((CursorPosY % 8) == 0 && CursorPosY < 64 && CursorPosX < 128 && uc < 128)
+  {
+    if (FontProp)
+    {
+      Disp_PutGlyphPage(&font_pages_prop_5x8.v[(uc - 32) * GLYPH_PAGE_COLUMNS], 5);
+      CursorPosX += (font_table_prop_5x8[(uc - 32) * 8] & 0x0F) + 1;
+    }
+    else
+    {
+      Disp_PutGlyphPage(&font_pages_mono_5x8.v[(uc - 32) * GLYPH_PAGE_COLUMNS], 6);
+      CursorPosX += 6;
+    }
+    return;
+  }
+#endif
+
   if (FontProp)  // proportional width font
   {
     pData = (uint8_t *) &font_table_prop_5x8[(uc - 32) * 8];  // use prop'l table!
@@ -1217,6 +1287,248 @@ void   Disp_PutChar16(uint8_t uc)
 }
 
 
+/*----------------------------------------------------------------------------------
+  |  Name         :  Disp_MarkDirty()
+  |  Function     :  Mark the cells of the screen buffer overlapping a block of pixels
+  |                  as changed, to be written to the OLED controller GDRAM.
+  |  Input        :  x, y = pixel coords of upper LHS of block;  w, h = width, height
+  |  Return       :  --
+  +----------------------------------------------------------------------------------*/
+void  Disp_MarkDirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  uint8_t  page, firstPage, lastPage;
+  uint8_t  cellMask;
+
+  if (w == 0 || h == 0 || x > 127 || y > 63)  return;
+  if ((x + w) > 128)  w = 128 - x;
+  if ((y + h) > 64)  h = 64 - y;
+
+  firstPage = y / 8;
+  lastPage = (y + h - 1) / 8;
+  // cells (columns) x / 16 to (x + w - 1) / 16 inclusive
+  cellMask = (uint8_t)((2 << ((x + w - 1) / 16)) - (1 << (x / 16)));
+
+  for (page = firstPage;  page <= lastPage;  page++)
+  {
+    DirtyCells[page] |= cellMask;
+  }
+}
+
+
+/*----------------------------------------------------------------------------------
+  |  Name         :  Disp_FlushService()
+  |
+  |  Function     :  Write changed cells of the screen buffer to the OLED controller
+  |                  GDRAM, a little at a time, so the main loop is not held up for long.
+  |                  Adjacent changed cells in a page are merged into a run, for which
+  |                  the GDRAM address is set once;  each call then writes up to
+  |                  FLUSH_CELLS_PER_CALL cells of the run in one IIC transaction
+  |                  (about 0.8ms at 400kHz).  A cell changed again after it was written
+  |                  is written again in a later run.
+  |
+  |  Usage      :  Call frequently from the main loop (background task).
+  |
+  |  Return     :  TRUE if all changes have been written, else FALSE
+  +----------------------------------------------------------------------------------*/
+bool  Disp_FlushService(void)
+{
+  uint8_t  segData[FLUSH_CELLS_PER_CALL * 16];
+  uint8_t  page, col, count;
+
+  if (FlushPage == 0xFF)  // find next run of changed cells
+  {
+    for (page = 0;  page < 8;  page++)
+    {
+      if (DirtyCells[page] != 0)  break;
+    }
+    if (page == 8)  return TRUE;  // all done
+
+    for (col = 0;  (DirtyCells[page] & (1 << col)) == 0;  col++)  { ; }
+    FlushCol = col;
+    while (col < 7 && (DirtyCells[page] & (2 << col)))  col++;
+    FlushEndCol = col;
+    DirtyCells[page] &= ~((2 << FlushEndCol) - (1 << FlushCol));
+    FlushPage = page;
+    SSD1309_SetAddress(page, FlushCol * 16);
+  }
+
+  for (count = 0;  count < FLUSH_CELLS_PER_CALL && FlushCol <= FlushEndCol;  count++)
+  {
+#if OLED_FAST_TEXT
+    if (PageCells[FlushPage] & (1 << FlushCol))  // already in GDRAM format
+    {
+      memcpy(&segData[count * 16], &pageBuffer[FlushPage][FlushCol * 16], 16);
+      FlushCol++;
+      continue;
+    }
+#endif
+    Disp_CellToSegments(FlushPage, FlushCol++, &segData[count * 16]);
+  }
+  Wire.beginTransmission(SSD1309_I2C_ADDRESS);
+  Wire.write(SSD1309_MESSAGETYPE_DATA);
+  Wire.write(segData, count * 16);  // segment address auto increments
+  Wire.endTransmission();
+
+  if (FlushCol > FlushEndCol)  FlushPage = 0xFF;  // run done
+  return  FALSE;
+}
+
+
+/*----------------------------------------------------------------------------------
+  |  Name         :  Disp_CellToSegments()
+  |
+  |  Function     :  Transpose a cell of 16 (H) x 8 (V) pixels in the screen buffer
+  |                  into 16 GDRAM segment bytes (8 pixels vertical, bit 0 at the top).
+  |                  Each half of the cell (8 x 8 pixels) is transposed as a bit matrix
+  |                  held in two 32-bit words, by swapping bit-fields of 1, 2 and 4 bits,
+  |                  instead of one pixel at a time.
+  |
+  |  Input        :  page = GDRAM page (0..7);  col = column-word in row (0..7)
+  |                  pSeg = pointer to 16 bytes for segment data (left to right)
+  |  Return       :  --
+  +----------------------------------------------------------------------------------*/
+void  Disp_CellToSegments(uint8_t page, uint8_t col, uint8_t *pSeg)
+{
+  uint16_t  *pRow = &screenBuffer[page * 8][col];  // top row of cell;  8 words per row
+  uint32_t  x, y, t;
+  int       shift;
+
+  for (shift = 8;  shift >= 0;  shift -= 8)  // left half (MS byte), then right half
+  {
+    // rows 7..4 in x, rows 3..0 in y (bottom row in MS byte)
+    x = ((uint32_t)(uint8_t)(pRow[56] >> shift) << 24) | ((uint32_t)(uint8_t)(pRow[48] >> shift) << 16)
+      | ((uint32_t)(uint8_t)(pRow[40] >> shift) << 8) | (uint8_t)(pRow[32] >> shift);
+    y = ((uint32_t)(uint8_t)(pRow[24] >> shift) << 24) | ((uint32_t)(uint8_t)(pRow[16] >> shift) << 16)
+      | ((uint32_t)(uint8_t)(pRow[8] >> shift) << 8) | (uint8_t)(pRow[0] >> shift);
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;   x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;   y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;  x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;  y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    *pSeg++ = (uint8_t)(x >> 24);  *pSeg++ = (uint8_t)(x >> 16);
+    *pSeg++ = (uint8_t)(x >> 8);   *pSeg++ = (uint8_t) x;
+    *pSeg++ = (uint8_t)(y >> 24);  *pSeg++ = (uint8_t)(y >> 16);
+    *pSeg++ = (uint8_t)(y >> 8);   *pSeg++ = (uint8_t) y;
+  }
+}
+
+
+#if OLED_FAST_TEXT
+/*----------------------------------------------------------------------------------
+  |  Name         :  Disp_SegmentsToCell()
+  |
+  |  Function     :  Inverse of Disp_CellToSegments() -- transpose 16 GDRAM segment
+  |                  bytes into a cell of 16 (H) x 8 (V) pixels in the screen buffer.
+  |                  The same bit-field swaps apply, with the order of the 8 bytes
+  |                  reversed on input and output.
+  |
+  |  Input        :  page = GDRAM page (0..7);  col = column-word in row (0..7)
+  |                  pSeg = pointer to 16 bytes of segment data (left to right)
+  |  Return       :  --
+  +----------------------------------------------------------------------------------*/
+void  Disp_SegmentsToCell(uint8_t page, uint8_t col, const uint8_t *pSeg)
+{
+  uint16_t  *pRow = &screenBuffer[page * 8][col];  // top row of cell;  8 words per row
+  uint32_t  x, y, t;
+  int       i, shift;
+
+  for (i = 0;  i < 8;  i++)  pRow[i * 8] = 0;
+
+  for (shift = 8;  shift >= 0;  (shift -= 8, pSeg += 8))  // left half, then right half
+  {
+    x = ((uint32_t) pSeg[0] << 24) | ((uint32_t) pSeg[1] << 16) | ((uint32_t) pSeg[2] << 8) | pSeg[3];
+    y = ((uint32_t) pSeg[4] << 24) | ((uint32_t) pSeg[5] << 16) | ((uint32_t) pSeg[6] << 8) | pSeg[7];
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA;   x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;   y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;  x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;  y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    // rows 7..4 from x, rows 3..0 from y (bottom row in MS byte)
+    pRow[56] |= (uint16_t)(uint8_t)(x >> 24) << shift;  pRow[48] |= (uint16_t)(uint8_t)(x >> 16) << shift;
+    pRow[40] |= (uint16_t)(uint8_t)(x >> 8) << shift;   pRow[32] |= (uint16_t)(uint8_t) x << shift;
+    pRow[24] |= (uint16_t)(uint8_t)(y >> 24) << shift;  pRow[16] |= (uint16_t)(uint8_t)(y >> 16) << shift;
+    pRow[8] |= (uint16_t)(uint8_t)(y >> 8) << shift;    pRow[0] |= (uint16_t)(uint8_t) y << shift;
+  }
+}
+
+
+/*----------------------------------------------------------------------------------
+  |  Name         :  Disp_CellsToRows()
+  |  Function     :  Convert the cells overlapping a block of pixels which are held in
+  |                  the page buffer back into the screen buffer (row format), before
+  |                  the block is drawn by a row-major graphics function.
+  |  Input        :  x, y = pixel coords of upper LHS of block;  w, h = width, height
+  |  Return       :  --
+  +----------------------------------------------------------------------------------*/
+void  Disp_CellsToRows(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  uint8_t  page, col, cellMask;
+
+  if (w == 0 || h == 0 || x > 127 || y > 63)  return;
+  if ((x + w) > 128)  w = 128 - x;
+  if ((y + h) > 64)  h = 64 - y;
+
+  cellMask = (uint8_t)((2 << ((x + w - 1) / 16)) - (1 << (x / 16)));
+
+  for (page = y / 8;  page <= (y + h - 1) / 8;  page++)
+  {
+    if ((PageCells[page] & cellMask) == 0)  continue;
+
+    for (col = x / 16;  col <= (x + w - 1) / 16;  col++)
+    {
+      if (PageCells[page] & (1 << col))
+        Disp_SegmentsToCell(page, col, &pageBuffer[page][col * 16]);
+    }
+    PageCells[page] &= ~cellMask;
+  }
+}
+
+
+/*----------------------------------------------------------------------------------
+  |  Name         :  Disp_PutGlyphPage()
+  |  Function     :  Write a char glyph of page-format column bytes into the page at
+  |                  the cursor position (y = multiple of 8), using the current pixel
+  |                  write mode.  Cells not yet in the page buffer are transposed into
+  |                  it first.  Cursor position is not affected.
+  |  Input        :  pColumn = pointer to column bytes of glyph (LHS first)
+  |                  width = glyph image width (pixels), max. GLYPH_PAGE_COLUMNS
+  |  Return       :  --
+  +----------------------------------------------------------------------------------*/
+void  Disp_PutGlyphPage(const uint8_t *pColumn, uint8_t width)
+{
+  uint8_t  page = CursorPosY / 8;
+  uint8_t  x, col, bits;
+
+  if ((CursorPosX + width) > 128)  width = 128 - CursorPosX;
+
+  for (x = CursorPosX;  x < (CursorPosX + width);  x++)
+  {
+    col = x / 16;
+    if ((PageCells[page] & (1 << col)) == 0)  // cell is in the screen buffer
+    {
+      Disp_CellToSegments(page, col, &pageBuffer[page][col * 16]);
+      PageCells[page] |= (1 << col);
+    }
+    bits = *pColumn++;
+
+    if (PixelMode == SET_PIXELS) pageBuffer[page][x] |= bits;
+    else if (PixelMode == CLEAR_PIXELS) pageBuffer[page][x] &= ~bits;
+    else  pageBuffer[page][x] ^= bits;  // FLIP_PIXELS
+  }
+
+  Disp_MarkDirty(CursorPosX, CursorPosY, width, 8);
+}
+#endif // OLED_FAST_TEXT
+
+
 //===============  SSD1309 OLED CONTROLLER DRIVER FUNCTIONS (IIC)  ==================
 
 /*----------------------------------------------------------------------------------
@@ -1254,7 +1566,8 @@ void  SSD1309_WriteData(uint8_t data)
   |  Function     :  Initialize SSD1309 controller.
   |  Input        :  --
   |  Returns      :  TRUE if SSD1309 device responds wth ACK, else FALSE
-  |  Note         :  SSD1309 GDRAM not cleared
+  |  Note         :  SSD1309 GDRAM is cleared, including segments not written by the
+  |                  display functions (128..131).
 */
 bool  SSD1309_Init(void)
 {
@@ -1287,6 +1600,7 @@ bool  SSD1309_Init(void)
   SSD1309_WriteCommand(SSD1309_DISPLAYALLON_RESUME);   // 0xA4
   SSD1309_WriteCommand(SSD1309_NORMALDISPLAY);         // 0xA6
   SSD1309_WriteCommand(SSD1309_DISPLAYON);             // 0xAF
+  SSD1309_ClearGDRAM();
   
   return  TRUE;
 }
@@ -1358,92 +1672,21 @@ void  SSD1309_ClearGDRAM(void)
 
 
 /*----------------------------------------------------------------------------------
-  |  Function   :  SSD1309_WriteBlock()
-  |
-  |  Overview   :  Copies a rectangular block of pixels from an external screen
-  |                buffer in MCU RAM to the SSD1309 controller GDRAM (graphics data RAM).
-  |                In general, the GDRAM memory format differs from the MCU RAM screen
-  |                buffer, so a transformation of some sort needs to be performed.
-  |                The screen buffer format is optimized for speed in display functions.
-  |
-  |  Input:        scnBuf = address of screen buffer in MCU RAM
-  |                x, y = pixel coords of upper LHS of block to be copied
-  |                w, h = width and height (pixels) of block to be copied
-  |
-  |  Return     :  --
-  |
-  |  Notes:     :  The (external) screen buffer is formatted as 8 "columns" horizonally
-  |                by 64 "rows" vertically. Each column has 16 pixels. The leftmost
-  |                pixel is stored in the MS bit (bit15) of the column.
-  |                See also: Disp_PutImage().
-  +------------------------------------------------------------------------------------*/
-void  SSD1309_WriteBlock(uint16_t *scnBuf, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  |  Name         :  SSD1309_SetAddress()
+  |  Function     :  Set SSD1309 GDRAM page and segment address for data write.
+  |                  The 3 commands are sent in one IIC transaction (command stream).
+  |                  The segment address auto-increments as data is written.
+  |  Input        :  page = GDRAM page (0..7);  segAddr = segment address (0..131)
+  |  Return       :  --
+*/
+void  SSD1309_SetAddress(uint8_t page, uint8_t segAddr)
 {
-  uint8_t   page;                   // page address in SSD1309 (1 page = 8 rows)
-  uint8_t   x_coord;                // pixel horizontal coordinate
-  int       row, col;               // row and column word index for screen buffer
-  int       firstPage;              // first (top) page to be modified
-  int       lastPage;               // last (bottom) page to be modified
-  int       firstCol;               // first (leftmost) column in a row to be modified
-  int       lastCol;                // last (rightmost) column in a row to be modified
-  int       offset;                 // address offset of pixel word in scnBuf
-  uint8_t   segAddr;                // segment address for write
-  uint8_t   pixels;                 // 8 pixels aligned vertically (LS bit at top)
-  uint8_t   bitmask;
-  uint16_t  pixelWord[8];           // 8 rows x 16 pixels in a "column" to be modified
-  uint16_t  *pBuf;
-
-  if (y > 63)  y = 0;               // prevent writing past end-of-screen (vert.)
-  if ((y + h) > 63)  h = 63 - y;
-
-  if (x > 127)  x = 0;              // prevent writing past end-of-row (horiz.)
-  if ((x + w) > 128)  w = 128 - x;
-
-  firstPage = y / 8;
-  lastPage = (y + h - 1) / 8;
-
-  firstCol = x / 16;
-  lastCol = (x + w - 1) / 16;
-
-  for (page = firstPage;  page <= lastPage;  page++)
-  {
-    SSD1309_WriteCommand(SSD1309_PAGEADDR | page);   // set page address (0..7)
-
-    for (col = firstCol;  col <= lastCol && col < 8;  col++)
-    {
-      // Grab a bunch of 16 (H) x 8 (V) pixels from buffer...
-      offset = page * 64 + col;  // 64 words per buffer "page"
-      pBuf = scnBuf + offset;
-      for (row = 0;  row < 8;  row++)  // 8 rows in SSD1309 page
-      {
-        pixelWord[row] = *pBuf;
-        pBuf += 8;  // next row (advance 8 col's)
-      }
-
-      segAddr = col * 16;
-      SSD1309_WriteCommand(SSD1309_SETCOLUMNADDRLOW + (segAddr & 0xF));
-      SSD1309_WriteCommand(SSD1309_SETCOLUMNADDRHIGH + (segAddr >> 4));
-      // Write bunch of pixels, 16 (H) x 8 (V) to SSD1309 controller
-      Wire.beginTransmission(SSD1309_I2C_ADDRESS);
-      Wire.write(SSD1309_MESSAGETYPE_DATA);
-
-      for (x_coord = 0;  x_coord < 16;  x_coord++)
-      {
-        // transpose horiz pixels in pixelWord[8] to vertical pixelByte
-        pixels = 0;
-        bitmask = 0x01;
-        for (row = 0;  row < 8;  row++)
-        {
-          if (pixelWord[row] & 0x8000) pixels |= bitmask;
-          bitmask = bitmask << 1;   // next pixel down
-          pixelWord[row] = pixelWord[row] << 1;  // next pixel right
-        }
-        // write 8 pixels (vertical) to SSD1309 controller
-        Wire.write(pixels);  // segment address auto increments
-      }
-      Wire.endTransmission();
-    }
-  }
+  Wire.beginTransmission(SSD1309_I2C_ADDRESS);
+  Wire.write(SSD1309_MESSAGETYPE_COMMAND_STREAM);
+  Wire.write(SSD1309_PAGEADDR | page);
+  Wire.write(SSD1309_SETCOLUMNADDRLOW + (segAddr & 0xF));
+  Wire.write(SSD1309_SETCOLUMNADDRHIGH + (segAddr >> 4));
+  Wire.endTransmission();
 }
 
 
@@ -0,0 +1,107 @@
+/**
+ *   File:    oled_font_pages.h
+ *
+ *   Compile-time generated page-major glyph tables for the 5 x 8 pixel fonts:
+ *   ````````````````````````````````````````````````````````````````````````
+ *   Each character of font_table_mono_5x8[] and font_table_prop_5x8[] is converted into
+ *   6 column bytes in the SSD1309 GDRAM page format (8 pixels vertical, bit 0 at the top),
+ *   so text at a Y-coord which is a multiple of 8 can be written straight into the page
+ *   buffer, without transposing rows of pixels.  See Disp_PutChar8().
+ *
+ *   The tables are computed by the compiler (C++11 constexpr functions) from the font
+ *   tables in oled_display_lib.ino, so only one copy of each font is maintained.
+ *   Special cases of the proportional font (descender shift, bottom row of 'j', '[', etc)
+ *   are applied here exactly as in the (slow path) code of Disp_PutChar8().
+ *
+ *   This file is to be included by oled_display_lib.ino only.
+ */
+#ifndef OLED_FONT_PAGES_H
+#define OLED_FONT_PAGES_H
+
+#define GLYPH_PAGE_COLUMNS     6     // column bytes per char (image width, mono font)
+#define GLYPH_PAGE_CHARS      96     // ASCII chars 32..127
+
+// ConstTable and the IndexSeq templates are taken from m0_synth_tables.h (voice firmware,
+// built from a separate sketch folder) -- see the comments there.
+//
+template <typename T, unsigned N>
+struct  ConstTable
+{
+  T  v[N];
+};
+
+template <unsigned... I>  struct  IndexSeq  { };
+
+template <class A, class B>  struct  IndexSeqJoin;
+
+template <unsigned... I, unsigned... J>
+struct  IndexSeqJoin< IndexSeq<I...>, IndexSeq<J...> >
+{
+  typedef  IndexSeq< I..., (sizeof...(I) + J)... >  type;
+};
+
+template <unsigned N>
+struct  MakeIndexSeq
+{
+  typedef  typename IndexSeqJoin< typename MakeIndexSeq<N / 2>::type,
+                                  typename MakeIndexSeq<N - N / 2>::type >::type  type;
+};
+
+template <>  struct  MakeIndexSeq<0>  { typedef  IndexSeq<>  type; };
+template <>  struct  MakeIndexSeq<1>  { typedef  IndexSeq<0>  type; };
+
+
+// Row r (0..7) of the mono-spaced char at table offset c (= ASCII code - 32).
+//
+constexpr uint8_t  MonoGlyphRow(const uint8_t *font, unsigned c, unsigned r)
+{
+  return  font[c * 8 + r];
+}
+
+// Row r (0..7) of the proportional char at table offset c, as rendered by Disp_PutChar8():
+// byte[0] of the table entry is the width and descender flag;  rows are in byte[1:7].
+//
+constexpr uint8_t  PropGlyphRowSpecial(unsigned c, uint8_t row)
+{
+  return  (c + 32 == 'j') ? 0x80 : (c + 32 == '[') ? 0xC0 : (c + 32 == ']') ? 0x60
+        : (c + 32 == '{') ? 0x30 : (c + 32 == '}') ? 0xC0 : row;
+}
+
+constexpr uint8_t  PropGlyphRow(const uint8_t *font, unsigned c, unsigned r)
+{
+  return  (font[c * 8] & 0x80) ?  // descender -- shift down a row
+            ((r == 0) ? 0x00 : (r == 7) ? PropGlyphRowSpecial(c, font[c * 8 + 7]) : font[c * 8 + r])
+          : ((r == 7) ? PropGlyphRowSpecial(c, 0x00) : font[c * 8 + r + 1]);
+}
+
+// Column byte k (0..5) of a char:  bit r = pixel in row r;  row bit 7 is the LHS pixel.
+// The proportional font image is 5 pixels wide (as in Disp_PutChar8), so column 5 is blank.
+//
+constexpr uint8_t  MonoGlyphColumn(const uint8_t *font, unsigned c, unsigned k, unsigned r)
+{
+  return  (r > 7) ? 0 : (((MonoGlyphRow(font, c, r) >> (7 - k)) & 1) << r)
+                        | MonoGlyphColumn(font, c, k, r + 1);
+}
+
+constexpr uint8_t  PropGlyphColumn(const uint8_t *font, unsigned c, unsigned k, unsigned r)
+{
+  return  (r > 7 || k > 4) ? 0 : (((PropGlyphRow(font, c, r) >> (7 - k)) & 1) << r)
+                        | PropGlyphColumn(font, c, k, r + 1);
+}
+
+// Table entry i = (ASCII code - 32) x GLYPH_PAGE_COLUMNS + column
+//
+template <unsigned... I>
+constexpr ConstTable<uint8_t, sizeof...(I)>  MonoGlyphPagesGen(IndexSeq<I...>, const uint8_t *font)
+{
+  return  {{ MonoGlyphColumn(font, I / GLYPH_PAGE_COLUMNS, I % GLYPH_PAGE_COLUMNS, 0)... }};
+}
+
+template <unsigned... I>
+constexpr ConstTable<uint8_t, sizeof...(I)>  PropGlyphPagesGen(IndexSeq<I...>, const uint8_t *font)
+{
+  return  {{ PropGlyphColumn(font, I / GLYPH_PAGE_COLUMNS, I % GLYPH_PAGE_COLUMNS, 0)... }};
+}
+
+
+#endif // OLED_FONT_PAGES_H
@@ -246,6 +246,157 @@ static long  aveDataEntryPotReading;  // Data Entry pot reading filtered [24:8 f
 static long  aveSliderPotReading[6];  // Slider Pot readings filtered [24:8 fixed-pt]
 static long  aveLFOfreqPotReading;    // LFO FREQ Pot reading filtered [24:8 fixed-pt]
 static long  aveLFOdepthPotReading;   // LFO DEPTH Pot reading filtered [24:8 fixed-pt]
+
+// Pot index (0..8) in the scan sequence;  slider pots are 0..5
+#define POT_LFO_FREQ      6
+#define POT_LFO_DEPTH     7
+#define POT_DATA_ENTRY    8
+#define POT_COUNT         9
+
+static long *const  potFilterBuffer[POT_COUNT] =
+{
+  &aveSliderPotReading[0], &aveSliderPotReading[1], &aveSliderPotReading[2],
+  &aveSliderPotReading[3], &aveSliderPotReading[4], &aveSliderPotReading[5],
+  &aveLFOfreqPotReading, &aveLFOdepthPotReading, &aveDataEntryPotReading
+};
+static long      potLastMoved[POT_COUNT];  // reading when pot last moved (see PotMovedCheck)
+static uint16_t  potMovedFlags;            // bit N set => pot N moved, not yet reported
+
+#if POT_ADC_BACKGROUND
+static const uint8_t  potPin[POT_COUNT] = { A0, A1, A2, A3, A4, A5, A8, A9, A11 };
+static uint8_t   potAdcChannel[POT_COUNT];  // ADC input (AINx) of each pot pin
+volatile uint16_t  v_PotAdcResult[POT_COUNT];  // latest ADC result (12 bits) per pot
+volatile uint8_t   v_PotScanIndex;          // pot being converted
+volatile uint32_t  v_PotScanCount;          // number of complete scans
+
+#define ADC_SYNC()  while (ADC->STATUS.bit.SYNCBUSY)  { ; }
+
+/*
+ * Function:  PotScanInit()
+ *
+ * Overview:  Sets up the ADC to scan the 9 pot inputs in the background:  each pot is
+ *            converted with hardware averaging (8 samples, 12-bit result), then the
+ *            ADC interrupt (ADC_Handler) stores the result, selects the next input and
+ *            starts the next conversion.  A scan of all pots takes about 1.3ms (150us
+ *            per pot), so each pot is sampled 7 times as often as before (every 9ms), and
+ *            the main loop never waits for the ADC.  Results are filtered by PotService().
+ *
+ *            The SAMD21 ADC input scan (INPUTSCAN) covers consecutive AIN inputs only;
+ *            the pot pins are not consecutive, hence the interrupt selects each input.
+ *
+ * Called by: setup(), after analogReadResolution() -- analogRead() is not used.
+ */
+void  PotScanInit()
+{
+  uint8_t  pot;
+
+  for (pot = 0;  pot < POT_COUNT;  pot++)
+  {
+    pinPeripheral(potPin[pot], PIO_ANALOG);
+    potAdcChannel[pot] = g_APinDescription[potPin[pot]].ulADCChannelNumber;
+  }
+
+  ADC->CTRLA.bit.ENABLE = 0;
+  ADC_SYNC();
+  ADC->REFCTRL.reg = ADC_REFCTRL_REFSEL_INTVCC1;  // VDDANA / 2 (with gain 1/2 = VDDANA)
+  ADC->CTRLB.reg = ADC_CTRLB_PRESCALER_DIV64 | ADC_CTRLB_RESSEL_16BIT;  // 750kHz, averaging
+  ADC_SYNC();
+  ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM_8 | ADC_AVGCTRL_ADJRES(3);  // sum / 8 = 12 bits
+  ADC->SAMPCTRL.reg = 15;  // sampling time 8 ADC clocks (10.7us) to suit pot impedance
+  ADC->INPUTCTRL.reg = ADC_INPUTCTRL_GAIN_DIV2 | ADC_INPUTCTRL_MUXNEG_GND
+                     | ADC_INPUTCTRL_MUXPOS(potAdcChannel[0]);
+  ADC_SYNC();
+  v_PotScanIndex = 0;
+
+  ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY;
+  ADC->INTENSET.reg = ADC_INTENSET_RESRDY;
+  NVIC_SetPriority(ADC_IRQn, 3);  // lowest priority
+  NVIC_EnableIRQ(ADC_IRQn);
+
+  ADC->CTRLA.bit.ENABLE = 1;
+  ADC_SYNC();
+  ADC->SWTRIG.bit.START = 1;  // first conversion
+}
+
+// ADC interrupt:  averaged result ready -- store it, then start conversion of next pot.
+//
+void  ADC_Handler()
+{
+  uint8_t  pot = v_PotScanIndex;
+
+  v_PotAdcResult[pot] = ADC->RESULT.reg;  // clears RESRDY flag
+  if (++pot >= POT_COUNT)
+  {
+    pot = 0;
+    v_PotScanCount++;
+  }
+  v_PotScanIndex = pot;
+  ADC->INPUTCTRL.bit.MUXPOS = potAdcChannel[pot];
+  ADC_SYNC();
+  ADC->SWTRIG.bit.START = 1;
+}
+#endif // POT_ADC_BACKGROUND
+
+
+/*
+ * Function:  PotMovedCheck()
+ *
+ * Overview:  Sets the "moved" flag of a pot if its filtered reading has changed by more
+ *            than 2% since the reading at which the flag was last set (20/1024 -> 2%).
+ *            The flag is cleared when reported, by DataPotMoved(), SliderPotMoved(), etc.
+ *
+ * Entry arg: pot = pot index (0..8)
+ */
+void  PotMovedCheck(uint8_t pot)
+{
+  if (labs(*potFilterBuffer[pot] - potLastMoved[pot]) > (20 << 8))
+  {
+    potLastMoved[pot] = *potFilterBuffer[pot];
+    potMovedFlags |= (1 << pot);
+  }
+}
+
+// Return the "moved" flag of a pot and clear it
+//
+bool  PotMovedReport(uint8_t pot)
+{
+  bool  result = (potMovedFlags & (1 << pot)) != 0;
+
+  potMovedFlags &= ~(1 << pot);
+  return result;
+}
+
+
+#if POT_ADC_BACKGROUND
+/*
+ * Overview:  Service Routine for front-panel data-entry pot and other control pots.
+ *            Non-blocking "task" called at 1ms intervals from main loop.
+ *
+ * Detail:    When a new scan of the pots is complete (see PotScanInit), each reading
+ *            is converted from 12 bits to fixed-point format (24:8 bits);  range 0.0 ~
+ *            1023.99, as before, and filtered by a 1st-order IIR filter (K = 0.5).
+ *            The current pot position can be read by a call to function DataPotPosition().
+ *            Similar functions return positions of Slider pots and LFO control knobs.
+ */
+void  PotService()
+{
+  static uint32_t  lastScanCount;
+  long     potReading;
+  uint8_t  pot;
+
+  if (v_PotScanCount == lastScanCount)  return;  // no new readings
+  lastScanCount = v_PotScanCount;
+
+  for (pot = 0;  pot < POT_COUNT;  pot++)
+  {
+    potReading = (long) v_PotAdcResult[pot] << 6;  // convert to fixed-point (24:8 bits)
+    *potFilterBuffer[pot] -= (*potFilterBuffer[pot] >> 1);
+    *potFilterBuffer[pot] += (potReading >> 1);
+    PotMovedCheck(pot);
+  }
+}
+
+#else  // read one pot per call, using analogRead()
 /*
  *
  * Overview:  Service Routine for front-panel data-entry pot and other control pots.
@@ -299,8 +450,10 @@ void  PotService()
     aveDataEntryPotReading -= (aveDataEntryPotReading >> 1);
     aveDataEntryPotReading += (potReading >> 1);
   }
+  PotMovedCheck(call);
   if (++call >= 9)  call = 0;  // repeat ADC read sequence
 }
+#endif // POT_ADC_BACKGROUND
 
 /*
  * Overview:  Returns TRUE if the pot position has changed by more than 2% since a
@@ -310,15 +463,7 @@ void  PotService()
  */
 bool  DataPotMoved()
 {
-  static long  lastReading;
-  bool result = FALSE;
-
-  if (labs(aveDataEntryPotReading - lastReading) > (20 << 8))
-  {
-    result = TRUE;
-    lastReading = aveDataEntryPotReading;
-  }
-  return result;
+  return  PotMovedReport(POT_DATA_ENTRY);
 }
 
 /*
@@ -344,15 +489,7 @@ uint8_t  DataPotPosition()
  */
 bool  SliderPotMoved(uint8_t potid)
 {
-  static long  lastReading[6];
-  bool result = FALSE;
-
-  if (abs(aveSliderPotReading[potid] - lastReading[potid]) > (20 << 8))
-  {
-    result = TRUE;
-    lastReading[potid] = aveSliderPotReading[potid];
-  }
-  return result;
+  return  PotMovedReport(potid);
 }
 
 /*
@@ -372,15 +509,7 @@ uint8_t  SliderPosition(uint8_t potid)
  */
 bool  LFOFreqPotMoved()
 {
-  static long  lastReading;
-  bool result = FALSE;
-
-  if (labs(aveLFOfreqPotReading - lastReading) > (20 << 8))
-  {
-    result = TRUE;
-    lastReading = aveLFOfreqPotReading;
-  }
-  return result;
+  return  PotMovedReport(POT_LFO_FREQ);
 }
 
 /*
@@ -400,15 +529,7 @@ uint8_t  LFOFreqPotPosition()
  */
 bool  LFODepthPotMoved()
 {
-  static long  lastReading;
-  bool result = FALSE;
-
-  if (labs(aveLFOdepthPotReading - lastReading) > (20 << 8))
-  {
-    result = TRUE;
-    lastReading = aveLFOdepthPotReading;
-  }
-  return result;
+  return  PotMovedReport(POT_LFO_DEPTH);
 }
 
 /*
@@ -588,7 +709,7 @@ void  UserState_StartupScreen()
     Disp_PosXY(4, 40);  // info line 3
     Disp_PutText("Voices: ");
     Disp_SetFont(MONO_8_NORM);
-    Disp_PutDecimal(NUMBER_OF_VOICES, 1);
+    Disp_PutDecimal(g_NumberOfVoices, 1);
     Disp_SetFont(PROP_8_NORM);
     Disp_PutText(",  Presets: ");
     Disp_SetFont(MONO_8_NORM);
@@ -1417,7 +1538,9 @@ void  UserState_SetVoiceTuning()
   }
   if (ButtonHit('C'))  // Next voice -- last setting not saved
   {
-    if (++voice >= NUMBER_OF_VOICES) voice = 0;
+    voice = VoiceNextPresent(voice);
+    if (voice == VOICE_NONE) voice = VoiceNextPresent(-1);  // wrap to first voice
+    if (voice == VOICE_NONE) voice = 0;  // no voice present
     setting = g_Config.VoiceTuning[voice] - 64;  // +/-64
     g_VoiceUnderTest = voice;
     doRefresh = TRUE;
@@ -9,7 +9,7 @@
  *
  * Licence:    Open Source (Unlicensed) -- free to copy, distribute, modify
  *
- * Version:    1.5  25-OCT-2025  (See Revision History file)
+ * Version:    1.6  14-OCT-2026  (See Revision History file)
  */
 #include <fast_samd21_tc3.h>
 #include <Wire.h>
@@ -27,6 +27,18 @@ ConfigParams_t  g_Config;      // structure holding config param's
 uint8_t  g_MidiChannel;        // 1..16  (16 = broadcast, omni)
 uint8_t  g_MidiMode;           // OMNI_ON_MONO or OMNI_OFF_MONO
 uint8_t  g_MidiRegisParam;     // Registered Param # (0: PB range, 1: Fine Tuning)
+uint32_t g_MidiRxOverruns;     // MIDI IN messages lost (queue or UART buffer full)
+
+static MidiRxMessage_t  m_MidiRxQueue[MIDI_RX_QUEUE_SIZE];  // MIDI IN message queue
+static volatile uint8_t  v_MidiRxHead;  // queue write index (MidiReceive)
+static volatile uint8_t  v_MidiRxTail;  // queue read index (MidiInputService)
+static volatile bool     v_MidiRxBusy;  // MidiReceive() running in background task
+static volatile bool     v_SysTickHookActive;  // sysTickHook() running (see TimeStamp_us)
+static uint8_t  m_SysExRxBuffer[SYSEX_RX_MAX_LENGTH];  // SysEx msg too long for queue
+static volatile bool     v_SysExRxPending;  // m_SysExRxBuffer holds msg not processed
+static uint32_t  m_StatusReplyTime;     // time (us) to send status reply (voice 0)
+static uint8_t   m_StatusReplyDue;      // status replies scheduled (bit n = voice n)
+static uint32_t  m_MidiRxMsgTime;       // arrival time-stamp of message being processed
 
 //---------------------------------------------------------------------------------------
 //
@@ -55,16 +67,25 @@ void  setup()
   if (channelSwitches == 0)  g_MidiMode = OMNI_ON_MONO;
   else  g_MidiMode = OMNI_OFF_MONO;
 
-  Serial1.begin(31250);        // initialize UART for MIDI IN
+  Serial1.begin(MIDI_BAUD_RATE);  // initialize UART for MIDI IN
+#if VOICE_BUS_FAST
+  MidiRxPollStart();           // drain UART RX every MIDI_RX_POLL_US (TC4 ISR)
+#endif
   Wire.begin();                // initialize IIC as master
   Wire.setClock(400*1000);     // set IIC clock to 400kHz
   analogReadResolution(10);    // set ADC resolution to 10 bits
   DefaultConfigData();         // Sigma-6 Poly Voice has NO EEPROM!
+  SynthInit();                 // SPI (DAC) and wave-table set-up, once only
   PresetSelect(13);            // initialize synth engine!
 
+#if USE_DMA_AUDIO_OUTPUT
+  SynthAudioStartDMA();        // audio output by DMA, block-based
+#else
   // Set wave-table sampling interval for audio ISR - Timer/Counter #3
-  fast_samd21_tc3_configure((float) 1000000 / SAMPLE_RATE_HZ);  // period = 31.25us
+  fast_samd21_tc3_configure((float) 1000000 / g_SampleRate);  // 31.25us @ 32kHz
   fast_samd21_tc3_start();
+#endif
+  SynthBenchmarkAudio();       // measure audio ISR load for sample rate selection
 }
 
 // Main background process loop...
@@ -75,6 +96,8 @@ void  loop()
 
   MidiInputService();
 
+  VoiceStatusService();  // reply slot timed in us -- every pass
+
   if (millis() != last_millis)  // once every millisecond...
   {
     last_millis = millis();
@@ -84,8 +107,9 @@ void  loop()
 
 
 /*`````````````````````````````````````````````````````````````````````````````````````````````````
- * Function:     Copy patch parameters from a specified preset patch in flash
- *               program memory to the "active" patch parameter array in data memory.
+ * Function:     Load patch parameters from a specified preset patch in flash program memory
+ *               into the "active" patch parameter array in data memory.  If the synth is
+ *               running, the patch is swapped in without a glitch (see SynthPatchLoad).
  *
  * Entry args:   preset = index into preset-patch definitions array g_PresetPatch[]
  *
@@ -94,20 +118,197 @@ void  PresetSelect(uint8_t preset)
 {
   if (preset < GetNumberOfPresets())
   {
-    memcpy(&g_Patch, &g_PresetPatch[preset], sizeof(PatchParamTable_t));
-    SynthPrepare();
+    SynthPatchLoad(&g_PresetPatch[preset]);
     g_Config.PresetLastSelected = preset;
 //  StoreConfigData();  // Sigma-6 Poly Voice has NO EEPROM!
   }
 }
 
 
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  sysTickHook()
+ *
+ * Called by the Arduino core SysTick interrupt handler every 1ms, before the millis()
+ * counter is updated.  MIDI IN bytes buffered by the Serial1 (UART RX interrupt) driver are
+ * parsed into the MIDI IN message queue, so that no byte is lost and each message is
+ * time-stamped within 1ms of its arrival, however long the main loop is delayed.
+ * (The millis() count is not yet advanced here, so micros() reads 1ms early;  time-stamps
+ * are taken by TimeStamp_us(), which corrects for this.)
+ *
+ * Return val:   0  => continue with the default SysTick handler
+ */
+int  sysTickHook(void)
+{
+  v_SysTickHookActive = TRUE;
+  if (!v_MidiRxBusy)  MidiReceive();  // not already running in background task
+  v_SysTickHookActive = FALSE;
+  return  0;
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  TimeStamp_us()
+ *
+ * Return the time (us) for a time-stamp, i.e. micros() corrected for sysTickHook():
+ * the hook runs after the SysTick pending flag is cleared and before the ms count is
+ * advanced, so micros() called from within the hook (or from an ISR which pre-empts it)
+ * reads 1000us early.
+ */
+uint32_t  TimeStamp_us()
+{
+  uint32_t  t_us = micros();
+
+  if (v_SysTickHookActive)  t_us += 1000;  // ms count not yet advanced
+  return  t_us;
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiReceive()
+ *
+ * Drain all bytes available in the Serial1 RX buffer through the MIDI message parser.
+ * Called by the SysTick interrupt (sysTickHook), by TC4_Handler() if VOICE_BUS_FAST, and by
+ * MidiInputService() in the main loop, which sets v_MidiRxBusy so that the background and
+ * main loop callers cannot both run the parser at once.
+ *
+ * If the UART RX buffer is found full, bytes may have been lost -- this is counted as an
+ * overrun in g_MidiRxOverruns.
+ */
+void  MidiReceive()
+{
+  int  count = Serial1.available();
+
+#ifdef SERIAL_BUFFER_SIZE
+  if (count >= SERIAL_BUFFER_SIZE - 1)  g_MidiRxOverruns++;  // UART buffer full
+#endif
+  while (count-- > 0)  MidiRxParse(Serial1.read());
+}
+
+
+#if VOICE_BUS_FAST
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiRxPollStart()
+ *
+ * At 500k baud, up to 50 bytes arrive in the 1ms between SysTick drains, which is too close
+ * to the 64-byte Serial1 RX buffer.  Timer-Counter-4 is set up to interrupt every
+ * MIDI_RX_POLL_US microseconds (MFRQ mode, 48MHz clock) so that the buffer is drained by
+ * TC4_Handler() well before it can fill.  The IRQ priority is the same as SysTick, so the
+ * two drains cannot pre-empt each other.
+ */
+void  MidiRxPollStart()
+{
+  PM->APBCMASK.reg |= PM_APBCMASK_TC4;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_TC4_TC5;
+  while (GCLK->STATUS.bit.SYNCBUSY) ;
+
+  TC4->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  while (TC4->COUNT16.CTRLA.bit.SWRST) ;
+  TC4->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ | TC_CTRLA_PRESCALER_DIV1;
+  TC4->COUNT16.CC[0].reg = (F_CPU / 1000000) * MIDI_RX_POLL_US - 1;
+  while (TC4->COUNT16.STATUS.bit.SYNCBUSY) ;
+  TC4->COUNT16.INTENSET.reg = TC_INTENSET_MC0;
+
+  NVIC_SetPriority(TC4_IRQn, 3);  // same as SysTick
+  NVIC_EnableIRQ(TC4_IRQn);
+  TC4->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+  while (TC4->COUNT16.STATUS.bit.SYNCBUSY) ;
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  TC4_Handler()  -- Timer-Counter-4 interrupt service routine (MIDI RX drain)
+ */
+void  TC4_Handler(void)
+{
+  TC4->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;  // clear the IRQ
+  if (!v_MidiRxBusy)  MidiReceive();  // not already running in background task
+}
+#endif
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:  MidiRxParse()
+ *
+ * Incremental MIDI message parser -- one byte per call.  When a message is complete, it is
+ * time-stamped and put into the MIDI IN message queue, regardless of channel.  Running
+ * status is supported;  Real-Time messages are ignored.  If the queue is full, the message
+ * is discarded and counted as an overrun.
+ *
+ * A SysEx message longer than MIDI_MSG_MAX_LENGTH (e.g. patch data) is held in a separate
+ * buffer, m_SysExRxBuffer, until processed;  its queue entry has Length greater than
+ * MIDI_MSG_MAX_LENGTH and Data[0] only.  One such message can be pending at a time.
+ *
+ * Entry arg:  msgByte = byte received on MIDI IN (Serial1)
+ */
+void  MidiRxParse(uint8_t msgByte)
+{
+  static  uint8_t  midiMessage[SYSEX_RX_MAX_LENGTH];
+  static  short  msgBytesExpected;
+  static  short  msgByteCount;
+  static  uint8_t  msgStatus;     // last command/status byte rx'd
+  MidiRxMessage_t  *pEntry;
+  uint8_t  head;
+
+  if (msgByte & 0x80)  // command/status byte received (bit7 High)
+  {
+    if (msgByte == SYSTEM_MSG_EOX)
+    {
+      if (msgStatus != SYS_EXCLUSIVE_MSG || msgByteCount == 0)  return;  // no SysEx
+      if (msgByteCount < SYSEX_RX_MAX_LENGTH)  midiMessage[msgByteCount++] = SYSTEM_MSG_EOX;
+      msgBytesExpected = msgByteCount;  // complete
+    }
+    else if (msgByte <= SYS_EXCLUSIVE_MSG)  // Ignore Real-Time messages
+    {
+      msgStatus = msgByte;
+      midiMessage[0] = msgStatus;
+      msgByteCount = 1;  // have cmd already
+      msgBytesExpected = MIDI_GetMessageLength(msgStatus);
+    }
+    else  return;
+  }
+  else  // data byte received (bit7 LOW)
+  {
+    if (msgByteCount == 0)  // start of new data set -- running status
+    {
+      if (msgStatus == 0 || msgStatus == SYS_EXCLUSIVE_MSG)  return;  // no status
+      midiMessage[0] = msgStatus;
+      msgByteCount = 1;
+      msgBytesExpected = MIDI_GetMessageLength(msgStatus);
+    }
+    if (msgByteCount < SYSEX_RX_MAX_LENGTH)  midiMessage[msgByteCount++] = msgByte;
+  }
+
+  if (msgByteCount != 0 && msgByteCount == msgBytesExpected)  // message complete
+  {
+    head = v_MidiRxHead;
+    if (((head + 1) & (MIDI_RX_QUEUE_SIZE - 1)) == v_MidiRxTail)  g_MidiRxOverruns++;
+    else if (msgByteCount > MIDI_MSG_MAX_LENGTH && v_SysExRxPending)  g_MidiRxOverruns++;
+    else  // queue not full
+    {
+      pEntry = &m_MidiRxQueue[head];
+      pEntry->Time_us = TimeStamp_us();
+      pEntry->Length = msgByteCount;
+      if (msgByteCount > MIDI_MSG_MAX_LENGTH)  // long SysEx msg
+      {
+        memcpy(m_SysExRxBuffer, midiMessage, msgByteCount);
+        pEntry->Data[0] = SYS_EXCLUSIVE_MSG;
+        v_SysExRxPending = TRUE;
+      }
+      else  memcpy(pEntry->Data, midiMessage, msgByteCount);
+      v_MidiRxHead = (head + 1) & (MIDI_RX_QUEUE_SIZE - 1);
+    }
+    msgByteCount = 0;  // ready for next message (or running status)
+    if (msgStatus == SYS_EXCLUSIVE_MSG)  msgStatus = 0;
+  }
+}
+
+
 /*`````````````````````````````````````````````````````````````````````````````````````````````````
  * Function:  MidiInputService()
  *
  * MIDI IN service routine, executed frequently from within main loop.
- * This routine monitors the serial MIDI INPUT stream and whenever a complete message is
- * received, it is processed.
+ * Bytes received are parsed (see MidiReceive), then every complete message in the MIDI IN
+ * queue is processed, i.e. the queue is drained in one pass.
  *
  * The synth module responds to valid messages addressed to the configured MIDI IN channel and,
  * if MIDI mode is set to 'Omni On' (channel-select switches set to 0), it will respond to all
@@ -115,83 +316,63 @@ void  PresetSelect(uint8_t preset)
  * The module also responds to valid messages addressed to channel 16, regardless of the channel
  * switch setting, so that the host controller can transmit a "broadcast" message to all modules
  * on the MIDI network simultaneously.
+ * If DUAL_VOICE_ENGINE is TRUE, the module also responds to channel g_MidiChannel + 1, which
+ * addresses the second voice of the synth engine (see MidiChannelVoice).
  */
 void  MidiInputService()
 {
-  static  uint8_t  midiMessage[MIDI_MSG_MAX_LENGTH];
-  static  short  msgBytesExpected;
-  static  short  msgByteCount;
-  static  short  msgIndex;
-  static  uint8_t  msgStatus;     // last command/status byte rx'd
-  static  bool   msgComplete;   // flag: got msg status & data set
-
-  uint8_t  msgByte;
+  MidiRxMessage_t  *pEntry;
+  uint8_t  *pData;
   uint8_t  msgChannel;  // 1..16 !
-  BOOL     gotSysExMsg = FALSE;
+  uint8_t  tail = v_MidiRxTail;
+
+  v_MidiRxBusy = TRUE;   // hold off sysTickHook()
+  MidiReceive();
+  v_MidiRxBusy = FALSE;
 
-  if (Serial1.available() > 0)  // unread byte(s) available in Rx buffer
+  while (tail != v_MidiRxHead)  // process all messages in queue
   {
-    msgByte = Serial1.read();
+    pEntry = &m_MidiRxQueue[tail];
+    pData = (pEntry->Length > MIDI_MSG_MAX_LENGTH) ? m_SysExRxBuffer : pEntry->Data;
+    msgChannel = (pData[0] & 0x0F) + 1;  // 1..16
 
-    if (msgByte & 0x80)  // command/status byte received (bit7 High)
+    if (msgChannel == g_MidiChannel || msgChannel == 16
+    ||  g_MidiMode == OMNI_ON_MONO  || pData[0] == SYS_EXCLUSIVE_MSG
+    ||  (DUAL_VOICE_ENGINE && msgChannel == g_MidiChannel + 1))
     {
-      if (msgByte == SYSTEM_MSG_EOX)
-      {
-        msgComplete = TRUE;
-        gotSysExMsg = TRUE;
-        midiMessage[msgIndex++] = SYSTEM_MSG_EOX;
-        msgByteCount++;
-      }
-      else if (msgByte <= SYS_EXCLUSIVE_MSG)  // Ignore Real-Time messages
-      {
-        msgStatus = msgByte;
-        msgComplete = FALSE;  // expecting data byte(s))
-        midiMessage[0] = msgStatus;
-        msgIndex = 1;
-        msgByteCount = 1;  // have cmd already
-        msgBytesExpected = MIDI_GetMessageLength(msgStatus);
-      }
-    }
-    else  // data byte received (bit7 LOW)
-    {
-      if (msgComplete && msgStatus != SYS_EXCLUSIVE_MSG)
-      {
-        if (msgByteCount == 0)  // start of new data set -- running status
-        {
-          msgIndex = 1;
-          msgByteCount = 1;
-          msgBytesExpected = MIDI_GetMessageLength(msgStatus);
-        }
-      }
-      if (msgIndex < MIDI_MSG_MAX_LENGTH)
-      {
-        midiMessage[msgIndex++] = msgByte;
-        msgByteCount++;
-      }
+      m_MidiRxMsgTime = pEntry->Time_us;  // for note latency trace
+      ProcessMidiMessage(pData, pEntry->Length);
+//    g_MidiRxSignal = TRUE;  // signal to UI (not used in Poly voice)
     }
+    if (pData == m_SysExRxBuffer)  v_SysExRxPending = FALSE;
+    tail = (tail + 1) & (MIDI_RX_QUEUE_SIZE - 1);
+    v_MidiRxTail = tail;  // free the entry
+  }
+}
 
-    if ((msgByteCount != 0 && msgByteCount == msgBytesExpected) || gotSysExMsg)
-    {
-      msgComplete = TRUE;
-      msgChannel = (midiMessage[0] & 0x0F) + 1;  // 1..16
 
-      if (msgChannel == g_MidiChannel || msgChannel == 16
-      ||  g_MidiMode == OMNI_ON_MONO  || msgStatus == SYS_EXCLUSIVE_MSG)
-      {
-        ProcessMidiMessage(midiMessage, msgByteCount);
-//      g_MidiRxSignal = TRUE;  // signal to UI (not used in Poly voice)
-        msgBytesExpected = 0;
-        msgByteCount = 0;
-        msgIndex = 0;
-      }
-    }
-  }
+/*
+ * Function:     Get the synth engine voice addressed by a MIDI channel message.
+ *               In the dual voice build, voice 1 answers channel g_MidiChannel + 1;
+ *               all other channels (incl. broadcast and 'Omni On' mode) address voice 0.
+ *
+ * Entry args:   statusByte = MIDI message status byte (channel in 4 LS bits)
+ *
+ * Return val:   voice number (0..SYNTH_VOICE_COUNT-1)
+ */
+uint8_t  MidiChannelVoice(uint8_t statusByte)
+{
+  uint8_t  msgChannel = (statusByte & 0x0F) + 1;  // 1..16
+
+  if (DUAL_VOICE_ENGINE && g_MidiMode == OMNI_OFF_MONO && msgChannel == g_MidiChannel + 1)
+    return 1;
+  return 0;
 }
 
 
 void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
 {
-  static uint8_t  noteKeyedFirst;
+  uint8_t  voice = MidiChannelVoice(midiMessage[0]);
   uint8_t  statusByte = midiMessage[0] & 0xF0;
   uint8_t  noteNumber = midiMessage[1];  // New note keyed
   uint8_t  velocity = midiMessage[2];
@@ -199,14 +380,12 @@ void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
   uint8_t  leverPosn_Lo = midiMessage[1];  // modulation
   uint8_t  leverPosn_Hi = midiMessage[2];
   short  bipolarPosn;
-  bool   executeNoteOff = FALSE;
-  bool   executeNoteOn = FALSE;
 
   switch (statusByte)
   {
     case NOTE_OFF_CMD:
     {
-      SynthNoteOff(noteNumber);
+      SynthNoteOff(voice, noteNumber);
       digitalWrite(TESTPOINT2, LOW);
       GPIOA_PIN_SET_HIGH(TX_LED);  // "Gate" LED off
       break;
@@ -215,13 +394,16 @@ void  ProcessMidiMessage(uint8_t *midiMessage, short msgLength)
     {
       if (velocity == 0) 
       {
-        SynthNoteOff(noteNumber);
+        SynthNoteOff(voice, noteNumber);
         digitalWrite(TESTPOINT2, LOW);
         GPIOA_PIN_SET_HIGH(TX_LED);  // "Gate" LED off
       }
       else  
       {
-        SynthNoteOn(noteNumber, velocity);
+        SynthNoteOn(voice, noteNumber, velocity);
+#if NOTE_LATENCY_TRACE
+        SynthLatencyTraceStart(voice, m_MidiRxMsgTime);
+#endif
         digitalWrite(TESTPOINT2, HIGH);
         GPIOA_PIN_SET_LOW(TX_LED);  // "Gate" LED on
       }
@@ -293,11 +475,16 @@ void  ProcessControlChange(uint8_t *midiMessage)
   else if (CCnumber == 38)  // Parameter "Data Entry" (LSB) message
   {
     if (g_MidiRegisParam == 0x00 && dataByte <= 12) g_Config.PitchBendRange = dataByte;
-    if (g_MidiRegisParam == 0x01) g_Config.FineTuning_cents = (short)dataByte - 64;
+    if (g_MidiRegisParam == 0x01)
+    {
+      g_Config.FineTuning_cents = (short)dataByte - 64;
+      SynthMarkDirty(DIRTY_OSC_DETUNE);
+    }
   }
   else if (CCnumber == 86)  // Set audio ampld control mode
   {
     if (dataByte < 4)  g_Config.AudioAmpldCtrlMode = dataByte;
+    SynthMarkDirty(DIRTY_AMPLD_CONTROL);
   }
   else if (CCnumber == 87)  // Set vibrato control mode
   {
@@ -315,15 +502,25 @@ void  ProcessControlChange(uint8_t *midiMessage)
       SynthSetReverbMix(dataByte);  // effective immediately
     }
   }
+  else if (CCnumber == 85)  // Set reverb mode: 0 = single line, 1 = network
+  {
+    SynthSetReverbMode(dataByte);  // effective immediately
+  }
+  else if (CCnumber == 90)  // Set audio sample rate (kHz): 32, 40 or 48
+  {
+    SynthSetSampleRate((uint16_t) dataByte * 1000);  // refused if ISR load too high
+  }
   // The following CC numbers are to set synth Patch parameters:
   // ```````````````````````````````````````````````````````````
   else if (CCnumber == 70)  // Set osc. mixer output gain (unit = 0.1)
   {
     if (dataByte != 0)  g_Patch.MixerOutGain_x10 = dataByte;
+    SynthMarkDirty(DIRTY_MIXER_LEVELS);
   }
   else if (CCnumber == 71)  // Set ampld limiter level (%), 0 => OFF
   {
     if (dataByte <= 95)  g_Patch.LimiterLevelPc = dataByte;
+    SynthMarkDirty(DIRTY_LIMITER_LEVEL);
   }
   else if (CCnumber == 72)  // Set Ampld ENV Release Time (unit = 100ms)
   {
@@ -352,6 +549,7 @@ void  ProcessControlChange(uint8_t *midiMessage)
   {
     if (dataByte != 0 && dataByte <= 50)  
       g_Patch.LFO_Freq_x10 = (uint16_t) dataByte * 10;
+    SynthMarkDirty(DIRTY_LFO_FREQ);
   }
   else if (CCnumber == 78)  // Set LFO ramp time (unit = 100ms)
   {
@@ -365,6 +563,7 @@ void  ProcessControlChange(uint8_t *midiMessage)
   {
     oscnum = (dataByte >> 4) % 6;  // MS digit (0..5)
     g_Patch.MixerInputStep[oscnum] = dataByte & 0x0F;  // LS digit (0..15)
+    SynthMarkDirty(DIRTY_MIXER_LEVELS);
   }
   else if (CCnumber == 112)  // LFO phase sync
   {
@@ -387,10 +586,308 @@ void  ProcessControlChange(uint8_t *midiMessage)
  */
 void  ProcessMidiSystemExclusive(uint8_t *midiMessage, short msgLength)
 {
+  uint8_t  msgType = midiMessage[2];
+  uint8_t  msgChannel = midiMessage[3];  // target voice channel (1..16)
+  bool     voiceChannel = (msgChannel == g_MidiChannel);  // addressed to this module
+
+  if (DUAL_VOICE_ENGINE && msgChannel == g_MidiChannel + 1)  voiceChannel = TRUE;
+
   if (midiMessage[1] == SYS_EXCL_REMI_ID)  // "Manufacturer ID" match
   {
-      // Nothing to be done in this version !
+    // A reply is sent only if the query is addressed to this voice (not broadcast)
+    if (msgType == SYSEX_ISR_STATS_QUERY && msgLength >= 6 && voiceChannel)
+      SendIsrStatsReply(msgChannel, midiMessage[4] & 1);  // data bit0 = reset stats
+
+    // Data bits 2:1 = latency stage (histogram), bit0 = reset histogram after reading
+    if (msgType == SYSEX_LATENCY_QUERY && msgLength >= 6 && voiceChannel)
+      SendLatencyReply(msgChannel, (midiMessage[4] >> 1) & 3, midiMessage[4] & 1);
+
+    // The patch is common to both voices of the dual voice build
+    if (msgType == SYSEX_PATCH_DATA && (voiceChannel || msgChannel == 16))
+      ReceivePatchData(&midiMessage[4], msgLength - 5);  // exclude header and EOX
+
+    // A status poll is broadcast;  each voice replies in its own time slot (see below).
+    // A voice in Omni mode (channel 0) has no slot and does not reply.
+    if (msgType == SYSEX_STATUS_POLL && msgChannel == 16 && g_MidiChannel != 0)
+    {
+      m_StatusReplyTime = m_MidiRxMsgTime  // poll arrival time-stamp
+                        + (uint32_t)(g_MidiChannel - 1) * VOICE_STATUS_SLOT_MS * 1000;
+      m_StatusReplyDue = (1 << SYNTH_VOICE_COUNT) - 1;  // all voices
+    }
+  }
+}
+
+
+/*
+ * Function:     Voice status reply scheduler, called on every pass of the main loop.
+ *
+ * The master broadcasts a status poll;  voices reply on the shared (wired-OR) reply line
+ * in turn, each in a time slot of VOICE_STATUS_SLOT_MS after the poll is received:
+ * voice channel 1 at once, channel 2 after 5ms, etc.  A reply (11 bytes) takes 3.5ms.
+ * The slot is timed in microseconds from the arrival time-stamp of the poll, so the
+ * reply jitter is that of the time-stamp (up to 1ms, see sysTickHook) plus one pass of
+ * the main loop.
+ * In the dual voice build, voice 1 replies for channel g_MidiChannel + 1 in the next slot.
+ * A voice in Omni mode (g_MidiChannel = 0) is not polled, since it has no reply slot.
+ */
+void  VoiceStatusService()
+{
+  uint8_t  voice;
+
+  for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+  {
+    if ((m_StatusReplyDue & (1 << voice))
+    &&  (int32_t)(micros() - m_StatusReplyTime) >= (int32_t)(voice * VOICE_STATUS_SLOT_MS * 1000))
+    {
+      m_StatusReplyDue &= ~(1 << voice);
+      SendStatusReply(voice);
+    }
+  }
+}
+
+
+/*
+ * Function:     Transmit voice status in a SysEx message (reply to status poll).
+ *
+ * Message format:  F0 73 43 <chan> <ENV1 phase> <ENV1 level> <output level> <ISR load %>
+ *                  <note> <checksum> F7  -- levels are 0..127;  see VoiceStatus_t in
+ * m0_synth_def.h.  <checksum> is chosen such that the sum of all bytes from <ENV1 phase>
+ * to <checksum> inclusive is zero (modulo 128), as in the patch data message.
+ *
+ * Entry arg:    voice = synth engine voice;  <chan> = g_MidiChannel + voice
+ */
+void  SendStatusReply(uint8_t voice)
+{
+  VoiceStatus_t  status;
+  uint8_t  reply[11];
+  uint8_t  i, sum = 0;
+
+  SynthGetStatus(voice, &status);
+
+  reply[0] = SYS_EXCLUSIVE_MSG;
+  reply[1] = SYS_EXCL_REMI_ID;
+  reply[2] = SYSEX_STATUS_REPLY;
+  reply[3] = g_MidiChannel + voice;
+  reply[4] = status.Env1Phase;
+  reply[5] = status.Env1Level;
+  reply[6] = status.OutputLevel;
+  reply[7] = status.LoadPc;
+  reply[8] = status.NotePlaying;
+  for (i = 4;  i < 9;  i++)  sum += reply[i];
+  reply[9] = (128 - (sum & 0x7F)) & 0x7F;  // checksum
+  reply[10] = SYSTEM_MSG_EOX;
+
+  Serial1.write(reply, 11);
+}
+
+
+/*
+ * Function:     Apply patch data received in a SysEx message from the master.
+ *
+ * Message format:  F0 73 02 <chan> <size> <packed patch data> <checksum> F7
+ * where <size> = sizeof(PatchParamTable_t), 2 bytes (MS byte first), patch data is packed
+ * as 7-bit bytes (see SysExUnpackData) and <checksum> is chosen such that the sum of all
+ * bytes from <size> to <checksum> inclusive is zero (modulo 128).
+ *
+ * The patch is loaded by SynthPatchLoad(), i.e. swapped in with a fade-out/fade-in;
+ * parameter values are exact, not quantized as those set by individual CC messages.
+ * The message is ignored if the size or checksum is wrong, or if any patch parameter
+ * is out of range (see PatchParamsValid), so the active patch is kept.
+ *
+ * Entry args:   pData = pointer to <size> field in message
+ *               count = number of bytes from <size> to <checksum> inclusive
+ */
+void  ReceivePatchData(uint8_t *pData, short count)
+{
+  PatchParamTable_t  patch;
+  uint16_t  size = ((uint16_t) pData[0] << 7) + pData[1];
+  uint8_t   checksum = 0;
+  short     i;
+
+  if (size != sizeof(PatchParamTable_t))  return;  // incompatible patch format
+  if (count != 2 + SYSEX_PACKED_SIZE(sizeof(PatchParamTable_t)) + 1)  return;
+
+  for (i = 0;  i < count;  i++)  { checksum += pData[i]; }
+  if ((checksum & 0x7F) != 0)  return;  // data corrupted
+
+  SysExUnpackData((uint8_t *) &patch, &pData[2], sizeof(PatchParamTable_t));
+  patch.PresetName[sizeof(patch.PresetName) - 1] = 0;  // ensure string terminated
+  if (!PatchParamsValid(&patch))  return;  // would index tables out of bounds, etc
+  SynthPatchLoad(&patch);
+}
+
+
+/*
+ * Function:     Check that every parameter in a patch received from the master is within
+ *               the range the synth engine can handle, i.e. the range allowed by the
+ *               master panel UI, the patch CC messages and the preset table.
+ *               Option codes index tables (g_NoteStep, g_AmpldLevelLogScale_x1000) and
+ *               the Attack, Decay, Release and Ramp times are divisors, so min. 5 ms.
+ *
+ * Return val:   TRUE if all param's are in range, else FALSE
+ */
+bool  PatchParamsValid(PatchParamTable_t *patch)
+{
+  uint8_t  osc;
+
+  for (osc = 0;  osc < 6;  osc++)
+  {
+    if (patch->OscFreqMult[osc] >= 12)  return FALSE;  // 1 of 12 options
+    if (patch->OscAmpldModSource[osc] > OSC_MODN_SOURCE_VELO_NEG)  return FALSE;
+    if (patch->OscDetune[osc] < -600 || patch->OscDetune[osc] > 600)  return FALSE;
+    if (patch->MixerInputStep[osc] > 16)  return FALSE;
+  }
+  if (patch->EnvAttackTime < 5 || patch->EnvAttackTime > 10000)  return FALSE;
+  if (patch->EnvHoldTime > 10000)  return FALSE;
+  if (patch->EnvDecayTime < 5 || patch->EnvDecayTime > 10000)  return FALSE;
+  if (patch->EnvSustainLevel > 100)  return FALSE;
+  if (patch->EnvReleaseTime < 5 || patch->EnvReleaseTime > 10000)  return FALSE;
+  if (patch->AmpControlMode > AMPLD_CTRL_EXPRESS)  return FALSE;
+  if (patch->ContourStartLevel > 100)  return FALSE;
+  if (patch->ContourDelayTime > 10000)  return FALSE;
+  if (patch->ContourRampTime < 5 || patch->ContourRampTime > 10000)  return FALSE;
+  if (patch->ContourHoldLevel > 100)  return FALSE;
+  if (patch->Env2DecayTime < 5 || patch->Env2DecayTime > 10000)  return FALSE;
+  if (patch->Env2SustainLevel > 100)  return FALSE;
+  if (patch->LFO_Freq_x10 < 5 || patch->LFO_Freq_x10 > 500)  return FALSE;
+  if (patch->LFO_RampTime > 10000)  return FALSE;
+  if (patch->LFO_FM_Depth > 600)  return FALSE;
+  if (patch->LFO_AM_Depth > 100)  return FALSE;
+  if (patch->MixerOutGain_x10 > 127)  return FALSE;
+  if (patch->LimiterLevelPc > 95)  return FALSE;
+
+  return TRUE;
+}
+
+
+/*
+ * Function:     Unpack 8-bit data from SysEx message data (7-bit bytes).  Each group of
+ *               up to 7 data bytes is preceded by a byte holding their MS bits, bit0 for
+ *               the first byte of the group, bit1 for the next, etc.
+ *
+ * Entry args:   pDest  = pointer to destination (8-bit data)
+ *               pSrc   = pointer to packed data in SysEx message
+ *               nbytes = number of 8-bit data bytes to unpack
+ */
+void  SysExUnpackData(uint8_t *pDest, uint8_t *pSrc, short nbytes)
+{
+  uint8_t  msbits = 0;
+  short    i;
+
+  for (i = 0;  i < nbytes;  i++)
+  {
+    if ((i % 7) == 0)  msbits = *pSrc++;
+    *pDest++ = *pSrc++ | (((msbits >> (i % 7)) & 1) << 7);
+  }
+}
+
+
+/*
+ * Function:     Transmit Audio ISR load statistics in a SysEx message (reply to query).
+ *
+ * Message format:  F0 73 41 <chan> <ISR stats data> F7
+ * Each data value is sent as 3 bytes (21 bits), MS byte first, except LoadPc_x10 (2 bytes).
+ *
+ * The reply is transmitted on the UART TX line (Serial1) which is connected (wired-OR)
+ * with the TX lines of other voice modules to the master controller voice reply input.
+ * The master queries one voice at a time, so replies do not collide.
+ *
+ * The last value is the MIDI IN overrun count (messages lost), not part of the ISR stats.
+ *
+ * Entry args:   chan  = voice channel queried, i.e. <chan> in reply (1..16)
+ *               reset = TRUE to reset min/max values and overrun counts after reading
+ */
+void  SendIsrStatsReply(uint8_t chan, bool reset)
+{
+#if AUDIO_ISR_LOAD_MONITOR
+  AudioIsrStats_t  stats;
+  uint8_t  reply[MIDI_MSG_MAX_LENGTH + 12];
+  uint8_t  *pData = &reply[4];
+
+  SynthGetIsrStats(&stats, reset);
+
+  reply[0] = SYS_EXCLUSIVE_MSG;
+  reply[1] = SYS_EXCL_REMI_ID;
+  reply[2] = SYSEX_ISR_STATS_REPLY;
+  reply[3] = chan;
+  pData = SysExPutValue(pData, stats.CyclesMin, 3);
+  pData = SysExPutValue(pData, stats.CyclesAvg, 3);
+  pData = SysExPutValue(pData, stats.CyclesMax, 3);
+  pData = SysExPutValue(pData, stats.LoadPc_x10, 2);
+  pData = SysExPutValue(pData, stats.SynthProcessMax, 3);
+  pData = SysExPutValue(pData, stats.OverrunCount, 3);
+  pData = SysExPutValue(pData, stats.SampleRate_Hz, 3);
+  pData = SysExPutValue(pData, g_MidiRxOverruns, 3);
+  *pData++ = SYSTEM_MSG_EOX;
+
+  Serial1.write(reply, (pData - reply));
+  if (reset)  g_MidiRxOverruns = 0;
+#endif
+}
+
+
+/*
+ * Function:     Transmit a note latency histogram in a SysEx message (reply to query).
+ *
+ * Message format:  F0 73 44 <chan> <stage> <count> <mean> <max> <bin 0> .. <bin 7> F7
+ * Count, mean and max (us) are sent as 3 bytes (21 bits), bins as 2 bytes (14 bits),
+ * MS byte first;  values are limited to the field size.  See LatencyHist_t.
+ * The master queries one stage at a time, so a reply (31 bytes) fits in the UART TX
+ * buffer and the main loop is not held up.  In the dual voice build, the histograms
+ * hold the notes of both voices.  No reply if NOTE_LATENCY_TRACE is FALSE.
+ *
+ * Entry args:   chan  = voice channel queried, i.e. <chan> in reply (1..16)
+ *               stage = LATENCY_RX_TO_TRIGGER, _TRIGGER_TO_AUDIO or _RX_TO_AUDIO
+ *               reset = TRUE to clear the histogram after reading
+ */
+void  SendLatencyReply(uint8_t chan, uint8_t stage, bool reset)
+{
+#if NOTE_LATENCY_TRACE
+  LatencyHist_t  hist;
+  uint8_t  reply[MIDI_MSG_MAX_LENGTH + 16];
+  uint8_t  *pData = &reply[5];
+  uint32_t  mean;
+  uint8_t  bin;
+
+  SynthGetLatencyHist(stage, &hist, reset);
+  mean = (hist.Count != 0) ? (hist.Total_us / hist.Count) : 0;
+
+  reply[0] = SYS_EXCLUSIVE_MSG;
+  reply[1] = SYS_EXCL_REMI_ID;
+  reply[2] = SYSEX_LATENCY_REPLY;
+  reply[3] = chan;
+  reply[4] = stage;
+  pData = SysExPutValue(pData, (hist.Count < 0x1FFFFF) ? hist.Count : 0x1FFFFF, 3);
+  pData = SysExPutValue(pData, (mean < 0x1FFFFF) ? mean : 0x1FFFFF, 3);
+  pData = SysExPutValue(pData, (hist.Max_us < 0x1FFFFF) ? hist.Max_us : 0x1FFFFF, 3);
+  for (bin = 0;  bin < LATENCY_HIST_BINS;  bin++)
+  {
+    pData = SysExPutValue(pData, (hist.Bin[bin] < 0x3FFF) ? hist.Bin[bin] : 0x3FFF, 2);
+  }
+  *pData++ = SYSTEM_MSG_EOX;
+
+  Serial1.write(reply, (pData - reply));
+#endif
+}
+
+
+/*
+ * Function:     Put an unsigned value into a SysEx message buffer as 7-bit data bytes,
+ *               MS byte first.
+ *
+ * Entry args:   pBuf   = pointer to next free location in message buffer
+ *               value  = value to be encoded (max. 7 x nbytes bits)
+ *               nbytes = number of data bytes to put (1..4)
+ *
+ * Return val:   pointer to next free location in message buffer
+ */
+uint8_t  *SysExPutValue(uint8_t *pBuf, uint32_t value, int nbytes)
+{
+  while (nbytes--)
+  {
+    *pBuf++ = (uint8_t)(value >> (nbytes * 7)) & 0x7F;
   }
+  return  pBuf;
 }
 
 
@@ -405,7 +902,7 @@ int  MIDI_GetMessageLength(uint8_t statusByte)
   {
       length = 3;
   }
-  if (statusByte == SYS_EXCLUSIVE_MSG)  length = MIDI_MSG_MAX_LENGTH;
+  if (statusByte == SYS_EXCLUSIVE_MSG)  length = SYSEX_RX_MAX_LENGTH;
 
   return  length;
 }
@@ -426,6 +923,7 @@ void  DefaultConfigData(void)
   g_Config.PitchBendMode = PITCH_BEND_BY_MIDI_MSG;
   g_Config.PitchBendRange = 2;         // semitones (max. 12)
   g_Config.ReverbMix_pc = 15;          // 0..100 % (typ. 15)
+  g_Config.ReverbMode = REVERB_MODE_NETWORK;
   g_Config.PresetLastSelected = 1;     // user preference
   g_Config.FineTuning_cents = 0;
 }
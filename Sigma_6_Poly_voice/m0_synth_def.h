@@ -24,10 +24,34 @@
  *           Set EEPROM_IS_INSTALLED to FALSE
  *           Set LEGATO_ENABLED_ALWAYS to TRUE
  *           Set USE_SPI_DAC_FOR_AUDIO to TRUE
+ *
+ *   Audio output is normally driven by the TC3 ISR, one sample per interrupt.
+ *   If USE_DMA_AUDIO_OUTPUT is TRUE, samples are rendered in blocks of AUDIO_BLOCK_SIZE
+ *   and streamed to the SPI DAC by the DMA controller, paced by timer TCC0, which also
+ *   drives the DAC chip-select pin (SPI_DAC_CS) as a PWM waveform output.
+ *   This requires USE_SPI_DAC_FOR_AUDIO = TRUE.  SPI_DAC_CS must be pin PA14 or PA08.
+ *
+ *   If VOICE_BUS_FAST is TRUE, MIDI IN (and the SysEx reply output) runs at VOICE_BUS_BAUD
+ *   instead of the MIDI standard 31250 baud.  The Poly master must be built with the same
+ *   option and baud rate;  the message format is unchanged.  Poly voice build only.
+ *
+ *   If DUAL_VOICE_ENGINE is TRUE, the synth engine hosts two independent voices, which
+ *   answer two consecutive MIDI channels:  the channel-select switch setting (n) and n+1.
+ *   The voices have separate oscillators, envelopes, etc;  the patch, config, LFO and
+ *   reverb are shared.  The two voice outputs are summed into the audio DAC.
+ *   Set the channel-select switches to 1..14, so that channel n+1 is not the broadcast
+ *   channel (16).  Poly voice build only.
+ *
+ *   If NOTE_LATENCY_TRACE is TRUE, each Note-On is time-stamped (TimeStamp_us) at receipt
+ *   (MIDI IN parser), at the envelope trigger (SynthProcess) and at the first audio sample
+ *   with non-zero output level (audio ISR).  The intervals are accumulated in histograms, sent
+ *   to the master in reply to a SysEx query -- see SendLatencyReply().  Test builds only:
+ *   the audio ISR tests the trace state of each voice on every sample.
  */
 #ifndef M0_SYNTH_DEF_H
 #define M0_SYNTH_DEF_H
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,13 +67,21 @@
 #define APPLY_EXPRESSN_EXPL_CURVE  FALSE  // TRUE => Apply "exponential" ampld curve
 #define LEGATO_ENABLED_ALWAYS      TRUE   // FALSE => Allow Multi-trigger mode
 #define USE_SPI_DAC_FOR_AUDIO      TRUE   // FALSE => Use MCU on-chip DAC (pin A0)
+#define USE_DMA_AUDIO_OUTPUT       FALSE  // TRUE => Block DMA output to SPI DAC
+#define AUDIO_ISR_LOAD_MONITOR     TRUE   // TRUE => Measure audio ISR CPU load
+#define WAVE_TABLE_INTERPOLATE     TRUE   // TRUE => Linear interp. of osc wave-table
+#define SINE_TABLE_QUARTER_WAVE    TRUE   // TRUE => Quarter-wave sine table in SRAM
+#define AUDIO_LEVEL_RAMP           TRUE   // TRUE => Output level ramped per sample
+#define VOICE_BUS_FAST             FALSE  // TRUE => MIDI IN from master at VOICE_BUS_BAUD
+#define DUAL_VOICE_ENGINE          FALSE  // TRUE => Two voices, MIDI channels n and n+1
+#define NOTE_LATENCY_TRACE         FALSE  // TRUE => Measure Note-On to audio latency
 
 #define HOME_SCREEN_SYNTH_DESCR  "Voice Module"  // 12 chars max.
 
 // Do not modify code below this line...
 //===========================================================================================
 
-typedef signed long  fixed_t;     // 32-bit fixed point (20-bit fraction)
+typedef int32_t  fixed_t;         // 32-bit fixed point (20-bit fraction)
 typedef void (* pfnvoid)(void);   // pointer to void function
 
 #ifndef BOOL
@@ -60,6 +92,31 @@ typedef unsigned char  BOOL;
 #define TRUE    (!FALSE)
 #endif
 
+#if (USE_DMA_AUDIO_OUTPUT && !USE_SPI_DAC_FOR_AUDIO)
+#error "USE_DMA_AUDIO_OUTPUT requires USE_SPI_DAC_FOR_AUDIO"
+#endif
+
+#if (VOICE_BUS_FAST && !BUILD_FOR_POLY_VOICE)
+#error "VOICE_BUS_FAST requires BUILD_FOR_POLY_VOICE"
+#endif
+
+#if (DUAL_VOICE_ENGINE && !BUILD_FOR_POLY_VOICE)
+#error "DUAL_VOICE_ENGINE requires BUILD_FOR_POLY_VOICE"
+#endif
+
+#if DUAL_VOICE_ENGINE
+#define SYNTH_VOICE_COUNT   2        // Voices hosted by the synth engine
+#else
+#define SYNTH_VOICE_COUNT   1
+#endif
+
+#if VOICE_BUS_FAST
+#define MIDI_BAUD_RATE     500000    // Fast voice bus -- must match master VOICE_BUS_BAUD
+#define MIDI_RX_POLL_US       250    // UART RX drain period (TC4 ISR);  ~13 bytes max.
+#else
+#define MIDI_BAUD_RATE      31250    // MIDI standard
+#endif
+
 // MCU I/O pin assignments......
 #define CHAN_SWITCH_S1        12    // MIDI channel-select switch S1 (bit 0)
 #define CHAN_SWITCH_S2        11    // MIDI channel-select switch S2 (bit 1)
@@ -82,20 +139,31 @@ typedef unsigned char  BOOL;
 #define SPI_DAC_CS             2    // using Adafruit M0 pinout
 #endif
 
-#define WAVE_TABLE_SIZE          2048    // nunber of samples
-#define SAMPLE_RATE_HZ          32000    // typically 32,000 or 40,000 Hz
-#define MAX_OSC_FREQ_HZ         12000    // must be < 0.4 x SAMPLE_RATE_HZ
+#define WAVE_TABLE_SIZE_LOG2       11    // wave-table size = 2 ^ 11 = 2048 samples
+#define WAVE_TABLE_SIZE  (1 << WAVE_TABLE_SIZE_LOG2)
+#define SAMPLE_RATE_DEFAULT     32000    // Hz -- rate set at power-on (32, 40 or 48 kHz)
+#define SAMPLE_RATE_LOAD_MAX_PC    70    // max. audio ISR load (%) for a higher rate
+#define MAX_OSC_FREQ_FACTOR     0.375    // max. osc freq / sample rate (must be < 0.4)
+#define AUDIO_BLOCK_SIZE           32    // samples per DMA block (32..64)
+#define PATCH_FADE_TIME_MS          4    // patch change fade-out (and fade-in) time, ms
 
-#define REVERB_DELAY_MAX_SIZE    2000    // samples 
-#define REVERB_LOOP_TIME_SEC     0.04    // seconds (max. 0.05 sec.)
+#define REVERB_BUFFER_SIZE       4000    // samples (16-bit) -- all reverb delay lines
+#define REVERB_LOOP_TIME_SEC     0.04    // seconds, single-line mode (max. 0.08 sec.)
 #define REVERB_DECAY_TIME_SEC     1.5    // seconds
 #define REVERB_ATTENUATION_PC      70    // percent (range: 35..95 %)
+#define REVERB_SAMPLE_SHIFT         7    // fixed_t to 16-bit delay line sample (+/-4.0)
+#define REVERB_COMB_COUNT           4    // Reverb network: number of comb filters
+#define REVERB_ALLPASS_COUNT        2    // Reverb network: number of allpass filters
 
 #define FIXED_MIN_LEVEL           (1)    // Minimum non-zero signal level (0.00001)
 #define FIXED_MAX_LEVEL  (IntToFixedPt(1) - 1)   // Full-scale normalized signal level (0.99999)
 #define FIXED_PT_HALF    (IntToFixedPt(1) / 2)   // constant = 0.5 in fixed_t format
 #define MAX_CLIPPING_LEVEL ((IntToFixedPt(1) * 97) / 100)   // constant = 0.97
 
+// Possible values for config parameter: g_Config.ReverbMode
+#define REVERB_MODE_SINGLE          0    // Single delay line with low-pass filter (low CPU)
+#define REVERB_MODE_NETWORK         1    // 4 comb filters + 2 allpass filters (Schroeder)
+
 // Possible values for config parameter: g_Config.AudioAmpldCtrlMode
 // If non-zero, this setting overrides the patch parameter: g_Patch.AmpldControlSource
 #define AUDIO_CTRL_BY_PATCH         0    // Audio output control by active patch param
@@ -132,6 +200,17 @@ typedef unsigned char  BOOL;
 #define AMPLD_CTRL_ENV1_VELO        2    // Output ampld control by ENV1 * Velocity
 #define AMPLD_CTRL_EXPRESS          3    // Output ampld control by Expression (CC2,7,11)
 
+// "Dirty" flags -- derived synth data to be re-calculated at control rate.
+// Set by SynthMarkDirty() when a patch or config param. is changed;  cleared by the
+// SynthProcess() task which re-calculates the data.  (SynthPrepare() sets all flags.)
+#define DIRTY_OSC_DETUNE         0x01    // Osc detune, fine tuning or note (phase steps)
+#define DIRTY_OSC_MODN_SOURCE    0x02    // Osc ampld modulation sources
+#define DIRTY_MIXER_LEVELS       0x04    // Mixer input levels, output gain, osc muting
+#define DIRTY_LIMITER_LEVEL      0x08    // Ampld limiter level
+#define DIRTY_AMPLD_CONTROL      0x10    // Audio ampld control mode (patch or config)
+#define DIRTY_LFO_FREQ           0x20    // LFO frequency
+#define DIRTY_ALL                0xFF
+
 #define OMNI_ON_POLY      1   // MIDI device responds in Poly mode on all channels
 #define OMNI_ON_MONO      2   // MIDI device responds in Mono mode on all channels
 #define OMNI_OFF_POLY     3   // MIDI device responds in Poly mode on base channel only
@@ -147,11 +226,24 @@ typedef unsigned char  BOOL;
 #define SYS_EXCLUSIVE_MSG    0xF0    // variable length message
 #define SYSTEM_MSG_EOX       0xF7    // system-ex msg terminator
 #define SYS_EXCL_REMI_ID     0x73    // arbitrary pick... hope it's free!
+#define SYSEX_ISR_STATS_QUERY  0x01  // SysEx msg type: Audio ISR stats query
+#define SYSEX_ISR_STATS_REPLY  0x41  // SysEx msg type: Audio ISR stats reply
+#define SYSEX_PATCH_DATA       0x02  // SysEx msg type: Patch data (PatchParamTable_t)
+#define SYSEX_STATUS_POLL      0x03  // SysEx msg type: Voice status poll (broadcast)
+#define SYSEX_STATUS_REPLY     0x43  // SysEx msg type: Voice status reply
+#define SYSEX_LATENCY_QUERY    0x04  // SysEx msg type: Note latency histogram query
+#define SYSEX_LATENCY_REPLY    0x44  // SysEx msg type: Note latency histogram reply
+#define VOICE_STATUS_SLOT_MS   5     // Status reply time slot per voice channel (ms)
+
+// Number of SysEx data bytes to carry n bytes of 8-bit data (7 bytes => 8, see below)
+#define SYSEX_PACKED_SIZE(n)  ((n) + ((n) + 6) / 7)
 #define CC_MODULATION        1       // Control change High byte
 #define CC_BREATH_PRESSURE   2       //    ..     ..     ..
 #define CC_CHANNEL_VOLUME    7       //    ..     ..     ..
 #define CC_EXPRESSION        11      //    ..     ..     ..
 #define MIDI_MSG_MAX_LENGTH  16      // not in MIDI specification!
+#define SYSEX_RX_MAX_LENGTH  160     // Max. length of SysEx message rec'd (patch data)
+#define MIDI_RX_QUEUE_SIZE   16      // MIDI IN message queue entries (power of 2)
 
 enum  Envelope_Gen_Phases  // aka "segments"
 {
@@ -178,6 +270,7 @@ typedef struct table_of_configuration_params
   uint8_t PitchBendMode;            // Pitch Bend Control Mode (0: disabled)
   uint8_t PitchBendRange;           // Pitch Bend range, semitones (1..12)
   uint8_t ReverbMix_pc;             // Reverb. wet/dry mix (0..100 %)
+  uint8_t ReverbMode;               // Reverb. algorithm (REVERB_MODE_xxx)
   uint8_t PresetLastSelected;       // Preset Last Selected (0..127)
   uint8_t Pitch_CV_BaseNote;        // Lowest note in Pitch CV range (MIDI #)
   bool    Pitch_CV_Quantize;        // Quantize CV pitch to nearest semitone
@@ -225,11 +318,145 @@ typedef  struct  synth_patch_param_table
 
 } PatchParamTable_t;
 
+// Audio ISR load statistics -- Unit of time is CPU cycles (F_CPU = 48MHz)
+typedef  struct  audio_isr_load_statistics
+{
+  uint32_t  CyclesMin;            // Min. cycles per sample (since reset)
+  uint32_t  CyclesAvg;            // Average cycles per sample (last 100ms)
+  uint32_t  CyclesMax;            // Max. cycles per sample (since reset)
+  uint16_t  LoadPc_x10;           // CPU load of audio ISR, running average (% x10)
+  uint32_t  SynthProcessMax;      // Max. SynthProcess() execution time (since reset)
+  uint32_t  OverrunCount;         // Number of late/missed audio interrupts
+  uint32_t  SampleRate_Hz;        // Audio sample rate (Hz)
+
+} AudioIsrStats_t;
+
+// Voice status, sent to the master in reply to a status poll -- see SendStatusReply()
+typedef  struct  voice_status
+{
+  uint8_t   Env1Phase;            // ENV1 segment (ENV_IDLE .. ENV_RELEASE)
+  uint8_t   Env1Level;            // ENV1 output level (0..127)
+  uint8_t   OutputLevel;          // Audio output level (0..127)
+  uint8_t   LoadPc;               // Audio ISR CPU load (%), 0 if not monitored
+  uint8_t   NotePlaying;          // MIDI note number of last note on
+
+} VoiceStatus_t;
+
+// MIDI IN message queue entry -- see MidiReceive() and MidiInputService()
+typedef  struct  midi_rx_message
+{
+  uint32_t  Time_us;              // Arrival time-stamp, TimeStamp_us()
+  uint8_t   Length;               // Message length (bytes)
+  uint8_t   Data[MIDI_MSG_MAX_LENGTH];  // Message bytes, status byte first
+
+} MidiRxMessage_t;
+
+// Note latency trace stages (histograms) -- see NOTE_LATENCY_TRACE and SendLatencyReply()
+enum  Note_Latency_Stages
+{
+  LATENCY_RX_TO_TRIGGER = 0,  // Note-On receipt to envelope trigger (SynthProcess)
+  LATENCY_TRIGGER_TO_AUDIO,   // Envelope trigger to first audible sample (audio ISR)
+  LATENCY_RX_TO_AUDIO,        // Note-On receipt to first audible sample
+  LATENCY_STAGES
+};
+
+// Note latency trace state of a voice (SynthVoice_t.TraceState)
+enum  Note_Latency_Trace_States
+{
+  TRACE_IDLE = 0,             // No note being traced
+  TRACE_NOTE_RCVD,            // Note-On received, envelope not yet triggered
+  TRACE_TRIGGERED,            // Envelope triggered, output level still zero
+  TRACE_AUDIBLE               // First audible sample rendered (set by audio ISR)
+};
+
+#define LATENCY_HIST_BINS    8       // Histogram bins:  < 32, 64, 128 .. 2048, >= 2048 us
+#define LATENCY_BIN0_US      32      // Upper limit of first bin (us);  doubled per bin
+
+// Note latency histogram -- time unit is microseconds
+typedef  struct  note_latency_histogram
+{
+  uint32_t  Count;                // Number of notes measured
+  uint32_t  Total_us;             // Sum of latencies (for average)
+  uint32_t  Max_us;               // Max. latency
+  uint16_t  Bin[LATENCY_HIST_BINS];  // Notes per bin (saturated at 0xFFFF)
+
+} LatencyHist_t;
+
+// Envelope generator state (ENV1 or ENV2) -- see AmpldEnvelopeGenerator()
+typedef  struct  envelope_gen_state
+{
+  uint8_t   Segment;              // Envelope segment (aka "phase"), ENV_IDLE .. ENV_RELEASE
+  uint32_t  PhaseTimer;           // Time elapsed in envelope phase (ms)
+  fixed_t   SustainLevel;         // Envelope sustain level, norm. (0 ~ 1.000)
+  fixed_t   DecayCoeff;           // 1 / time-constant (ms), time-const = 20% of seg.
+  fixed_t   AmpldDelta;           // Step change in Env Ampld in 1ms
+  fixed_t   AmpldMaximum;         // Peak value of Envelope Ampld
+  fixed_t   Output;               // Envelope output level, normalized (0 ~ 1.0)
+
+} EnvelopeGen_t;
+
+// Synth engine voice state -- one per voice hosted (SYNTH_VOICE_COUNT), m_Voice[] in
+// "m0_synth_engine".  Members declared volatile are accessed by the audio ISR.
+typedef  struct  synth_voice_state
+{
+  uint32_t  OscStepInit[6];       // Osc phase step values at Note-On
+  uint32_t  OscStepDetune[6];     // Osc phase step values with de-tune applied
+  bool      OscMuted[6];          // True if osc freq > m_MaxOscFreq
+  uint16_t  OscAmpldModn[6];      // Osc ampld modulation x1024 (0..1024)
+  uint16_t  MixerLevel[6];        // Mixer input levels x1000 (0..1000)
+  const fixed_t  *OscModnSource[6];  // Osc ampld modulation source signals
+  uint32_t  OscStepSkip[6];       // Osc phase step at last active list update
+  uint8_t   OscActiveMask;        // Bit mask of osc's in active list (bit0 = osc 0)
+  uint32_t  SampleCountPrev;      // Audio sample count at last active list update
+  fixed_t   FreqDevnLast;         // Osc freq deviation factor at last update
+  uint8_t   DirtyFlags;           // Derived data to be re-calculated (DIRTY_xxx)
+  bool      LimiterNeeded;        // True if mixer output can exceed limiter level
+
+  EnvelopeGen_t  Env1;            // Envelope Generator #1 (amplitude)
+  EnvelopeGen_t  Env2;            // Envelope Generator #2 (transient)
+  short     ContourSegment;       // Contour envelope segment (aka phase)
+  uint32_t  ContourTimer;         // Time elapsed in active contour phase (ms)
+  fixed_t   ContourDelta;         // Step change in contour output level per millisecond
+  fixed_t   ContourStartLevel;    // Contour output level at start of contour (0..+1.0)
+  fixed_t   ContourHoldLevel;     // Contour output level maintained at end of ramp
+  fixed_t   ContourOutput;        // Contour EG output, normalized (0 ~ 1.0)
+  short     RampState;            // Vibrato Ramp state (0: idle .. 3: ramping down)
+  uint32_t  RampTimer_ms;         // Vibrato Ramp delay timer (ms)
+  fixed_t   RampStep;             // Vibrato Ramp step change in output per 5 ms
+  fixed_t   RampOutput;           // Vibrato Ramp output level,  normalized (0..+1)
+  fixed_t   OutputAmpld;          // Audio output level, normalized
+  fixed_t   SmoothExprnLevel;     // Expression level, normalized, smoothed
+  fixed_t   KeyVelocity;          // Note-On Velocity, normalized  (0 ~ 1.0)
+
+  bool      TriggerAttack1;       // Signal to put ENV1 into attack
+  bool      TriggerRelease1;      // Signal to put ENV1 into release
+  bool      TriggerAttack2;       // Signal to put ENV2 into attack
+  bool      TriggerRelease2;      // Signal to put ENV2 into release
+  bool      TriggerContour;       // Signal to start Contour generator
+  bool      TriggerReset;         // Signal to reset Contour generator
+  bool      LegatoNoteChange;     // Signal Legato note change to Vibrato func.
+  uint8_t   NoteOn;               // TRUE if Note ON, ie. "gated", else FALSE
+  uint8_t   NotePlaying;          // MIDI note number of note playing
+  uint32_t  TraceRxTime;          // Note latency trace:  Note-On receipt time (us)
+  uint32_t  TraceTrigTime;        // Note latency trace:  envelope trigger time (us)
+
+  volatile uint32_t  OscAngle[6];      // Osc phase angle (2^32 = 1 cycle)
+  volatile uint32_t  OscStep[6];       // Osc phase increment per sample
+  volatile uint16_t  OscGain[6];       // Osc gain = ampld modn x mixer level (0..1000)
+  volatile uint8_t   ActiveOsc[6];     // List of audible osc's
+  volatile uint8_t   ActiveOscCount;   // Number of osc's in active list (0..6)
+  volatile uint16_t  OutputLevel;      // Audio output level x1000 (0..1000)
+  volatile uint32_t  OutputLevelFine;  // Output level, ramped per sample (x1000 x 2^16)
+  volatile int32_t   OutputRampStep;   // Output level ramp step per sample (x 2^16)
+  volatile uint8_t   OutputRampCount;  // Output level ramp samples remaining
+  volatile uint32_t  TraceAudioTime;   // Note latency trace:  first audible sample (us)
+  volatile uint8_t   TraceState;       // Note latency trace state (TRACE_xxx)
+
+} SynthVoice_t;
+
 extern  const   PatchParamTable_t  g_PresetPatch[];
 extern  PatchParamTable_t  g_Patch;   // Active patch data
 
-extern  const   short     g_sine_wave[];
-extern  const   uint16_t  g_base2exp[];
 extern  const   float     g_FreqMultConst[];
 extern  const   uint16_t  g_MixerInputLevel[];
 
@@ -242,17 +469,27 @@ extern  bool     g_MidiRxSignal;       // Signal MIDI message received
 extern  bool     g_EEpromFaulty;       // True if EEPROM error or not fitted
 extern  uint8_t  g_LegatoMode;         // Switch ON or OFF using MIDI CC68 msg
 extern  int      g_DebugData;
-
-extern  const  float  g_NoteFrequency[];
+extern  uint16_t g_SampleRate;         // Audio sample rate (Hz): 32000, 40000 or 48000
+extern  uint32_t g_MidiRxOverruns;     // MIDI IN messages lost (queue or UART buffer full)
 
 // Functions defined in main source file ...
 //
 int    GetNumberOfPresets(void);
 void   PresetSelect(uint8_t preset);
 void   MidiInputService();
+void   MidiReceive();
+void   MidiRxParse(uint8_t msgByte);
+extern "C" int  sysTickHook(void);  // Arduino core SysTick hook (MIDI IN parser)
+uint32_t  TimeStamp_us();
+uint8_t  MidiChannelVoice(uint8_t statusByte);
 void   ProcessMidiMessage(uint8_t *midiMessage, short msgLength);
 void   ProcessControlChange(uint8_t *midiMessage);
 void   ProcessMidiSystemExclusive(uint8_t *midiMessage, short msgLength);
+void   ReceivePatchData(uint8_t *pData, short count);
+void   VoiceStatusService();
+void   SendStatusReply(uint8_t voice);
+void   SendLatencyReply(uint8_t chan, uint8_t stage, bool reset);
+void   SysExUnpackData(uint8_t *pDest, uint8_t *pSrc, short nbytes);
 int    MIDI_GetMessageLength(uint8_t statusByte);
 void   CVinputService();
 void   DefaultConfigData(void);
@@ -261,19 +498,30 @@ void   StoreConfigData(void);
 
 // Functions defined in "m0_synth_engine.c" ...
 //
+void   SynthInit();
 void   SynthPrepare();
-void   SynthNoteOn(uint8_t note, uint8_t vel);
-void   SynthNoteChange(uint8_t note);
-void   SynthNoteOff(uint8_t note);
+void   SynthPatchLoad(const PatchParamTable_t *patch);
+void   SynthNoteOn(uint8_t voice, uint8_t note, uint8_t vel);
+void   SynthNoteChange(uint8_t voice, uint8_t note);
+void   SynthNoteOff(uint8_t voice, uint8_t note);
 void   SynthPitchBend(int data14);
 void   SynthExpression(unsigned data14);
 void   SynthModulation(unsigned data14);
 void   SynthProcess();
 void   SynthSetOscFrequency(float freq_Hz);
 void   SynthSetReverbMix(uint8_t rvbmix_pc);
-void   SynthTriggerAttack();
-void   SynthTriggerRelease();
+void   SynthSetReverbMode(uint8_t mode);
+void   SynthMarkDirty(uint8_t flags);
+void   SynthTriggerAttack(uint8_t voice);
+void   SynthTriggerRelease(uint8_t voice);
 void   SynthLFO_PhaseSync();
+void   SynthAudioStartDMA();
+void   SynthGetIsrStats(AudioIsrStats_t *pStats, bool reset);
+void   SynthGetStatus(uint8_t voice, VoiceStatus_t *pStatus);
+void   SynthLatencyTraceStart(uint8_t voice, uint32_t rxTime);
+void   SynthGetLatencyHist(uint8_t stage, LatencyHist_t *pHist, bool reset);
+bool   SynthSetSampleRate(uint16_t rate_Hz);
+void   SynthBenchmarkAudio();
 
 
 #endif // M0_SYNTH_DEF_H
@@ -11,8 +11,12 @@
  */
 #include <SPI.h>
 #include "m0_synth_def.h"
+#include "m0_synth_tables.h"
+#if !USE_DMA_AUDIO_OUTPUT
+#include <fast_samd21_tc3.h>
+#endif
 
-// Macros for manipulating 32-bit (12:20) fixed-point numbers, type fixed_t (long).
+// Macros for manipulating 32-bit (12:20) fixed-point numbers, type fixed_t (int32_t).
 // Integer part:      12 bits, signed, max. range +/-2047
 // Fractional part:   20 bits, precision: +/-0.000001 (approx.)
 #define IntToFixedPt(i)     (i << 20)                    // convert int to fixed-pt
@@ -22,131 +26,332 @@
 #define FractionPart(z,n)   ((z & 0xFFFFF) >> (20 - n))  // get n MS bits of fractional part
 #define MultiplyFixed(v,w)  (((int64_t)v * w) >> 20)     // product of two fixed-pt numbers
 
-fixed_t  ReverbDelayLine[REVERB_DELAY_MAX_SIZE];  // fixed-point samples
+// Oscillator phase angle is a 32-bit unsigned integer;  one cycle = 2^32, so the phase
+// wraps naturally on overflow.  The wave-table index is the top 11 bits (2048 samples),
+// the remaining 21 bits are the fraction used for interpolation.
+// Steps are derived from g_NoteStep (at SAMPLE_RATE_DEFAULT) scaled by m_OscStepScale.
+#define OSC_PHASE_CYCLE     4294967296.0f                // 2^32 = one cycle (float)
+#define OSC_PHASE_SHIFT     (32 - WAVE_TABLE_SIZE_LOG2)  // = 21 for 2048 samples
+#define SINE_QUARTER_SIZE   (WAVE_TABLE_SIZE / 4)        // quarter-wave table size (512)
+#define OSC_STEP_MAX        ((uint32_t)(MAX_OSC_FREQ_FACTOR * OSC_PHASE_CYCLE))  // mute above
+
+// Execution time is measured using the SysTick counter, which is a 24-bit down-counter
+// clocked at F_CPU, reloaded every millisecond by the Arduino core (for millis()).
+// Intervals measured must therefore be less than 1 ms.
+#define CYCLE_COUNT()       (SysTick->VAL)               // read the cycle counter
+#define ISR_ENTRY_EXIT_CYCLES   30                       // interrupt entry + exit (approx.)
+
+static inline uint32_t  CyclesElapsed(uint32_t tBegin, uint32_t tEnd)
+{
+  if (tBegin >= tEnd)  return  (tBegin - tEnd);
+  return  (tBegin + SysTick->LOAD + 1 - tEnd);  // counter was reloaded
+}
+
+int16_t  ReverbBuffer[REVERB_BUFFER_SIZE];  // reverb delay lines (16-bit samples)
+
+// Reverb network delay line (comb or allpass filter), a segment of ReverbBuffer[].
+typedef struct reverb_delay_line
+{
+  int16_t  *buf;        // first sample of delay line in ReverbBuffer[]
+  uint16_t  len;        // delay line length (samples, prime number)
+  uint16_t  idx;        // read/write index (audio ISR)
+  int16_t   gain;       // feedback gain, Q15 (comb filter only)
+  int16_t   filt;       // loop low-pass filter output (comb filter only)
+} RvbDelayLine_t;
+
+// Network delay line lengths at 48kHz -- all prime (sum <= REVERB_BUFFER_SIZE).
+// Lengths at lower sample rates are scaled, then reduced to the nearest prime number.
+static const uint16_t  c_RvbCombLen48k[REVERB_COMB_COUNT] = { 839, 797, 727, 673 };
+static const uint16_t  c_RvbAllpassLen48k[REVERB_ALLPASS_COUNT] = { 557, 401 };
+
+#if SINE_TABLE_QUARTER_WAVE
+static short  m_SineQuarter[SINE_QUARTER_SIZE + 1];  // quarter-wave sine table (SRAM copy)
+#endif
 
 PatchParamTable_t  g_Patch;     // active patch parameters
 
-static long     m_OscStepInit[6];         // Osc phase step values at Note-On
-static long     m_OscStepDetune[6];       // Osc phase step values with de-tune applied
-static bool     m_OscMuted[6];            // True if osc freq > 0.4 x SAMPLE_RATE_HZ
-static long     m_LFO_PhaseAngle;         // LFO "phase angle" (24:8 bit fixed-point)
-static long     m_LFO_Step;               // LFO "phase step"  (24:8 bit fixed-point)
+uint16_t  g_SampleRate = SAMPLE_RATE_DEFAULT;  // audio sample rate (Hz)
+
+static uint32_t m_IsrPeriodCycles = F_CPU / SAMPLE_RATE_DEFAULT;  // CPU cycles per sample
+static float    m_MaxOscFreq = SAMPLE_RATE_DEFAULT * MAX_OSC_FREQ_FACTOR;  // Hz
+static fixed_t  m_OscStepScale = IntToFixedPt(1);  // = SAMPLE_RATE_DEFAULT / g_SampleRate
+static uint32_t m_IsrBenchCycles;         // Worst-case audio ISR cycles (boot benchmark)
+
+static SynthVoice_t  m_Voice[SYNTH_VOICE_COUNT];  // Voice state (see m0_synth_def.h)
+
+static int32_t  m_LFO_PhaseAngle;         // LFO "phase angle" (24:8 bit fixed-point)
+static int32_t  m_LFO_Step;               // LFO "phase step"  (24:8 bit fixed-point)
 static fixed_t  m_LFO_output;             // LFO output signal, normalized, bipolar (+/-1.0)
-static fixed_t  m_RampOutput;             // Vibrato Ramp output level,  normalized (0..+1)
 static fixed_t  m_ExpressionLevel;        // Expression level, normalized, unipolar (0..+1)
 static fixed_t  m_ModulationLevel;        // Modulation level, normalized, unipolar (0..+1)
 static fixed_t  m_PitchBendFactor;        // Pitch-Bend factor, normalized, bipolar (+/-1.0)
 
-static fixed_t  m_ENV1_Output;            // Envelope Generator #1 output  (0 ~ 1.0)
-static fixed_t  m_ENV2_Output;            // Envelope Generator #2 output  (0 ~ 1.0)
-static fixed_t  m_ContourOutput;          // Contour EG output, normalized (0 ~ 1.0)
-static fixed_t  m_KeyVelocity;            // Note-On Velocity, normalized  (0 ~ 1.0)
-static bool     m_TriggerAttack1;         // Signal to put ENV1 into attack
-static bool     m_TriggerRelease1;        // Signal to put ENV1 into release
-static bool     m_TriggerAttack2;         // Signal to put ENV2 into attack
-static bool     m_TriggerRelease2;        // Signal to put ENV2 into release
-static bool     m_TriggerContour;         // Signal to start Contour generator
-static bool     m_TriggerReset;           // Signal to reset Contour generator
-static bool     m_LegatoNoteChange;       // Signal Legato note change to Vibrato func.
-static uint8_t  m_NoteOn;                 // TRUE if Note ON, ie. "gated", else FALSE
-static uint8_t  m_NotePlaying;            // MIDI note number of note playing
-
 static int      m_RvbDelayLen;            // Reverb. delay line length (samples)
-static fixed_t  m_RvbDecay;               // Reverb. decay factor
+static int16_t  m_RvbDecay;               // Reverb. decay factor, Q15 (single-line mode)
 static uint16_t m_RvbAtten;               // Reverb. attenuation factor (0..128)
 static uint16_t m_RvbMix;                 // Reverb. wet/dry mix ratio (0..128)
+static int      m_RvbIndex;               // index into ReverbBuffer[], single-line mode
+static int      m_RvbPrev;                // previous output from reverb delay line (ISR)
+static RvbDelayLine_t  m_RvbComb[REVERB_COMB_COUNT];  // Reverb network comb filters
+static RvbDelayLine_t  m_RvbAllpass[REVERB_ALLPASS_COUNT];  // Reverb network allpass
+static int16_t  m_RvbInGain;              // Reverb network input gain, Q15
+
+static PatchParamTable_t  m_PatchShadow;  // Next patch, swapped into g_Patch by PatchSwapControl()
+static uint8_t  m_PatchSwapState;         // Patch swap state (PATCH_SWAP_xxx)
+static uint16_t m_PatchFadeGain = 1024;   // Patch swap fade gain x1024 (0..1024)
+static uint8_t  m_AmpldControlSource;     // Audio ampld control source (AMPLD_CTRL_xxx)
+static uint8_t  m_OscModnInvert;          // Bit mask of osc's with inverted modn source
+static fixed_t  m_LFO_AM_Level;           // LFO ampld modulation level, normalized (0..+1)
+static const fixed_t  m_ModnFixedMax = IntToFixedPt(1000) >> 10;  // Fixed ampld modn (1000)
+
+#define PATCH_SWAP_IDLE        0     // No patch change pending
+#define PATCH_SWAP_FADE_OUT    1     // Fading out before patch swap
+#define PATCH_SWAP_FADE_IN     2     // Fading in after patch swap
+#define PATCH_FADE_STEP   (1024 / PATCH_FADE_TIME_MS)   // fade gain step per ms
+
+typedef fixed_t (* pfnAudioKernel)(void);  // pointer to audio sample render function
+
+static void  AudioKernelSelect(void);
+static fixed_t  AudioKernelMute(void);
 
 volatile uint8_t  v_SynthEnable;          // Signal to enable synth sampling routine
-volatile long     v_OscAngle[6];          // Osc sample pos'n in wave-table [16:16]
-volatile long     v_OscStep[6];           // Osc sample pos'n increment [16:16]
-volatile uint16_t v_OscAmpldModn[6];      // Osc ampld modulation x1024 (0..1024)
-volatile uint16_t v_MixerLevel[6];        // Mixer input levels x1000 (0..1000)
+volatile pfnAudioKernel  v_AudioKernel = AudioKernelMute;  // Audio render kernel
+volatile uint32_t v_SampleCount;          // Audio samples computed (free-running count)
 volatile uint16_t v_MixerOutGain;         // Mixer output gain x10  (range 10..128)
 volatile fixed_t  v_LimiterLevelPos;      // Audio limiter level (pos. peak, normalized)
 volatile fixed_t  v_LimiterLevelNeg;      // Audio limiter level (neg. peak, normalized)
-volatile uint16_t v_OutputLevel;          // Audio output level x1000 (0..1000)
+#if AUDIO_LEVEL_RAMP
+static uint8_t    m_RampSamples = SAMPLE_RATE_DEFAULT / 1000;  // Samples per 1ms ramp
+static int32_t    m_RampStepRecip = 65536 / (SAMPLE_RATE_DEFAULT / 1000);  // 2^16 / samples
+#endif
+
+#if AUDIO_ISR_LOAD_MONITOR
+volatile uint32_t v_IsrCyclesSum;         // Audio ISR cycles accumulated in interval
+volatile uint32_t v_IsrSampleCount;       // Audio samples computed in interval
+volatile uint32_t v_IsrCyclesMin = 0xFFFFFFFF;  // Audio ISR min. cycles per sample
+volatile uint32_t v_IsrCyclesMax;         // Audio ISR max. cycles per sample
+volatile uint32_t v_IsrOverruns;          // Count of late (missed) audio interrupts
+static uint32_t   m_IsrCyclesAvg;         // Audio ISR average cycles per sample
+static uint16_t   m_IsrLoad_x10;          // Audio ISR CPU load, running average (% x10)
+static uint32_t   m_SynthProcessMax;      // SynthProcess() max. execution time (cycles)
+#endif
+
+// Look-up tables generated at compile-time -- see "m0_synth_tables.h"...
+//
+// Sine wave-table:  Peak value +/-SINE_TABLE_PEAK (32000).
+// Full cycle:  WAVE_TABLE_SIZE samples, plus 1 guard sample (= first sample) for
+// interpolation.  Quarter cycle:  WAVE_TABLE_SIZE/4 + 1 samples, incl. peak;  copied
+// into SRAM (m_SineQuarter[]) by SynthPrepare(), the other 3 quarters are derived by
+// symmetry.  See SineTableRead() and OscWaveLookup().
+//
+#if SINE_TABLE_QUARTER_WAVE
+constexpr ConstTable<int16_t, SINE_QUARTER_SIZE + 1>  g_sine_quarter =
+    SineTableGen(MakeIndexSeq<SINE_QUARTER_SIZE + 1>::type(), WAVE_TABLE_SIZE);
+#else
+constexpr ConstTable<int16_t, WAVE_TABLE_SIZE + 1>  g_sine_wave =
+    SineTableGen(MakeIndexSeq<WAVE_TABLE_SIZE + 1>::type(), WAVE_TABLE_SIZE);
+#endif
+
+// Lookup table to transform linear variable to base-2 exponential.
+// Index value range 0..1024 (integer) represents linear axis range -1.0 ~ +1.0.
+// Lookup value range is 0.5 to 2.0 (fixed point).  Centre (zero) value is 1.00.
+//
+// <!>  g_base2exp.v[] values are in 18:14 bit fixed-point format.
+//      Shift left 6 bit places to convert to 12:20 fixed-point.
+//      ````````````````````````````````````````````````````````
+// For higher precision, where required, use the function: Base2Exp()
+//
+constexpr ConstTable<uint16_t, BASE2EXP_TABLE_SIZE>  g_base2exp =
+    Base2ExpTableGen(MakeIndexSeq<BASE2EXP_TABLE_SIZE>::type());
 
 // Look-up table giving frequencies of notes on the chromatic scale.
 // The array covers a 9-octave range beginning with C0 (MIDI note number 12),
 // up to C9 (120).  Subtract 12 from MIDI note number to get table index.
 // Table index range:  0..108
 //
-const  float  g_NoteFrequency[] =
-{
-    // C0      C#0       D0      Eb0       E0       F0      F#0       G0
-    16.3516, 17.3239, 18.3540, 19.4455, 20.6017, 21.8268, 23.1247, 24.4997,
-    // Ab0      A0      Bb0       B1       C1      C#1       D1      Eb1
-    25.9566, 27.5000, 29.1353, 30.8677, 32.7032, 34.6478, 36.7081, 38.8909,
-    // E1       F1      F#1       G1      Ab1       A1      Bb1       B1
-    41.2034, 43.6535, 46.2493, 48.9994, 51.9131, 55.0000, 58.2705, 61.7354,
-    // C2      C#2       D2      Eb2       E2       F2      F#2       G2
-    65.4064, 69.2957, 73.4162, 77.7817, 82.4069, 87.3071, 92.4986, 97.9989,
-    // Ab2      A2      Bb2       B2       C3      C#3       D3      Eb3
-    103.826, 110.000, 116.541, 123.471, 130.813, 138.591, 146.832, 155.563,
-    // E3       F3      F#3       G3      Ab3       A3      Bb3       B3
-    164.814, 174.614, 184.997, 195.998, 207.652, 220.000, 233.082, 246.942,
-    // C4      C#4       D4      Eb4       E4       F4      F#4       G4
-    261.626, 277.183, 293.665, 311.127, 329.628, 349.228, 369.994, 391.995,
-    // Ab4      A4      Bb4       B4       C5      C#5       D5      Eb5
-    415.305, 440.000, 466.164, 493.883, 523.251, 554.365, 587.330, 622.254,
-    // E5       F5      F#5       G5      Ab5       A5      Bb5       B5
-    659.255, 698.456, 739.989, 783.991, 830.609, 880.000, 932.328, 987.767,
-    // C6      C#6       D6      Eb6       E6       F6      F#6       G6
-    1046.50, 1108.73, 1174.66, 1244.51, 1318.51, 1396.91, 1479.98, 1567.98,
-    // Ab6      A6      Bb6       B6       C7      C#7       D7      Eb7
-    1661.22, 1760.00, 1864.66, 1975.53, 2093.00, 2217.46, 2349.32, 2489.02,
-    // E7       F7      F#7       G7      Ab7       A7      Bb7       B7
-    2637.02, 2793.83, 2959.96, 3135.96, 3322.44, 3520.00, 3729.31, 3951.07,
-    // C8      C#8       D8      Eb8       E8       F8      F#8       G8
-    4186.01, 4434.92, 4698.64, 4978.04, 5274.04, 5587.66, 5919.92, 6271.92,
-    // Ab8      A8      Bb8       B8       C9
-    6644.88, 7040.00, 7458.62, 7902.14, 8372.02
-};
+constexpr ConstTable<float, NOTE_TABLE_SIZE>  g_NoteFrequency =
+    NoteFreqTableGen(MakeIndexSeq<NOTE_TABLE_SIZE>::type());
+
+// Look-up table giving osc phase steps (2^32 = 1 cycle) for each note (as above) and
+// each Osc Freq Multiplier option, at the default sample rate (SAMPLE_RATE_DEFAULT).
+// Table entry:  g_NoteStep.v[note - 12][OscFreqMult]
+//
+constexpr ConstTable<uint32_t[OSC_FREQ_MULT_COUNT], NOTE_TABLE_SIZE>  g_NoteStep =
+    NoteStepTableGen(MakeIndexSeq<NOTE_TABLE_SIZE * OSC_FREQ_MULT_COUNT>::type());
 
 // Set of 12 fixed values for Osc. Frequency Mutiplier:
-const  float  g_FreqMultConst[] =
-        { 0.5, 1.0, 1.333333, 1.5, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0 };
+const  float  g_FreqMultConst[] = { OSC_FREQ_MULT_VALUES };
 
 // Values for Audio Ampld Level... 0 + 16 fixed levels on 3dB log scale
 const  uint16_t  g_AmpldLevelLogScale_x1000[] =
         { 0, 5, 8, 11, 16, 22, 31, 44, 63, 88, 125, 177, 250, 353, 500, 707, 1000 };
 
 
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     One-time initialization of the synth engine hardware and data:
+ *               SPI port (DAC), sine wave-table copy in SRAM and voice state.
+ *               Called by setup() before the first PresetSelect().
+ */
+void  SynthInit()
+{
+  static bool  initDone;
+  SynthVoice_t  *pv;
+  int  voice, osc;
+
+  if (initDone)  return;  // once only
+
+  for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+  {
+    pv = &m_Voice[voice];
+    for (osc = 0;  osc < 6;  osc++)  { pv->ActiveOsc[osc] = osc; }
+    pv->ActiveOscCount = 6;
+    pv->OscActiveMask = 0x3F;
+    pv->LimiterNeeded = TRUE;
+    pv->DirtyFlags = DIRTY_ALL;
+  }
+
+  SPI.begin();
+  SPI.beginTransaction(SPISettings(20000000, MSBFIRST, SPI_MODE0));
+#if SINE_TABLE_QUARTER_WAVE
+  memcpy(m_SineQuarter, g_sine_quarter.v, sizeof(m_SineQuarter));  // flash to SRAM
+#endif
+  initDone = TRUE;
+}
+
+
 /*`````````````````````````````````````````````````````````````````````````````````````````````````
  * Function:     Initialization of "constant" synth data environment.
- *               Called by PresetSelect().
- *               Must be called after a change in any config. parameter.
+ *               Called by SynthPatchLoad() if the synth is not running, by SynthSetSampleRate()
+ *               and by MIDI "All Sound Off".  Must be called after a change in any config.
+ *               parameter.  Kills the note playing.  A pending patch swap is completed.
  */
 void  SynthPrepare()
 {
-  static bool SPI_setupDone;
-  float   rvbDecayRatio;
+  SynthVoice_t  *pv;
+  int  voice;
 
   v_SynthEnable = 0;      // Disable the synth tone-generator
+  AudioKernelSelect();
 
-  if (SPI_setupDone)  SPI.endTransaction();  // already begun
-  else  // initialize SPI -- once only
+  if (m_PatchSwapState != PATCH_SWAP_IDLE)  // complete patch swap now
   {
-    SPI.begin();
-    SPI.beginTransaction(SPISettings(20000000, MSBFIRST, SPI_MODE0));
-    SPI_setupDone = TRUE;
+    if (m_PatchSwapState == PATCH_SWAP_FADE_OUT)
+      memcpy(&g_Patch, &m_PatchShadow, sizeof(PatchParamTable_t));
+    m_PatchSwapState = PATCH_SWAP_IDLE;
   }
+  m_PatchFadeGain = 1024;
 
-  m_NoteOn = FALSE;       // No note playing
-  m_TriggerRelease1 = 1;  // Reset ENV1
-  m_TriggerRelease2 = 1;  // Reset ENV2
+  for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+  {
+    pv = &m_Voice[voice];
+    pv->NoteOn = FALSE;       // No note playing
+    pv->TriggerRelease1 = 1;  // Reset ENV1
+    pv->TriggerRelease2 = 1;  // Reset ENV2
+    pv->KeyVelocity = (IntToFixedPt(1) * 80) / 100;  // in case CV mode selected
+    pv->DirtyFlags = DIRTY_ALL;  // Re-calculate all derived data at control rate
+  }
   m_ExpressionLevel = 0;  // Mute audio output
   m_ModulationLevel = (IntToFixedPt(1) * 50) / 100;  // in case no mod'n signal rx'd
-  m_KeyVelocity = (IntToFixedPt(1) * 80) / 100;  // in case CV mode selected
 
-  // Calculate reverb effect constants...
-  m_RvbDelayLen = (int) (REVERB_LOOP_TIME_SEC * SAMPLE_RATE_HZ);  // loop time is 0.04f
-  rvbDecayRatio = (float) REVERB_LOOP_TIME_SEC / REVERB_DECAY_TIME_SEC;
-  m_RvbDecay = FloatToFixed( powf(0.001f, rvbDecayRatio) );  // = 0.83 (approx)
-  m_RvbAtten = ((uint16_t)REVERB_ATTENUATION_PC << 7) / 100;  // = 0..127
+  ReverbPrepare();
   m_RvbMix = ((uint16_t)g_Config.ReverbMix_pc << 7) / 100;  // = 0..127
 
   v_SynthEnable = 1;      // Let 'er rip, Boris!
+  AudioKernelSelect();
+}
+
+
+/*
+ * Function:     Load a new patch (e.g. preset selected by MIDI Program Change).
+ *
+ * Entry args:   patch = pointer to patch parameter table (flash or RAM) to be activated
+ *
+ * If the synth is running, the patch is copied into a "shadow" table, then swapped into
+ * the active patch (g_Patch) by the SynthProcess() task:  The audio output is faded out,
+ * the patch is swapped at a control-rate (1ms) boundary and the output is faded in again,
+ * each over PATCH_FADE_TIME_MS.  The note playing, envelopes and reverb tail continue,
+ * so there is no click and no restart of the synth engine.  Program-change latency is at
+ * most PATCH_FADE_TIME_MS + 2 ms.  If another patch is loaded during the fade, it
+ * replaces the pending patch.
+ *
+ * If the synth is not yet running (at start-up), the patch is activated immediately.
+ */
+void  SynthPatchLoad(const PatchParamTable_t *patch)
+{
+  if (!v_SynthEnable)
+  {
+    memcpy(&g_Patch, patch, sizeof(PatchParamTable_t));
+    SynthPrepare();
+    return;
+  }
+
+  memcpy(&m_PatchShadow, patch, sizeof(PatchParamTable_t));
+  m_PatchSwapState = PATCH_SWAP_FADE_OUT;  // (also if fade-in in progress)
+}
+
+
+/*
+ * Function:     Patch swap state machine, called by SynthProcess() at 1ms intervals,
+ *               before the audio level controller which applies m_PatchFadeGain.
+ *
+ * The patch is swapped 1ms after the fade gain reaches zero, i.e. when the ISR output
+ * level ramp (see AudioLevelController) has also reached zero.
+ * At the swap, data derived from the patch is re-calculated:  osc phase steps for the
+ * note playing (Osc Freq Mult may differ) and all "dirty" data, i.e. osc frequency and
+ * ampld modulation are updated immediately, not at the next 5ms interval (all voices).
+ */
+void  PatchSwapControl()
+{
+  SynthVoice_t  *pv;
+  int  voice;
+
+  if (m_PatchSwapState == PATCH_SWAP_FADE_OUT)
+  {
+    if (m_PatchFadeGain > PATCH_FADE_STEP)  m_PatchFadeGain -= PATCH_FADE_STEP;
+    else if (m_PatchFadeGain != 0)  m_PatchFadeGain = 0;  // output ramps to 0 in next 1ms
+    else  // faded out -- swap patch
+    {
+      memcpy(&g_Patch, &m_PatchShadow, sizeof(PatchParamTable_t));
+      for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+      {
+        pv = &m_Voice[voice];
+        SynthNoteChange(voice, pv->NotePlaying);
+        pv->DirtyFlags = DIRTY_ALL;
+        OscFreqModulation(pv);   // apply new patch now, before fade-in
+        OscAmpldModulation(pv);
+      }
+      m_PatchSwapState = PATCH_SWAP_FADE_IN;
+    }
+  }
+  else if (m_PatchSwapState == PATCH_SWAP_FADE_IN)
+  {
+    m_PatchFadeGain += PATCH_FADE_STEP;
+    if (m_PatchFadeGain >= 1024)
+    {
+      m_PatchFadeGain = 1024;
+      m_PatchSwapState = PATCH_SWAP_IDLE;
+    }
+  }
+}
+
+
+/*
+ * Function:     Signal that synth data derived from patch or config parameters must be
+ *               re-calculated, e.g. after a parameter is changed by a MIDI CC message.
+ *               The data is re-calculated by the SynthProcess() task which uses it.
+ *
+ * Entry args:   flags = bit-wise OR of one or more DIRTY_xxx flags (see m0_synth_def.h)
+ *
+ * The flags are set in every voice;  each voice re-calculates its own derived data.
+ */
+void  SynthMarkDirty(uint8_t flags)
+{
+  int  voice;
+
+  for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+  {
+    m_Voice[voice].DirtyFlags |= flags;
+  }
 }
 
 
@@ -154,41 +359,46 @@ void  SynthPrepare()
  * Function:     If a note is already playing, perform a Legato note change;
  *               otherwise initiate a new note.
  *
- * Entry args:   noteNum  = MIDI standard note number, range: 12 ~ 120 (C0..C9),
+ * Entry args:   voice    = synth engine voice (0..SYNTH_VOICE_COUNT-1)
+ *               noteNum  = MIDI standard note number, range: 12 ~ 120 (C0..C9),
  *                          e.g. note #60 = C4 = middle-C.
  *               velocity = MIDI velocity value (0..127)
  *
- * Output data:  m_KeyVelocity (usage dependent on synth settings)
+ * Output data:  KeyVelocity of the voice (usage dependent on synth settings)
  *
  * When a new note is initiated, the function prepares the synth wave-table oscillators
  * to play the given note, then triggers the envelope shaper to start the 'Attack' phase.
  */
-void  SynthNoteOn(uint8_t noteNum, uint8_t velocity)
+void  SynthNoteOn(uint8_t voice, uint8_t noteNum, uint8_t velocity)
 {
-  if (!m_NoteOn)    // Note OFF -- Initiate a new note...
+  SynthVoice_t  *pv = &m_Voice[voice];
+
+  if (!pv->NoteOn)    // Note OFF -- Initiate a new note...
   {
-    SynthNoteChange(noteNum);  // Set OSC frequencies, etc
-    m_KeyVelocity = IntToFixedPt((int) velocity) / 128;  // normalized
+    SynthNoteChange(voice, noteNum);  // Set OSC frequencies, etc
+    pv->KeyVelocity = IntToFixedPt((int) velocity) / 128;  // normalized
     // A square-law curve may be applied to velocity to approximate exponential
     if (APPLY_VELOCITY_EXPL_CURVE)
-      m_KeyVelocity = MultiplyFixed(m_KeyVelocity, m_KeyVelocity);
-    m_LegatoNoteChange = 0;    // Not a Legato event
-    SynthTriggerAttack();
+      pv->KeyVelocity = MultiplyFixed(pv->KeyVelocity, pv->KeyVelocity);
+    pv->LegatoNoteChange = 0;    // Not a Legato event
+    SynthTriggerAttack(voice);
   }
   else  // Note already playing -- Legato note change
   {
-    SynthNoteChange(noteNum);  // Adjust OSC1 and OSC2 frequencies
-    m_LegatoNoteChange = 1;    // Signal Note-Change event (for vibrato fn)
+    SynthNoteChange(voice, noteNum);  // Adjust OSC1 and OSC2 frequencies
+    pv->LegatoNoteChange = 1;    // Signal Note-Change event (for vibrato fn)
   }
 }
 
 
-void  SynthTriggerAttack()
+void  SynthTriggerAttack(uint8_t voice)
 {
-  m_TriggerAttack1 = 1;
-  m_TriggerAttack2 = 1;
-  m_TriggerContour = 1;
-  m_NoteOn = TRUE;
+  SynthVoice_t  *pv = &m_Voice[voice];
+
+  pv->TriggerAttack1 = 1;
+  pv->TriggerAttack2 = 1;
+  pv->TriggerContour = 1;
+  pv->NoteOn = TRUE;
 }
 
 
@@ -198,84 +408,88 @@ void  SynthTriggerAttack()
  *               This function may be used where a "legato" effect is required.
  *               (See also: SynthNoteOn() function.)
  *
- * Entry args:   noteNum = MIDI standard note number. (Note #60 = C4 = middle-C.)
+ * Entry args:   voice   = synth engine voice (0..SYNTH_VOICE_COUNT-1)
+ *               noteNum = MIDI standard note number. (Note #60 = C4 = middle-C.)
  *               The synth supports note numbers in the range: 12 (C0) to 120 (C9).
  */
-void  SynthNoteChange(uint8_t noteNum)
+void  SynthNoteChange(uint8_t voice, uint8_t noteNum)
 {
-  float   oscFreq, freqMult;
-  int32_t tableSize, oscStep;  // 16:16 bit fixed point
+  SynthVoice_t  *pv = &m_Voice[voice];
+  uint32_t  oscStep;           // 2^32 = 1 cycle
   int     osc;
 
   // Ensure note number is within synth range (12 ~ 108)
   noteNum &= 0x7F;
   if (noteNum > 120)  noteNum -= 12;   // too high
   if (noteNum < 12)   noteNum += 12;   // too low
-  m_NotePlaying = noteNum;
+  pv->NotePlaying = noteNum;
 
   for (osc = 0;  osc < 6;  osc++)  // Update 6 oscillators...
   {
-    // Convert MIDI note number to frequency (Hz) and apply OscFreqMult param.
-    freqMult = g_FreqMultConst[g_Patch.OscFreqMult[osc]];  // float
-    oscFreq = g_NoteFrequency[noteNum-12] * freqMult;
-    if (oscFreq > MAX_OSC_FREQ_HZ)  m_OscMuted[osc] = TRUE;
-    else  m_OscMuted[osc] = FALSE;
-
-    // Initialize oscillator "phase step" for use in audio ISR
-    tableSize = (long) WAVE_TABLE_SIZE << 16;  // convert to 16:16 fixed-pt
-    oscStep = (long) ((tableSize * oscFreq) / SAMPLE_RATE_HZ);
-    m_OscStepInit[osc] = oscStep;
+    // Look up oscillator "phase step" for the note and OscFreqMult param, for use in
+    // audio ISR.  Table steps are for the default sample rate -- scale to actual rate.
+    oscStep = g_NoteStep.v[noteNum-12][g_Patch.OscFreqMult[osc]];
+    oscStep = (uint32_t) MultiplyFixed(oscStep, m_OscStepScale);
+    if (oscStep > OSC_STEP_MAX)  pv->OscMuted[osc] = TRUE;  // osc freq > 0.375 x Fs
+    else  pv->OscMuted[osc] = FALSE;
+    pv->OscStepInit[osc] = oscStep;
   }
+  pv->DirtyFlags |= DIRTY_OSC_DETUNE | DIRTY_MIXER_LEVELS;
 }
 
 
 /*
  * Function:     End the note playing, if it matches the given note number.
  *
- * Entry args:   noteNum = MIDI standard note number of note to be ended.
+ * Entry args:   voice   = synth engine voice (0..SYNTH_VOICE_COUNT-1)
+ *               noteNum = MIDI standard note number of note to be ended.
  *
  * The function puts envelope shapers into the 'Release' phase. The note will be
  * terminated by the synth process (B/G task) when the release time expires, or if
  * a new note is initiated prior.
  */
-void  SynthNoteOff(uint8_t noteNum)
+void  SynthNoteOff(uint8_t voice, uint8_t noteNum)
 {
   noteNum &= 0x7F;
   if (noteNum > 120)  noteNum -= 12;   // too high
   if (noteNum < 12)   noteNum += 12;   // too low
-  if (noteNum == m_NotePlaying) SynthTriggerRelease();
+  if (noteNum == m_Voice[voice].NotePlaying) SynthTriggerRelease(voice);
 }
 
 
-void  SynthTriggerRelease()
+void  SynthTriggerRelease(uint8_t voice)
 {
-  m_TriggerRelease1 = 1;
-  m_TriggerRelease2 = 1;
-  m_TriggerReset = 1;
-  m_NoteOn = FALSE;
+  SynthVoice_t  *pv = &m_Voice[voice];
+
+  pv->TriggerRelease1 = 1;
+  pv->TriggerRelease2 = 1;
+  pv->TriggerReset = 1;
+  pv->NoteOn = FALSE;
 }
 
 
 // This function is provided for CV control mode to set oscillator pitch.
+// (CV inputs are fitted to the mono voice module, which has one voice.)
 //
 void  SynthSetOscFrequency(float fundamental_Hz)
 {
+  SynthVoice_t  *pv = &m_Voice[0];
   float   oscFreq, freqMult;
-  long   tableSize, oscStep;  // 16:16 bit fixed point
+  uint32_t  oscStep;           // 2^32 = 1 cycle
   int     osc;
 
   for (osc = 0;  osc < 6;  osc++)  // Set freq in 6 oscillators...
   {
     freqMult = g_FreqMultConst[g_Patch.OscFreqMult[osc]];  // float
     oscFreq = fundamental_Hz * freqMult;
-    if (oscFreq > MAX_OSC_FREQ_HZ)  m_OscMuted[osc] = TRUE;
-    else  m_OscMuted[osc] = FALSE;
+    if (oscFreq > m_MaxOscFreq)  pv->OscMuted[osc] = TRUE;
+    else  pv->OscMuted[osc] = FALSE;
 
     // Initialize oscillator "phase step" for use in audio ISR
-    tableSize = (long) WAVE_TABLE_SIZE << 16;  // convert to 16:16 fixed-pt
-    oscStep = (long) ((tableSize * oscFreq) / SAMPLE_RATE_HZ);
-    m_OscStepInit[osc] = oscStep;
+    oscStep = (uint32_t) ((OSC_PHASE_CYCLE * oscFreq) / g_SampleRate);
+    pv->OscStepInit[osc] = oscStep;
   }
+  pv->DirtyFlags |= DIRTY_OSC_DETUNE | DIRTY_MIXER_LEVELS;
 }
 
 
@@ -357,6 +571,108 @@ void  SynthModulation(unsigned data14)
 void  SynthSetReverbMix(uint8_t rvbmix_pc)
 {
   if (rvbmix_pc <= 100) m_RvbMix = rvbmix_pc;
+  AudioKernelSelect();  // reverb on/off
+}
+
+
+// Set the reverb algorithm (config param g_Config.ReverbMode):
+// REVERB_MODE_SINGLE (single delay line, low CPU load) or REVERB_MODE_NETWORK.
+// Audio output is muted briefly while the delay lines are re-configured;  the synth
+// enable state is restored after (the synth is not started if not yet running).
+//
+void  SynthSetReverbMode(uint8_t mode)
+{
+  uint8_t  synthEnable = v_SynthEnable;
+
+  if (mode > REVERB_MODE_NETWORK || mode == g_Config.ReverbMode)  return;
+
+  v_SynthEnable = 0;  // mute audio
+  AudioKernelSelect();
+  g_Config.ReverbMode = mode;
+  ReverbPrepare();
+  v_SynthEnable = synthEnable;
+  AudioKernelSelect();
+}
+
+
+/*
+ * Function:     Calculate reverb effect constants and delay line layout in ReverbBuffer[]
+ *               for the sample rate (g_SampleRate) and mode (g_Config.ReverbMode).
+ *               If the layout is changed, the delay lines are cleared.
+ *               Called by SynthPrepare() and SynthSetReverbMode(), with audio muted.
+ *
+ * Network mode:  4 parallel comb filters (with low-pass filter in the feedback loop)
+ * followed by 2 allpass filters in series, after Schroeder and "Freeverb".  Delay line
+ * lengths are mutually prime (all prime numbers), so that the comb resonances do not
+ * coincide, which avoids the metallic "flutter" of a single delay line.  The comb gains
+ * are set for a decay time (-60dB) of REVERB_DECAY_TIME_SEC.
+ */
+void  ReverbPrepare()
+{
+  static uint16_t  rateLast;
+  static uint8_t   modeLast = 0xFF;
+  int16_t  *pbuf = ReverbBuffer;
+  float    gain;
+  int16_t  gainMax = 0;
+  int      k;
+
+  m_RvbAtten = ((uint16_t)REVERB_ATTENUATION_PC << 7) / 100;  // = 0..127
+
+  // Single-line mode constants...
+  m_RvbDelayLen = (int) (REVERB_LOOP_TIME_SEC * g_SampleRate);  // loop time is 0.04f
+  if (m_RvbDelayLen > REVERB_BUFFER_SIZE)  m_RvbDelayLen = REVERB_BUFFER_SIZE;
+  gain = powf(0.001f, (float) REVERB_LOOP_TIME_SEC / REVERB_DECAY_TIME_SEC);
+  m_RvbDecay = (int16_t) (gain * 32768);  // = 0.83 (approx)
+
+  // Network mode constants...
+  for (k = 0;  k < REVERB_COMB_COUNT;  k++)
+  {
+    m_RvbComb[k].len = ReverbPrimeLength(c_RvbCombLen48k[k]);
+    m_RvbComb[k].buf = pbuf;
+    pbuf += m_RvbComb[k].len;
+    gain = powf(0.001f, (float) m_RvbComb[k].len / (g_SampleRate * REVERB_DECAY_TIME_SEC));
+    m_RvbComb[k].gain = (int16_t) (gain * 32768);
+    if (m_RvbComb[k].gain > gainMax)  gainMax = m_RvbComb[k].gain;
+  }
+  for (k = 0;  k < REVERB_ALLPASS_COUNT;  k++)
+  {
+    m_RvbAllpass[k].len = ReverbPrimeLength(c_RvbAllpassLen48k[k]);
+    m_RvbAllpass[k].buf = pbuf;
+    pbuf += m_RvbAllpass[k].len;
+  }
+  // Comb input gain = 4 x (1 - max. feedback gain) -- limits the peak comb gain
+  m_RvbInGain = (32768 - gainMax) * 4;
+
+  if (g_SampleRate != rateLast || g_Config.ReverbMode != modeLast)  // new layout
+  {
+    for (k = 0;  k < REVERB_COMB_COUNT;  k++)  { m_RvbComb[k].idx = 0;  m_RvbComb[k].filt = 0; }
+    for (k = 0;  k < REVERB_ALLPASS_COUNT;  k++)  { m_RvbAllpass[k].idx = 0; }
+    m_RvbIndex = 0;
+    m_RvbPrev = 0;
+    memset(ReverbBuffer, 0, sizeof(ReverbBuffer));
+    rateLast = g_SampleRate;
+    modeLast = g_Config.ReverbMode;
+  }
+}
+
+
+// Reverb network delay line length for the current sample rate:  the 48kHz length,
+// scaled to g_SampleRate, reduced to the nearest prime number (by trial division).
+//
+uint16_t  ReverbPrimeLength(uint16_t len48k)
+{
+  uint16_t  len = (uint16_t) (((uint32_t) len48k * g_SampleRate) / 48000);
+  uint16_t  div;
+
+  for ( ;  len > 2;  len--)
+  {
+    for (div = 2;  (div * div) <= len;  div++)
+    {
+      if ((len % div) == 0)  break;
+    }
+    if ((div * div) > len)  break;  // no factor found -- len is prime
+  }
+  return  len;
 }
 
 
@@ -373,24 +689,77 @@ void  SynthSetReverbMix(uint8_t rvbmix_pc)
  * Some processing is done at 1ms intervals (1000Hz), while other tasks are done at longer
  * intervals, e.g. 5ms (200Hz) where timing is not so critical and/or more intensive
  * computation, e.g. floating point arithmetic, is needed.
+ *
+ * The envelopes, vibrato ramp, osc modulation and output level of each voice are
+ * processed in turn;  the LFO and patch swap are common to all voices.
  */
 void  SynthProcess()
 {
   static  int  count5ms;
+#if AUDIO_ISR_LOAD_MONITOR
+  static  int  count100ms;
+  uint32_t  tBegin = CYCLE_COUNT();
+  uint32_t  cycles;
+#endif
+  SynthVoice_t  *pv;
 
-  AmpldEnvelopeGenerator();
-  TransientEnvelopeGen();
-  ContourGenerator();
+  for (pv = m_Voice;  pv < &m_Voice[SYNTH_VOICE_COUNT];  pv++)
+  {
+#if NOTE_LATENCY_TRACE
+    if (pv->TraceState == TRACE_AUDIBLE)  LatencyTraceRecord(pv);
+#endif
+    AmpldEnvelopeGenerator(pv);
+    TransientEnvelopeGen(pv);
+    ContourGenerator(pv);
+  }
   LowFrequencyOscillator();
-  AudioLevelController();
+  PatchSwapControl();
+  for (pv = m_Voice;  pv < &m_Voice[SYNTH_VOICE_COUNT];  pv++)
+  {
+    AudioLevelController(pv);
+  }
 
   if (++count5ms >= 5)
   {
     count5ms = 0;
-    VibratoRampGenerator();
-    OscFreqModulation();
-    OscAmpldModulation();
+    for (pv = m_Voice;  pv < &m_Voice[SYNTH_VOICE_COUNT];  pv++)
+    {
+      VibratoRampGenerator(pv);
+      OscFreqModulation(pv);
+      OscAmpldModulation(pv);
+    }
+  }
+
+#if AUDIO_ISR_LOAD_MONITOR
+  if (++count100ms >= 100)
+  {
+    count100ms = 0;
+    IsrLoadUpdate();
   }
+  cycles = CyclesElapsed(tBegin, CYCLE_COUNT());
+  if (cycles > m_SynthProcessMax)  m_SynthProcessMax = cycles;
+#endif
+}
+
+
+/*
+ * Function:  EnvDecayCoeff()
+ *
+ * Overview:  Calculates the coefficient for an exponential decay or release segment of
+ *            an envelope generator, called once at the start of the segment.  The step
+ *            change in each 1ms interval is then:  (level - final level) x coefficient,
+ *            i.e. a multiply instead of a (slow, software) division on the M0+ MCU.
+ *
+ * Entry arg: segTime_ms = segment time (ms), where time-constant = 20% of segment time
+ *
+ * Return:    (fixed_t) coefficient = 1 / time-constant, normalized (0 ~ 1.000)
+ */
+fixed_t  EnvDecayCoeff(uint16_t segTime_ms)
+{
+  uint16_t  timeConstant = segTime_ms / 5;
+
+  if (timeConstant < 1)  timeConstant = 1;  // step to final level in 1ms
+  return  IntToFixedPt(1) / timeConstant;
 }
 
 
@@ -398,90 +767,94 @@ void  SynthProcess()
  * Function:  AmpldEnvelopeGenerator()
  *
  * Overview:  Amplitude envelope generator (ENV1)
- *            Routine called by the Synth Process at 1ms intervals.
+ *            Routine called by the Synth Process at 1ms intervals, for each voice.
+ *
+ * Entry arg: pv = pointer to voice state;  the envelope state is pv->Env1.
  *
- * Output:    (fixed_t) m_ENV1_Output = Envelope output level, normalized (0 ~ +1.00)
+ * Output:    (fixed_t) pv->Env1.Output = Envelope output level, normalized (0 ~ +1.00)
  *
  */
-void  AmpldEnvelopeGenerator()
+void  AmpldEnvelopeGenerator(SynthVoice_t *pv)
 {
-  static  uint8_t    EnvSegment;      // Envelope segment (aka "phase")
-  static  uint32_t   envPhaseTimer;   // Time elapsed in envelope phase (ms)
-  static  fixed_t  sustainLevel;    // Envelope sustain level, norm. (0 ~ 1.000)
-  static  fixed_t  timeConstant;    // 20% of decay or release time (ms)
-  static  fixed_t  ampldDelta;      // Step change in Env Ampld in 1ms
-  static  fixed_t  ampldMaximum;    // Peak value of Envelope Ampld
+  EnvelopeGen_t  *env = &pv->Env1;
 
-  if (m_TriggerAttack1)
+  if (pv->TriggerAttack1)
   {
-    m_TriggerAttack1 = 0;
-    m_TriggerRelease1 = 0;
-    envPhaseTimer = 0;
-    sustainLevel = IntToFixedPt((int) g_Patch.EnvSustainLevel) / 100;
-    ampldMaximum = FIXED_MAX_LEVEL;  // for Peak-Hold phase
-    if (g_Patch.EnvHoldTime == 0)  ampldMaximum = sustainLevel;  // No Peak-Hold phase
-    ampldDelta = ampldMaximum / g_Patch.EnvAttackTime;  // step change in 1ms
-    EnvSegment = ENV_ATTACK;
+    pv->TriggerAttack1 = 0;
+    pv->TriggerRelease1 = 0;
+    env->PhaseTimer = 0;
+    env->SustainLevel = IntToFixedPt((int) g_Patch.EnvSustainLevel) / 100;
+    env->AmpldMaximum = FIXED_MAX_LEVEL;  // for Peak-Hold phase
+    if (g_Patch.EnvHoldTime == 0)  env->AmpldMaximum = env->SustainLevel;  // No Peak-Hold phase
+    env->AmpldDelta = env->AmpldMaximum / g_Patch.EnvAttackTime;  // step change in 1ms
+    env->Segment = ENV_ATTACK;
+#if NOTE_LATENCY_TRACE
+    if (pv->TraceState == TRACE_NOTE_RCVD)
+    {
+      pv->TraceTrigTime = TimeStamp_us();
+      pv->TraceState = TRACE_TRIGGERED;  // audio ISR looks for first audible sample
+    }
+#endif
   }
 
-  if (m_TriggerRelease1)
+  if (pv->TriggerRelease1)
   {
-    m_TriggerRelease1 = 0;
-    timeConstant = g_Patch.EnvReleaseTime / 5;
-    envPhaseTimer = 0;
-    EnvSegment = ENV_RELEASE;
+    pv->TriggerRelease1 = 0;
+    env->DecayCoeff = EnvDecayCoeff(g_Patch.EnvReleaseTime);
+    env->PhaseTimer = 0;
+    env->Segment = ENV_RELEASE;
   }
 
-  switch (EnvSegment)
+  switch (env->Segment)
   {
   case ENV_IDLE:          // Idle - zero output level
   {
-    m_ENV1_Output = 0;
+    env->Output = 0;
     break;
   }
   case ENV_ATTACK:        // Attack - linear ramp up to peak, or to the sustain level
   {
-    if (m_ENV1_Output < ampldMaximum) m_ENV1_Output += ampldDelta;
-    if (++envPhaseTimer >= g_Patch.EnvAttackTime)  // attack time ended
+    if (env->Output < env->AmpldMaximum) env->Output += env->AmpldDelta;
+    if (++env->PhaseTimer >= g_Patch.EnvAttackTime)  // attack time ended
     {
-      m_ENV1_Output = ampldMaximum;
-      envPhaseTimer = 0;
-      if (g_Patch.EnvHoldTime == 0)  EnvSegment = ENV_SUSTAIN; // skip peak and decay
-      else  EnvSegment = ENV_PEAK_HOLD;  // run all phases
+      env->Output = env->AmpldMaximum;
+      env->PhaseTimer = 0;
+      if (g_Patch.EnvHoldTime == 0)  env->Segment = ENV_SUSTAIN; // skip peak and decay
+      else  env->Segment = ENV_PEAK_HOLD;  // run all phases
     }
     break;
   }
   case ENV_PEAK_HOLD:     // Peak Hold - constant output level (0.99999)
   {
-    if (++envPhaseTimer >= g_Patch.EnvHoldTime)  // Peak-hold time ended
+    if (++env->PhaseTimer >= g_Patch.EnvHoldTime)  // Peak-hold time ended
     {
-      timeConstant = g_Patch.EnvDecayTime / 5;  // for Decay phase
-      envPhaseTimer = 0;
-      EnvSegment = ENV_DECAY;
+      env->DecayCoeff = EnvDecayCoeff(g_Patch.EnvDecayTime);  // for Decay phase
+      env->PhaseTimer = 0;
+      env->Segment = ENV_DECAY;
     }
     break;
   }
   case ENV_DECAY:         // Decay - exponential ramp down to sustain level
   {
-    ampldDelta = (m_ENV1_Output - sustainLevel) / timeConstant;  // step in 1ms
-    if (ampldDelta == 0)  ampldDelta = FIXED_MIN_LEVEL;
-    if (m_ENV1_Output >= (sustainLevel + ampldDelta))  m_ENV1_Output -= ampldDelta;
+    env->AmpldDelta = MultiplyFixed((env->Output - env->SustainLevel), env->DecayCoeff);  // step in 1ms
+    if (env->AmpldDelta == 0)  env->AmpldDelta = FIXED_MIN_LEVEL;
+    if (env->Output >= (env->SustainLevel + env->AmpldDelta))  env->Output -= env->AmpldDelta;
     // Allow 10 x time-constant for decay phase to complete
-    if (++envPhaseTimer >= (g_Patch.EnvDecayTime * 2))  EnvSegment = ENV_SUSTAIN;
+    if (++env->PhaseTimer >= (g_Patch.EnvDecayTime * 2))  env->Segment = ENV_SUSTAIN;
     break;
   }
-  case ENV_SUSTAIN:       // Sustain constant level -- waiting for m_TriggerRelease1
+  case ENV_SUSTAIN:       // Sustain constant level -- waiting for TriggerRelease1
   {
     break;
   }
   case ENV_RELEASE:       // Release - exponential ramp down to zero level
   {
-    // timeConstant and envPhaseTimer are set by the trigger condition, above.
-    ampldDelta = m_ENV1_Output / timeConstant;
-    if (ampldDelta == 0)  ampldDelta = FIXED_MIN_LEVEL;
-    if (m_ENV1_Output >= ampldDelta)  m_ENV1_Output -= ampldDelta;
+    // DecayCoeff and PhaseTimer are set by the trigger condition, above.
+    env->AmpldDelta = MultiplyFixed(env->Output, env->DecayCoeff);
+    if (env->AmpldDelta == 0)  env->AmpldDelta = FIXED_MIN_LEVEL;
+    if (env->Output >= env->AmpldDelta)  env->Output -= env->AmpldDelta;
     // Allow 10 x time-constant for release phase to complete
-    if (++envPhaseTimer >= (g_Patch.EnvReleaseTime * 2))  EnvSegment = ENV_IDLE;
+    if (++env->PhaseTimer >= (g_Patch.EnvReleaseTime * 2))  env->Segment = ENV_IDLE;
     break;
   }
   }  // end switch
@@ -493,88 +866,85 @@ void  AmpldEnvelopeGenerator()
  *
  * Overview:  Transient envelope generator == ENV2.
  *            ENV2 output can be used to amplitude-modulate any of the 6 oscillators.
- *            Routine called by the Synth Process at 1ms intervals.
+ *            Routine called by the Synth Process at 1ms intervals, for each voice.
+ *
+ * Entry arg: pv = pointer to voice state;  the envelope state is pv->Env2.
  *
- * Output:    (fixed_t) m_ENV2_Output = Envelope #2 output level, norm. (0 ~ 0.9999)
+ * Output:    (fixed_t) pv->Env2.Output = Envelope #2 output level, norm. (0 ~ 0.9999)
  *
  */
-void   TransientEnvelopeGen()
+void   TransientEnvelopeGen(SynthVoice_t *pv)
 {
-  static  uint8_t    EnvSegment;      // Envelope segment (aka "phase")
-  static  uint32_t   envPhaseTimer;   // Time elapsed in envelope phase (ms)
-  static  fixed_t  sustainLevel;    // Envelope sustain level (0 ~ 1.000)
-  static  fixed_t  timeConstant;    // 20% of decay or release time (ms)
-  static  fixed_t  ampldDelta;      // Step change in Env Ampld in 1ms
-  static  fixed_t  ampldMaximum;    // Peak value of Envelope Ampld
+  EnvelopeGen_t  *env = &pv->Env2;
 
-  if (m_TriggerAttack2)
+  if (pv->TriggerAttack2)
   {
-    m_TriggerAttack2 = 0;
-    m_TriggerRelease2 = 0;
-    envPhaseTimer = 0;
-    sustainLevel = IntToFixedPt((int) g_Patch.Env2SustainLevel) / 100;
-    ampldMaximum = FIXED_MAX_LEVEL;  // for Peak-Hold phase
-    ampldDelta = ampldMaximum / 10;  // ENV2 attack time = 10ms (fixed)
-    EnvSegment = ENV_ATTACK;
+    pv->TriggerAttack2 = 0;
+    pv->TriggerRelease2 = 0;
+    env->PhaseTimer = 0;
+    env->SustainLevel = IntToFixedPt((int) g_Patch.Env2SustainLevel) / 100;
+    env->AmpldMaximum = FIXED_MAX_LEVEL;  // for Peak-Hold phase
+    env->AmpldDelta = env->AmpldMaximum / 10;  // ENV2 attack time = 10ms (fixed)
+    env->Segment = ENV_ATTACK;
   }
 
-  if (m_TriggerRelease2)
+  if (pv->TriggerRelease2)
   {
-    m_TriggerRelease2 = 0;
-    timeConstant = g_Patch.Env2DecayTime / 5;  // Release time == Decay time
-    envPhaseTimer = 0;
-    EnvSegment = ENV_RELEASE;
+    pv->TriggerRelease2 = 0;
+    env->DecayCoeff = EnvDecayCoeff(g_Patch.Env2DecayTime);  // Release time == Decay time
+    env->PhaseTimer = 0;
+    env->Segment = ENV_RELEASE;
   }
 
-  switch (EnvSegment)
+  switch (env->Segment)
   {
   case ENV_IDLE:          // Idle - zero output level
   {
-    m_ENV2_Output = 0;
+    env->Output = 0;
     break;
   }
   case ENV_ATTACK:        // Attack - linear ramp up to peak
   {
-    if (m_ENV2_Output < ampldMaximum) m_ENV2_Output += ampldDelta;
-    if (++envPhaseTimer >= 10)  // attack time (10ms) ended
+    if (env->Output < env->AmpldMaximum) env->Output += env->AmpldDelta;
+    if (++env->PhaseTimer >= 10)  // attack time (10ms) ended
     {
-      m_ENV2_Output = ampldMaximum;
-      envPhaseTimer = 0;
-      EnvSegment = ENV_PEAK_HOLD;
+      env->Output = env->AmpldMaximum;
+      env->PhaseTimer = 0;
+      env->Segment = ENV_PEAK_HOLD;
     }
     break;
   }
   case ENV_PEAK_HOLD:     // Peak Hold - constant output level (0.9999)
   {
-    if (++envPhaseTimer >= 20)  // ENV2 Peak-Hold time = 20ms (fixed)
+    if (++env->PhaseTimer >= 20)  // ENV2 Peak-Hold time = 20ms (fixed)
     {
-      timeConstant = g_Patch.Env2DecayTime / 5;  // for Decay phase
-      envPhaseTimer = 0;
-      EnvSegment = ENV_DECAY;
+      env->DecayCoeff = EnvDecayCoeff(g_Patch.Env2DecayTime);  // for Decay phase
+      env->PhaseTimer = 0;
+      env->Segment = ENV_DECAY;
     }
     break;
   }
   case ENV_DECAY:         // Decay - exponential ramp down to sustain level
   {
-    ampldDelta = (m_ENV2_Output - sustainLevel) / timeConstant;  // step in 1ms
-    if (ampldDelta == 0)  ampldDelta = FIXED_MIN_LEVEL;
-    if (m_ENV2_Output >= (sustainLevel + ampldDelta))  m_ENV2_Output -= ampldDelta;
+    env->AmpldDelta = MultiplyFixed((env->Output - env->SustainLevel), env->DecayCoeff);  // step in 1ms
+    if (env->AmpldDelta == 0)  env->AmpldDelta = FIXED_MIN_LEVEL;
+    if (env->Output >= (env->SustainLevel + env->AmpldDelta))  env->Output -= env->AmpldDelta;
     // Allow 10 x time-constant for decay phase to complete
-    if (++envPhaseTimer >= (g_Patch.Env2DecayTime * 2))  EnvSegment = ENV_SUSTAIN;
+    if (++env->PhaseTimer >= (g_Patch.Env2DecayTime * 2))  env->Segment = ENV_SUSTAIN;
     break;
   }
-  case ENV_SUSTAIN:       // Sustain constant level -- waiting for m_TriggerRelease
+  case ENV_SUSTAIN:       // Sustain constant level -- waiting for TriggerRelease2
   {
     break;
   }
   case ENV_RELEASE:       // Release - exponential ramp down to zero level
   {
-    // timeConstant and envPhaseTimer are set by the trigger condition, above.
-    ampldDelta = m_ENV2_Output / timeConstant;
-    if (ampldDelta == 0)  ampldDelta = FIXED_MIN_LEVEL;
-    if (m_ENV2_Output >= ampldDelta)  m_ENV2_Output -= ampldDelta;
+    // DecayCoeff and PhaseTimer are set by the trigger condition, above.
+    env->AmpldDelta = MultiplyFixed(env->Output, env->DecayCoeff);
+    if (env->AmpldDelta == 0)  env->AmpldDelta = FIXED_MIN_LEVEL;
+    if (env->Output >= env->AmpldDelta)  env->Output -= env->AmpldDelta;
     // Allow 10 x time-constant for release phase to complete
-    if (++envPhaseTimer >= (g_Patch.Env2DecayTime * 2))  EnvSegment = ENV_IDLE;
+    if (++env->PhaseTimer >= (g_Patch.Env2DecayTime * 2))  env->Segment = ENV_IDLE;
     break;
   }
   }  // end switch
@@ -584,38 +954,35 @@ void   TransientEnvelopeGen()
 /*
  * Function:  ContourGenerator()
  *
- * Overview:  Routine called by the Synth Process at 1ms intervals.
+ * Overview:  Routine called by the Synth Process at 1ms intervals, for each voice.
  *            All segments of the Contour shape are linear time-varying.
  *
- * Output:    (fixed_t) m_ContourOutput = output signal, normalized (0..+1.00)
+ * Entry arg: pv = pointer to voice state
+ *
+ * Output:    (fixed_t) pv->ContourOutput = output signal, normalized (0..+1.00)
  */
-void  ContourGenerator()
+void  ContourGenerator(SynthVoice_t *pv)
 {
-  static  short    contourSegment;  // Contour envelope segment (aka phase)
-  static  uint32_t   segmentTimer;    // Time elapsed in active phase (ms)
-  static  fixed_t  outputDelta;     // Step change in output level per millisecond
-  static  fixed_t  startLevel;      // Output level at start of contour (0..+1.0)
-  static  fixed_t  holdLevel;       // Output level maintained at end of ramp (0..+1.0)
 
-  if (m_TriggerContour)  // Note-On event
+  if (pv->TriggerContour)  // Note-On event
   {
-    m_TriggerContour = 0;
-    startLevel = IntToFixedPt(g_Patch.ContourStartLevel) / 100;
-    holdLevel = IntToFixedPt(g_Patch.ContourHoldLevel) / 100;
-    m_ContourOutput = startLevel;
-    outputDelta = (holdLevel - startLevel) / g_Patch.ContourRampTime;
-    segmentTimer = 0;
-    contourSegment = CONTOUR_DELAY;
+    pv->TriggerContour = 0;
+    pv->ContourStartLevel = IntToFixedPt(g_Patch.ContourStartLevel) / 100;
+    pv->ContourHoldLevel = IntToFixedPt(g_Patch.ContourHoldLevel) / 100;
+    pv->ContourOutput = pv->ContourStartLevel;
+    pv->ContourDelta = (pv->ContourHoldLevel - pv->ContourStartLevel) / g_Patch.ContourRampTime;
+    pv->ContourTimer = 0;
+    pv->ContourSegment = CONTOUR_DELAY;
   }
 
-  if (m_TriggerReset)  // Note-Off event
+  if (pv->TriggerReset)  // Note-Off event
   {
-    m_TriggerReset = 0;
-    segmentTimer = 0;
-    contourSegment = CONTOUR_IDLE;
+    pv->TriggerReset = 0;
+    pv->ContourTimer = 0;
+    pv->ContourSegment = CONTOUR_IDLE;
   }
 
-  switch (contourSegment)
+  switch (pv->ContourSegment)
   {
   case CONTOUR_IDLE:  // Waiting for trigger signal
   {
@@ -623,23 +990,23 @@ void  ContourGenerator()
   }
   case CONTOUR_DELAY:  // Delay before ramp up/down segment
   {
-    if (++segmentTimer >= g_Patch.ContourDelayTime)  // Delay segment ended
+    if (++pv->ContourTimer >= g_Patch.ContourDelayTime)  // Delay segment ended
     {
-      segmentTimer = 0;
-      contourSegment = CONTOUR_RAMP;
+      pv->ContourTimer = 0;
+      pv->ContourSegment = CONTOUR_RAMP;
     }
     break;
   }
   case CONTOUR_RAMP:  // Linear ramp up/down from Start to Hold level
   {
-    if (++segmentTimer >= g_Patch.ContourRampTime)  // Ramp segment ended
-      contourSegment = CONTOUR_HOLD;
-    else  m_ContourOutput += outputDelta;
+    if (++pv->ContourTimer >= g_Patch.ContourRampTime)  // Ramp segment ended
+      pv->ContourSegment = CONTOUR_HOLD;
+    else  pv->ContourOutput += pv->ContourDelta;
     break;
   }
   case CONTOUR_HOLD:  // Hold constant level - waiting for Note-Off event to reset
   {
-    m_ContourOutput = holdLevel;
+    pv->ContourOutput = pv->ContourHoldLevel;
     break;
   }
   };  // end switch
@@ -649,75 +1016,159 @@ void  ContourGenerator()
 /*
  * Function:  AudioLevelController()
  *
- * Overview:  This routine is called by the Synth Process at 1ms intervals.
+ * Overview:  This routine is called by the Synth Process at 1ms intervals, for each voice.
  *            The output level is controlled (i.e. varied) by one of a choice of options
  *            as determined usually by the patch parameter g_Patch.OutputAmpldCtrl, but
  *            which may be overridden by the config param g_Config.AudioAmpldCtrlMode.
  *
- * Output:    (fixed_t) v_OutputLevel : normalized output level (range 0..+1.000)
+ * Entry arg: pv = pointer to voice state
+ *
+ * Output:    (fixed_t) pv->OutputLevel : normalized output level (range 0..+1.000)
  *            The output variable is used by the audio ISR to control the audio ampld,
  *            except for the reverberated signal which may continue to sound.
+ *            If AUDIO_LEVEL_RAMP is TRUE, the ISR ramps the level linearly from the
+ *            previous value to OutputLevel over 1ms, i.e. advances per sample.
  */
-void   AudioLevelController()
+void   AudioLevelController(SynthVoice_t *pv)
 {
-  static  fixed_t  outputAmpld;       // Audio output level, normalized
-  static  fixed_t  smoothExprnLevel;  // Expression level, normalized, smoothed
   volatile  fixed_t  outputLevel;     // immune to corruption by ISR
   fixed_t  exprnLevel;
-  uint8_t   controlSource = g_Patch.AmpControlMode;  // default
+  uint8_t   controlSource;
 
-  // Check for global (config) override of patch parameter
-  if (g_Config.AudioAmpldCtrlMode == AUDIO_CTRL_CONST)
-    controlSource = AMPLD_CTRL_CONST_MAX;
-  else if (g_Config.AudioAmpldCtrlMode == AUDIO_CTRL_ENV1_VELO)
-    controlSource = AMPLD_CTRL_ENV1_VELO;
-  else if (g_Config.AudioAmpldCtrlMode == AUDIO_CTRL_EXPRESS)
-    controlSource = AMPLD_CTRL_EXPRESS;
-  else  controlSource = g_Patch.AmpControlMode;
+  if (pv->DirtyFlags & DIRTY_AMPLD_CONTROL)
+  {
+    pv->DirtyFlags &= ~DIRTY_AMPLD_CONTROL;
+    // Check for global (config) override of patch parameter
+    if (g_Config.AudioAmpldCtrlMode == AUDIO_CTRL_CONST)
+      m_AmpldControlSource = AMPLD_CTRL_CONST_MAX;
+    else if (g_Config.AudioAmpldCtrlMode == AUDIO_CTRL_ENV1_VELO)
+      m_AmpldControlSource = AMPLD_CTRL_ENV1_VELO;
+    else if (g_Config.AudioAmpldCtrlMode == AUDIO_CTRL_EXPRESS)
+      m_AmpldControlSource = AMPLD_CTRL_EXPRESS;
+    else  m_AmpldControlSource = g_Patch.AmpControlMode;
+  }
+  controlSource = m_AmpldControlSource;
 
   if (controlSource == AMPLD_CTRL_CONST_LOW)  // mode 1
   {
-    if (m_NoteOn)  outputAmpld = FIXED_MAX_LEVEL / 2;
-    else  outputAmpld = 0;  // Mute when note terminated
+    if (pv->NoteOn)  pv->OutputAmpld = FIXED_MAX_LEVEL / 2;
+    else  pv->OutputAmpld = 0;  // Mute when note terminated
   }
   else if (controlSource == AMPLD_CTRL_ENV1_VELO)  // mode 2
   {
 #if (!BUILD_FOR_POLY_VOICE)  // assume Sigma-6 Mono VM with CV inputs
     if (g_CVcontrolMode && g_Config.CV3_is_Velocity)
-      m_KeyVelocity = m_ExpressionLevel;  // CV3 (EXPRN) input controls ampld
+      pv->KeyVelocity = m_ExpressionLevel;  // CV3 (EXPRN) input controls ampld
 #endif
-    outputAmpld = MultiplyFixed(m_ENV1_Output, m_KeyVelocity);
+    pv->OutputAmpld = MultiplyFixed(pv->Env1.Output, pv->KeyVelocity);
   }
   else if (controlSource == AMPLD_CTRL_EXPRESS)  // mode 3
   {
-//  if (m_ENV1_Output)  exprnLevel = m_ExpressionLevel;
+//  if (pv->Env1.Output)  exprnLevel = m_ExpressionLevel;
 //  else  exprnLevel = 0;  // Mute when ENV1 release phase ends (option 1), or...
     exprnLevel = m_ExpressionLevel;  // ... let MIDI controller determine the level
 
     // Apply IIR smoothing filter to eliminate abrupt step changes (K = 1/16)
-    smoothExprnLevel -= smoothExprnLevel >> 4;  // divide by 16
-    smoothExprnLevel += exprnLevel >> 4;
-    outputAmpld = smoothExprnLevel;
+    pv->SmoothExprnLevel -= pv->SmoothExprnLevel >> 4;  // divide by 16
+    pv->SmoothExprnLevel += exprnLevel >> 4;
+    pv->OutputAmpld = pv->SmoothExprnLevel;
   }
   else  // controlSource == AMPLD_CTRL_CONST_MAX   // mode 0
   {
-//  if (m_NoteOn)  outputAmpld = FIXED_MAX_LEVEL;
-//  else  outputAmpld = 0;  // Mute when note terminated (option 1), or...
-    outputAmpld = FIXED_MAX_LEVEL;  // ... sound the note indefinitely
+//  if (pv->NoteOn)  pv->OutputAmpld = FIXED_MAX_LEVEL;
+//  else  pv->OutputAmpld = 0;  // Mute when note terminated (option 1), or...
+    pv->OutputAmpld = FIXED_MAX_LEVEL;  // ... sound the note indefinitely
   }
 
-  if (outputAmpld > FIXED_MAX_LEVEL)  outputAmpld = FIXED_MAX_LEVEL;
+  if (pv->OutputAmpld > FIXED_MAX_LEVEL)  pv->OutputAmpld = FIXED_MAX_LEVEL;
 
-  outputLevel = FractionPart(outputAmpld, 10);  // unit = 1/1024, range 0..1023
-  v_OutputLevel = outputLevel;
+  // Apply patch swap fade gain (see PatchSwapControl)
+  if (m_PatchFadeGain < 1024)  pv->OutputAmpld = (pv->OutputAmpld * m_PatchFadeGain) >> 10;
+
+  outputLevel = FractionPart(pv->OutputAmpld, 10);  // unit = 1/1024, range 0..1023
+#if AUDIO_LEVEL_RAMP
+  // Ramp the ISR output level to the new value over the next 1ms (no zipper steps)
+  pv->OutputRampCount = 0;  // hold ramp while updating
+  pv->OutputRampStep = ((int32_t) outputLevel - (int32_t)(pv->OutputLevelFine >> 16))
+                       * m_RampStepRecip;
+  pv->OutputLevel = outputLevel;  // final level
+  pv->OutputRampCount = m_RampSamples;
+#else
+  pv->OutputLevel = outputLevel;
+#endif
 
   // Convert limiter level (%) to fixed-point normalized value for ISR
-  if (g_Patch.LimiterLevelPc != 0)   // Limiter enabled...
-    v_LimiterLevelPos = IntToFixedPt(g_Patch.LimiterLevelPc) / 100;
-  else  // Limiter disabled...
-    v_LimiterLevelPos = MAX_CLIPPING_LEVEL;  // maximum allowed level
+  if (pv->DirtyFlags & DIRTY_LIMITER_LEVEL)
+  {
+    pv->DirtyFlags &= ~DIRTY_LIMITER_LEVEL;
+    if (g_Patch.LimiterLevelPc != 0)   // Limiter enabled...
+      v_LimiterLevelPos = IntToFixedPt(g_Patch.LimiterLevelPc) / 100;
+    else  // Limiter disabled...
+      v_LimiterLevelPos = MAX_CLIPPING_LEVEL;  // maximum allowed level
+
+    v_LimiterLevelNeg = 0 - v_LimiterLevelPos;
+  }
+}
+
+
+/*
+ * Function:     Read the sine wave-table at a given index, as for a full-cycle table.
+ *               If SINE_TABLE_QUARTER_WAVE is TRUE, the sample is read from the quarter-
+ *               wave table in SRAM, reflected (2nd, 4th quarter) and negated (2nd half).
+ *
+ * Entry args:   idx = index into full-cycle table (0..WAVE_TABLE_SIZE-1)
+ *
+ * Return val:   (int) wave-table sample value (+/-32000)
+ */
+static inline __attribute__((always_inline)) int  SineTableRead(int idx)
+{
+#if SINE_TABLE_QUARTER_WAVE
+  int  i = idx & (SINE_QUARTER_SIZE - 1);
+
+  if (idx & SINE_QUARTER_SIZE)  i = SINE_QUARTER_SIZE - i;  // falling quarter (1..512)
+  if (idx & (SINE_QUARTER_SIZE * 2))  return  0 - m_SineQuarter[i];  // negative half
+  return  m_SineQuarter[i];
+#else
+  return  g_sine_wave.v[idx];
+#endif
+}
 
-  v_LimiterLevelNeg = 0 - v_LimiterLevelPos;
+
+/*
+ * Function:     Wave-table oscillator sample look-up, optionally interpolated between
+ *               adjacent table samples (WAVE_TABLE_INTERPOLATE).
+ *
+ * With the quarter-wave table, the phase angle is folded into the first quarter cycle:
+ * in the 2nd and 4th quarters the phase is reflected (bits inverted), so that the
+ * interpolation runs backwards through the table;  the result is negated in the 2nd half.
+ *
+ * Entry args:   angle = osc phase angle (2^32 = 1 cycle)
+ *
+ * Return val:   (fixed_t) osc sample value, normalized (+/-1.0)
+ */
+static inline __attribute__((always_inline)) fixed_t  OscWaveLookup(uint32_t angle)
+{
+#if WAVE_TABLE_INTERPOLATE && SINE_TABLE_QUARTER_WAVE
+  uint32_t  x = angle & 0x3FFFFFFF;  // phase within quarter cycle (30 bits)
+  int32_t   i, frac, s0;
+  fixed_t   sample;
+
+  if (angle & 0x40000000)  x ^= 0x3FFFFFFF;  // falling quarter -- reflect phase
+  i = x >> OSC_PHASE_SHIFT;  // 0..511
+  frac = (x >> (OSC_PHASE_SHIFT - 15)) & 0x7FFF;
+  s0 = m_SineQuarter[i];
+  sample = ((s0 << 15) + (m_SineQuarter[i + 1] - s0) * frac) >> 10;  // normalize
+  return  (angle & 0x80000000) ? (0 - sample) : sample;  // negative half
+
+#elif WAVE_TABLE_INTERPOLATE
+  int32_t   idx = angle >> OSC_PHASE_SHIFT;
+  int32_t   frac = (angle >> (OSC_PHASE_SHIFT - 15)) & 0x7FFF;
+
+  return  (((fixed_t) g_sine_wave.v[idx] << 15)
+          + (g_sine_wave.v[idx + 1] - g_sine_wave.v[idx]) * frac) >> 10;  // normalize
+#else
+  return  (fixed_t) SineTableRead(angle >> OSC_PHASE_SHIFT) << 5;  // normalize
+#endif
 }
 
 
@@ -739,7 +1190,7 @@ void   LowFrequencyOscillator()
   int  waveIdx;
 
   waveIdx = m_LFO_PhaseAngle >> 8;  // integer part of m_LFO_PhaseAngle
-  m_LFO_output = (fixed_t) g_sine_wave[waveIdx] << 5;  // normalized sample
+  m_LFO_output = (fixed_t) SineTableRead(waveIdx) << 5;  // normalized sample
   m_LFO_PhaseAngle += m_LFO_Step;
   if (m_LFO_PhaseAngle >= (WAVE_TABLE_SIZE << 8))
     m_LFO_PhaseAngle -= (WAVE_TABLE_SIZE << 8);
@@ -759,7 +1210,8 @@ void  SynthLFO_PhaseSync()
 /*
  * Function:     Vibrato Ramp Generator implementation.
  *
- * Called by the SynthProcess() at 5ms intervals, this function generates a linear ramp.
+ * Called by the SynthProcess() at 5ms intervals, for each voice (pv = pointer to voice
+ * state), this function generates a linear ramp.
  *
  * The vibrato (LFO) delayed ramp is triggered by a Note-On event.
  * If a Legato note change occurs, vibrato is stopped (fast ramp down) and the ramp delay
@@ -768,62 +1220,58 @@ void  SynthLFO_PhaseSync()
  * The delay and ramp-up times are both set by the patch parameter, g_Patch.LFO_RampTime,
  * so the delay time value is the same as the ramp-up time.  This works well enough.
  */
-void   VibratoRampGenerator()
+void   VibratoRampGenerator(SynthVoice_t *pv)
 {
-  static  short   rampState = 0;
-  static  uint32_t  rampTimer_ms;
-  static  fixed_t rampStep;  // Step chnage in output per 5 ms
-
   if (g_Patch.LFO_RampTime == 0)  // ramp disabled
   {
-    m_RampOutput = FIXED_MAX_LEVEL;
+    pv->RampOutput = FIXED_MAX_LEVEL;
     return;
   }
 
   // Check for Note-Off or Note-Change event while ramp is progressing
-  if (rampState != 3 && (!m_NoteOn || m_LegatoNoteChange))
+  if (pv->RampState != 3 && (!pv->NoteOn || pv->LegatoNoteChange))
   {
-    rampStep = IntToFixedPt(5) / 100;  // ramp down in 100ms
-    rampState = 3;
+    pv->RampStep = IntToFixedPt(5) / 100;  // ramp down in 100ms
+    pv->RampState = 3;
   }
 
-  if (rampState == 0)  // Idle - waiting for Note-On
+  if (pv->RampState == 0)  // Idle - waiting for Note-On
   {
-    if (m_NoteOn)
+    if (pv->NoteOn)
     {
-      m_RampOutput = 0;
-      rampTimer_ms = 0;  // start ramp delay timer
-      rampState = 1;
+      pv->RampOutput = 0;
+      pv->RampTimer_ms = 0;  // start ramp delay timer
+      pv->RampState = 1;
     }
   }
-  else if (rampState == 1)  // Delaying before ramp-up begins
+  else if (pv->RampState == 1)  // Delaying before ramp-up begins
   {
-    if (rampTimer_ms >= g_Patch.LFO_RampTime)
+    if (pv->RampTimer_ms >= g_Patch.LFO_RampTime)
     {
-      rampStep = IntToFixedPt(5) / (int) g_Patch.LFO_RampTime;
-      rampState = 2;
+      pv->RampStep = IntToFixedPt(5) / (int) g_Patch.LFO_RampTime;
+      pv->RampState = 2;
     }
-    rampTimer_ms += 5;
+    pv->RampTimer_ms += 5;
   }
-  else if (rampState == 2)  // Ramping up - hold at max. level (1.00)
+  else if (pv->RampState == 2)  // Ramping up - hold at max. level (1.00)
   {
-    if (m_RampOutput < FIXED_MAX_LEVEL)  m_RampOutput += rampStep;
-    if (m_RampOutput > FIXED_MAX_LEVEL)  m_RampOutput = FIXED_MAX_LEVEL;
+    if (pv->RampOutput < FIXED_MAX_LEVEL)  pv->RampOutput += pv->RampStep;
+    if (pv->RampOutput > FIXED_MAX_LEVEL)  pv->RampOutput = FIXED_MAX_LEVEL;
   }
-  else if (rampState == 3)  // Ramping down fast (fixed 100ms time)
+  else if (pv->RampState == 3)  // Ramping down fast (fixed 100ms time)
   {
-    if (m_RampOutput > 0)  m_RampOutput -= rampStep;
-    if (m_RampOutput < 0)  m_RampOutput = 0;
+    if (pv->RampOutput > 0)  pv->RampOutput -= pv->RampStep;
+    if (pv->RampOutput < 0)  pv->RampOutput = 0;
 
-    if (m_RampOutput < (IntToFixedPt(1) / 100))  // output is below 0.01
+    if (pv->RampOutput < (IntToFixedPt(1) / 100))  // output is below 0.01
     {
       // If a legato note change has occurred, re-start the ramp delay
-      if (m_LegatoNoteChange)  { m_LegatoNoteChange = 0;  rampState = 1; }
-      else  rampState = 0;
-      rampTimer_ms = 0;
+      if (pv->LegatoNoteChange)  { pv->LegatoNoteChange = 0;  pv->RampState = 1; }
+      else  pv->RampState = 0;
+      pv->RampTimer_ms = 0;
     }
   }
-  else  rampState = 0;
+  else  pv->RampState = 0;
 }
 
 
@@ -841,25 +1289,34 @@ void   VibratoRampGenerator()
  *
  * Note:  This function is used for low frequency modulation, up to about 25Hz,
  *        intended for Pitch Bend OR Vibrato (mutually exclusive).
+ *
+ * The de-tuned phase steps and LFO step are re-calculated only when marked "dirty"
+ * (see SynthMarkDirty);  osc steps are updated only when the FM deviation changes.
+ *
+ * Entry arg:    pv = pointer to voice state (called for each voice)
  */
-void   OscFreqModulation()
+void   OscFreqModulation(SynthVoice_t *pv)
 {
   fixed_t detuneNorm;      // osc de-tune factor (0.5 ~ 2.0 octave)
   fixed_t LFO_scaled;      // normalized, bipolar (range 0..+/-1.0)
-  fixed_t modnLevel;       // normalized, unipolar (range 0..+1.0)
+  fixed_t modnLevel = 0;   // normalized, unipolar (range 0..+1.0)
   fixed_t freqDevn;        // deviation from median freq. (x0.5 .. x2.0)
-  long   oscStep;         // temporary for calc'n (16:16 bit fix-pt)
-  long   oscFreqLFO;      // 24:8 bit fixed-point format (8-bit fraction)
+  uint32_t  oscStep;      // temporary for calc'n (2^32 = 1 cycle)
+  int32_t  oscFreqLFO;      // 24:8 bit fixed-point format (8-bit fraction)
   short  osc, cents;
 
-  oscFreqLFO = (((int) g_Patch.LFO_Freq_x10) << 8) / 10;  // 24:8 bit fixed-pt
-  m_LFO_Step = (oscFreqLFO * WAVE_TABLE_SIZE) / 1000;  // LFO Fs = 1000Hz
+  if (pv->DirtyFlags & DIRTY_LFO_FREQ)
+  {
+    pv->DirtyFlags &= ~DIRTY_LFO_FREQ;
+    oscFreqLFO = (((int) g_Patch.LFO_Freq_x10) << 8) / 10;  // 24:8 bit fixed-pt
+    m_LFO_Step = (oscFreqLFO * WAVE_TABLE_SIZE) / 1000;  // LFO Fs = 1000Hz
+  }
 
   if (g_Config.VibratoCtrlMode == VIBRATO_BY_MODN_CC)  // Use Mod Lever
     modnLevel = (m_ModulationLevel * g_Config.PitchBendRange) / 12;  // 1 octave max.
 
   if (g_Config.VibratoCtrlMode == VIBRATO_AUTOMATIC)  // Use LFO with ramp generator
-    modnLevel = (m_RampOutput * g_Patch.LFO_FM_Depth) / 1200;
+    modnLevel = (pv->RampOutput * g_Patch.LFO_FM_Depth) / 1200;
 
   if (g_Config.VibratoCtrlMode == VIBRATO_BY_CV_AUXIN)  // Use LFO without ramp
     modnLevel = (IntToFixedPt(1) * g_Patch.LFO_FM_Depth) / 1200;
@@ -873,13 +1330,27 @@ void   OscFreqModulation()
     freqDevn = Base2Exp(m_PitchBendFactor);  // max. 1 octave
   else  freqDevn = IntToFixedPt(1);  // No FM -- default
 
-  for (osc = 0;  osc < 6;  osc++)
+  // De-tuned osc phase steps change only on a new note, or detune/fine-tuning change
+  if (pv->DirtyFlags & DIRTY_OSC_DETUNE)
+  {
+    pv->DirtyFlags &= ~DIRTY_OSC_DETUNE;
+    for (osc = 0;  osc < 6;  osc++)
+    {
+      cents = g_Patch.OscDetune[osc] + g_Config.FineTuning_cents;  // signed
+      detuneNorm = Base2Exp((IntToFixedPt(1) * cents) / 1200);
+      pv->OscStepDetune[osc] = MultiplyFixed(pv->OscStepInit[osc], detuneNorm);
+    }
+    pv->FreqDevnLast = 0;  // force osc step update
+  }
+
+  if (freqDevn != pv->FreqDevnLast)  // Apply FM
   {
-    cents = g_Patch.OscDetune[osc] + g_Config.FineTuning_cents;  // signed
-    detuneNorm = Base2Exp((IntToFixedPt(1) * cents) / 1200);
-    m_OscStepDetune[osc] = MultiplyFixed(m_OscStepInit[osc], detuneNorm);
-    oscStep = MultiplyFixed(m_OscStepDetune[osc], freqDevn);  // Apply FM
-    v_OscStep[osc] = oscStep;  // update osc frequency
+    pv->FreqDevnLast = freqDevn;
+    for (osc = 0;  osc < 6;  osc++)
+    {
+      oscStep = MultiplyFixed(pv->OscStepDetune[osc], freqDevn);
+      pv->OscStep[osc] = oscStep;  // update osc frequency
+    }
   }
 }
 
@@ -899,142 +1370,899 @@ void   OscFreqModulation()
  * Input data:   g_Patch.OscAmpldModSource[osc],  g_Patch.MixerInputlevel[osc],
  *               and  g_Patch.MixerOutputGain
  *
- * Output data:  v_OscAmpldModn[osc],  v_MixerLevel[osc]  (accessed by the audio ISR)
- *               (These are scalar multipliers, range 0..1023)
+ * The modulation source signals, mixer levels and output gain are re-evaluated only
+ * when marked "dirty" (see SynthMarkDirty), i.e. after a patch param. change.
+ *
+ * Output data:  pv->OscGain[osc] = ampld modulation x mixer level  (accessed by audio ISR)
+ *               (These are scalar multipliers, range 0..1000)
+ *
+ * The audio render kernel is re-selected according to the worst-case mixer output level:
+ * if the mixer output cannot exceed the limiter level, the kernel without limiter is used.
+ *
+ * Finally, the list of audible oscillators (gain non-zero) is updated for the audio ISR.
+ * See OscActiveListUpdate().
+ *
+ * Entry arg:    pv = pointer to voice state (called for each voice)
  */
-void  OscAmpldModulation()
+void  OscAmpldModulation(SynthVoice_t *pv)
 {
   short  osc, step;
+  uint16_t  oscGain[6];
+  uint32_t  gainSum = 0;
+  uint32_t  peakLevel;      // worst-case mixer output level (normalized)
+  bool   limiterNeeded;
 
   fixed_t  LFO_scaled = (m_LFO_output * g_Patch.LFO_AM_Depth) / 200;  // FS = +/-0.5
   fixed_t  LFO_AM_bias = IntToFixedPt(1) - IntToFixedPt(g_Patch.LFO_AM_Depth) / 200;
 
-  for (osc = 0;  osc < 6;  osc++)
+  if (pv->DirtyFlags & DIRTY_OSC_MODN_SOURCE)  // Select ampld modulation source signals
   {
-    // Determine Ampld Modulation factor for each oscillator
-    if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_CONT_POS)
-      v_OscAmpldModn[osc] = m_ContourOutput >> 10;  // 0..1024
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_CONT_NEG)
-      v_OscAmpldModn[osc] = 1024 - (m_ContourOutput >> 10);  // 1024..0
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_ENV2)
-      v_OscAmpldModn[osc] = m_ENV2_Output >> 10;  // 0..1024
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_MODN)
-      v_OscAmpldModn[osc] = m_ModulationLevel >> 10;  // 0..1024
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_EXPR_POS)
-      v_OscAmpldModn[osc] = m_ExpressionLevel >> 10;  // 0..1024
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_EXPR_NEG)
-      v_OscAmpldModn[osc] = 1024 - (m_ExpressionLevel >> 10);  // 1024..0
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_LFO)
-      v_OscAmpldModn[osc] = (LFO_scaled + LFO_AM_bias) >> 10;  // 0..1024
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_VELO_POS)
-      v_OscAmpldModn[osc] = m_KeyVelocity >> 10;  // 0..1024
-    else if (g_Patch.OscAmpldModSource[osc] == OSC_MODN_SOURCE_VELO_NEG)
-      v_OscAmpldModn[osc] = 1024 - (m_KeyVelocity >> 10);  // 1024..0
-    else
-      v_OscAmpldModn[osc] = 1000;  // Fixed, maximum level
-
-    if (v_OscAmpldModn[osc] > 1000)  v_OscAmpldModn[osc] = 1000;  // limit to 1000
-
-    // Update mixer input level for each oscillator...
-    if (m_OscMuted[osc])  v_MixerLevel[osc] = 0;
-    else
+    pv->DirtyFlags &= ~DIRTY_OSC_MODN_SOURCE;
+    m_OscModnInvert = 0;
+    for (osc = 0;  osc < 6;  osc++)
+    {
+      switch (g_Patch.OscAmpldModSource[osc])
+      {
+      case OSC_MODN_SOURCE_CONT_NEG:  m_OscModnInvert |= 1 << osc;  // fall thru
+      case OSC_MODN_SOURCE_CONT_POS:  pv->OscModnSource[osc] = &pv->ContourOutput;  break;
+      case OSC_MODN_SOURCE_ENV2:      pv->OscModnSource[osc] = &pv->Env2.Output;  break;
+      case OSC_MODN_SOURCE_MODN:      pv->OscModnSource[osc] = &m_ModulationLevel;  break;
+      case OSC_MODN_SOURCE_EXPR_NEG:  m_OscModnInvert |= 1 << osc;  // fall thru
+      case OSC_MODN_SOURCE_EXPR_POS:  pv->OscModnSource[osc] = &m_ExpressionLevel;  break;
+      case OSC_MODN_SOURCE_LFO:       pv->OscModnSource[osc] = &m_LFO_AM_Level;  break;
+      case OSC_MODN_SOURCE_VELO_NEG:  m_OscModnInvert |= 1 << osc;  // fall thru
+      case OSC_MODN_SOURCE_VELO_POS:  pv->OscModnSource[osc] = &pv->KeyVelocity;  break;
+      default:                        pv->OscModnSource[osc] = &m_ModnFixedMax;  break;
+      }
+    }
+  }
+
+  if (pv->DirtyFlags & DIRTY_MIXER_LEVELS)  // Update mixer input levels and output gain
+  {
+    pv->DirtyFlags &= ~DIRTY_MIXER_LEVELS;
+    for (osc = 0;  osc < 6;  osc++)
     {
-      step = g_Patch.MixerInputStep[osc];  // 0..16
-      v_MixerLevel[osc] = g_AmpldLevelLogScale_x1000[step];  // 0..1000
+      if (pv->OscMuted[osc])  pv->MixerLevel[osc] = 0;
+      else
+      {
+        step = g_Patch.MixerInputStep[osc];  // 0..16
+        pv->MixerLevel[osc] = g_AmpldLevelLogScale_x1000[step];  // 0..1000
+      }
     }
+    // Set Mixer Output Gain control according to patch param.
+    v_MixerOutGain = (g_Patch.MixerOutGain_x10 << 7) / 10;  // 0..1280
+  }
+
+  m_LFO_AM_Level = LFO_scaled + LFO_AM_bias;
+
+  for (osc = 0;  osc < 6;  osc++)
+  {
+    // Determine Ampld Modulation factor for each oscillator
+    pv->OscAmpldModn[osc] = *pv->OscModnSource[osc] >> 10;  // 0..1024
+    if (m_OscModnInvert & (1 << osc))
+      pv->OscAmpldModn[osc] = 1024 - pv->OscAmpldModn[osc];  // 1024..0
+
+    if (pv->OscAmpldModn[osc] > 1000)  pv->OscAmpldModn[osc] = 1000;  // limit to 1000
+
+    // Combine ampld modulation and mixer level into one multiplier for the ISR
+    oscGain[osc] = ((uint32_t) pv->OscAmpldModn[osc] * pv->MixerLevel[osc]) >> 10;
+    gainSum += oscGain[osc];
   } // end for-loop
 
-  // Set Mixer Output Gain control according to patch param.
-  v_MixerOutGain = (g_Patch.MixerOutGain_x10 << 7) / 10;  // 0..1280
+  // Worst case: all osc's at full scale (1.0) in phase -- (Sum * 1024) * OutGain / 128
+  peakLevel = (gainSum * v_MixerOutGain) << 3;
+  limiterNeeded = (peakLevel > (uint32_t) v_LimiterLevelPos);
+
+  // If the limiter is to be removed, do it after the new gains are applied, else before
+  if (limiterNeeded)  { pv->LimiterNeeded = TRUE;  AudioKernelSelect(); }
+  for (osc = 0;  osc < 6;  osc++)  { pv->OscGain[osc] = oscGain[osc]; }
+  if (!limiterNeeded)  { pv->LimiterNeeded = FALSE;  AudioKernelSelect(); }
+
+  OscActiveListUpdate(pv);
 }
 
 
-/*`````````````````````````````````````````````````````````````````````````````````````````````````
- * Function:     Timer-Counter-3 interrupt service routine (Audio ISR)
- *
- * The ISR performs audio DSP synthesis computations which need to be executed at the
- * sample rate, defined by SAMPLE_RATE_HZ (typ. 32 or 40 kHz).
+/*
+ * Function:     Update the list of active (audible) oscillators of a voice for the audio
+ *               ISR.  Called by OscAmpldModulation() after the osc gains are updated.
  *
- * Signal (sample) computations use 32-bit [12:20] fixed-point arithmetic, except
- * that wave-table samples are stored as 16-bit signed integers. Wave-table samples are
- * converted to normalized fixed-point (20-bit fraction) by shifting left 5 bit places.
+ * The audio ISR computes only those oscillators in the list pv->ActiveOsc[].  An osc is
+ * omitted if its gain is zero, i.e. it is muted, its mixer level is zero or its ampld
+ * modulation is zero.  The phase angle of an omitted osc is not advanced by the ISR, so
+ * here it is advanced by the number of samples computed since the previous update.
+ * Hence the osc phase remains coherent with the other oscillators when it becomes active.
  *
- * The Wave-table Oscillator algorithm uses lower precision  [16:16] fixed-point variables
- * for phase angle to avoid arithmetic overflow which would occur using the [12:20] format.
+ * The phase angle (2^32 = 1 cycle) wraps correctly on 32-bit overflow.
  */
-void  TC3_Handler(void)
-{
-  static   int   rvbIndex;        // index into ReverbDelayLine[]
-  static   fixed_t  reverbPrev;   // previous output from reverb delay line
-  int      osc;                   // oscillator number (0..5)
-  int      idx;                   // index into wave-table
-  fixed_t  oscSample;             // wave-table sample (normalized fixed_pt)
-  fixed_t  mixerOut = 0;          // output from mixer
-  fixed_t  attenOut = 0;          // output from variable-gain attenuator
-  fixed_t  reverbOut;             // output from reverb delay line
-  fixed_t  reverbLPF;             // output from reverb filter
-  fixed_t  finalOutput = 0;       // output to audio DAC
-  uint16_t   spiDACdata;            // SPI DAC register data
 
-  digitalWrite(TESTPOINT1, HIGH);  // pin pulses high during ISR execution
+void  OscActiveListUpdate(SynthVoice_t *pv)
+{
+  uint8_t   activeList[6];
+  uint8_t   activeMask = 0;
+  uint8_t   count = 0;
+  uint32_t  elapsed;
+  int  osc;
 
-  if (v_SynthEnable)
+  for (osc = 0;  osc < 6;  osc++)
   {
-    for (osc = 0;  osc < 6;  osc++)
+    if (pv->OscGain[osc] != 0)
     {
-      // Wave-table oscillator algorithm
-      idx = v_OscAngle[osc] >> 16;  // integer part of v_OscAngle
-      oscSample = (fixed_t) g_sine_wave[idx] << 5;  // normalize
-      v_OscAngle[osc] += v_OscStep[osc];
-      if (v_OscAngle[osc] >= (WAVE_TABLE_SIZE << 16))
-        v_OscAngle[osc] -= (WAVE_TABLE_SIZE << 16);
-
-      // Apply oscillator amplitude modulation
-      oscSample = (oscSample * v_OscAmpldModn[osc]) >> 10; // scalar multiply
-
-      // Feed oscSample into mixer, scaled by the respective input setting
-      mixerOut += (oscSample * v_MixerLevel[osc]) >> 10;  // scalar multiply
+      activeList[count++] = osc;
+      activeMask |= 1 << osc;
     }
+  }
 
-    // Apply Mixer Gain parameter to optimize output level
-    mixerOut = (mixerOut * v_MixerOutGain) >> 7;  // (mixerOut * v_MixerOutGain) / 128
-
-    // Apply Ampld Limiter
-    if (mixerOut > v_LimiterLevelPos)  mixerOut = v_LimiterLevelPos;
-    if (mixerOut < v_LimiterLevelNeg)  mixerOut = v_LimiterLevelNeg;
-
-    // Output attenuator -- Apply envelope, velocity, expression, etc.
-    attenOut = (mixerOut * v_OutputLevel) >> 10;  // scalar multiply
+  noInterrupts();  // ISR must not run while osc angles and list are updated
+  elapsed = v_SampleCount - pv->SampleCountPrev;
+  pv->SampleCountPrev = v_SampleCount;
 
-    // Reverberation effect (Courtesy of Dan Mitchell, ref. "BasicSynth")
-    if (m_RvbMix)
+  for (osc = 0;  osc < 6;  osc++)
+  {
+    if ((pv->OscActiveMask & (1 << osc)) == 0)  // osc was omitted -- fast-forward phase
     {
-      reverbOut = MultiplyFixed(ReverbDelayLine[rvbIndex], m_RvbDecay);
-      reverbLPF = (reverbOut + reverbPrev) >> 1;  // simple low-pass filter
-      reverbPrev = reverbOut;
-      ReverbDelayLine[rvbIndex] = ((attenOut * m_RvbAtten) >> 7) + reverbLPF;
-      if (++rvbIndex >= m_RvbDelayLen)  rvbIndex = 0;  // wrap
-      // Add reverb output to dry signal according to reverb mix setting...
-      finalOutput = (attenOut * (128 - m_RvbMix)) >> 7;  // Dry portion
-      finalOutput += (reverbOut * m_RvbMix) >> 7;   // Wet portion
+      pv->OscAngle[osc] += pv->OscStepSkip[osc] * elapsed;
     }
-    else  finalOutput = attenOut;
+    pv->OscStepSkip[osc] = pv->OscStep[osc];
   }
 
-#if USE_SPI_DAC_FOR_AUDIO
-  spiDACdata = (uint16_t)(2048 + (int)(finalOutput >> 9));  // 12 LS bits
-  digitalWrite(SPI_DAC_CS, LOW);
-  SPI.transfer16(spiDACdata | 0x3000 );
-  digitalWrite(SPI_DAC_CS, HIGH);
+  for (osc = 0;  osc < count;  osc++)  { pv->ActiveOsc[osc] = activeList[osc]; }
+  pv->ActiveOscCount = count;
+  pv->OscActiveMask = activeMask;
+  interrupts();
+}
+
+
+#if AUDIO_ISR_LOAD_MONITOR
+/*
+ * Audio ISR load monitor...  (See also CYCLE_COUNT() and CyclesElapsed() at top of file.)
+ *
+ * Time spent in interrupt entry and exit (approx. 30 cycles) is not included.
+ */
+/*
+ * Function:     Update audio ISR statistics.  Called at the end of each audio interrupt.
+ *
+ * Entry args:   tEntry  = cycle counter value captured on entry to the ISR
+ *               samples = number of samples computed by the ISR (1 or block size)
+ *
+ * An overrun is counted if the time since the previous interrupt exceeds 1.5 x the
+ * expected interrupt period, i.e. the ISR was late or an interrupt was missed.
+ * In DMA block mode the block period exceeds the 1ms SysTick reload, so the interval
+ * cannot be measured here;  overruns are counted by DMAC_Handler() instead.
+ */
+static inline void  IsrLoadMeasure(uint32_t tEntry, int samples)
+{
+  uint32_t  cycles = CyclesElapsed(tEntry, CYCLE_COUNT());
+  uint32_t  perSample = cycles / samples;  // samples is constant (inline)
+
+#if (!USE_DMA_AUDIO_OUTPUT)
+  static uint32_t  tEntryLast;
+  static bool  started;
+
+  if (started && CyclesElapsed(tEntryLast, tEntry) > (m_IsrPeriodCycles * 3) / 2)
+    v_IsrOverruns++;
+  tEntryLast = tEntry;
+  started = TRUE;
+#endif
+
+  v_IsrCyclesSum += cycles;
+  v_IsrSampleCount += samples;
+  if (perSample < v_IsrCyclesMin)  v_IsrCyclesMin = perSample;
+  if (perSample > v_IsrCyclesMax)  v_IsrCyclesMax = perSample;
+}
+
+
+/*
+ * Function:     Compute the average cycles per sample and running CPU load of the audio ISR.
+ *               Called by SynthProcess() every 100 ms.
+ */
+void  IsrLoadUpdate()
+{
+  uint32_t  cyclesSum, sampleCount, load_x10;
+
+  noInterrupts();
+  cyclesSum = v_IsrCyclesSum;
+  sampleCount = v_IsrSampleCount;
+  v_IsrCyclesSum = 0;
+  v_IsrSampleCount = 0;
+  interrupts();
+
+  if (sampleCount != 0)
+  {
+    m_IsrCyclesAvg = cyclesSum / sampleCount;
+    load_x10 = (uint32_t)(((uint64_t) cyclesSum * 1000) / (sampleCount * m_IsrPeriodCycles));
+    m_IsrLoad_x10 = (uint16_t)((m_IsrLoad_x10 * 3 + load_x10) / 4);  // IIR filter, K = 1/4
+  }
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     Get audio ISR load statistics, optionally resetting min/max values
+ *               and overrun count.
+ *
+ * Entry args:   pStats = pointer to structure to receive statistics
+ *               reset  = TRUE to reset min/max values and overrun count after reading
+ */
+void  SynthGetIsrStats(AudioIsrStats_t *pStats, bool reset)
+{
+  noInterrupts();
+  pStats->CyclesMin = (v_IsrCyclesMin == 0xFFFFFFFF) ? 0 : v_IsrCyclesMin;
+  pStats->CyclesMax = v_IsrCyclesMax;
+  pStats->OverrunCount = v_IsrOverruns;
+  if (reset)
+  {
+    v_IsrCyclesMin = 0xFFFFFFFF;
+    v_IsrCyclesMax = 0;
+    v_IsrOverruns = 0;
+  }
+  interrupts();
+
+  pStats->CyclesAvg = m_IsrCyclesAvg;
+  pStats->LoadPc_x10 = m_IsrLoad_x10;
+  pStats->SynthProcessMax = m_SynthProcessMax;
+  pStats->SampleRate_Hz = g_SampleRate;
+  if (reset)  m_SynthProcessMax = 0;
+}
+
+#endif  // AUDIO_ISR_LOAD_MONITOR
+
+
+/*
+ * Function:     Get voice status for reply to a status poll from the master, which uses
+ *               it to choose the quietest voice for a new note.
+ *
+ * Entry args:   voice   = synth engine voice (0..SYNTH_VOICE_COUNT-1)
+ *               pStatus = pointer to structure to receive status data (7-bit values)
+ */
+void  SynthGetStatus(uint8_t voice, VoiceStatus_t *pStatus)
+{
+  SynthVoice_t  *pv = &m_Voice[voice];
+  uint16_t  outputLevel = pv->OutputLevel;  // 0..1024
+
+  pStatus->Env1Phase = pv->Env1.Segment;
+  pStatus->Env1Level = (pv->Env1.Output >= FIXED_MAX_LEVEL) ? 127 : (pv->Env1.Output >> 13);
+  pStatus->OutputLevel = (outputLevel >= 1024) ? 127 : (outputLevel >> 3);
+#if AUDIO_ISR_LOAD_MONITOR
+  pStatus->LoadPc = (m_IsrLoad_x10 >= 1000) ? 100 : (m_IsrLoad_x10 / 10);
+#else
+  pStatus->LoadPc = 0;
+#endif
+  pStatus->NotePlaying = pv->NotePlaying & 0x7F;
+}
+
+
+#if NOTE_LATENCY_TRACE
+/*
+ * Note latency trace...  A Note-On which triggers an attack is traced through the stages:
+ * receipt (time-stamped by the MIDI IN parser), envelope trigger (AmpldEnvelopeGenerator)
+ * and the first sample at non-zero output level (audio ISR).  In DMA block mode, the
+ * "audible" sample is rendered up to one block ahead of its output to the DAC.
+ * The intervals from all voices hosted are accumulated in one histogram per stage.
+ */
+static LatencyHist_t  m_LatencyHist[LATENCY_STAGES];
+
+/*
+ * Function:     Start the latency trace of a Note-On, if it has triggered an attack (not a
+ *               legato note change).  Called after SynthNoteOn().  A note not yet traced
+ *               to an audible sample is abandoned.
+ *
+ * Entry args:   voice  = synth engine voice (0..SYNTH_VOICE_COUNT-1)
+ *               rxTime = Note-On receipt time-stamp (micros)
+ */
+void  SynthLatencyTraceStart(uint8_t voice, uint32_t rxTime)
+{
+  SynthVoice_t  *pv = &m_Voice[voice];
+
+  if (!pv->TriggerAttack1)  return;  // no attack triggered
+
+  noInterrupts();  // audio ISR may complete the previous trace
+  pv->TraceRxTime = rxTime;
+  pv->TraceState = TRACE_NOTE_RCVD;
+  interrupts();
+}
+
+
+// Add a time interval (us) to a latency histogram.  Bin n holds intervals less than
+// LATENCY_BIN0_US x 2^n;  the last bin holds all longer intervals.
+//
+void  LatencyHistAdd(LatencyHist_t *pHist, uint32_t time_us)
+{
+  uint32_t  t = time_us / LATENCY_BIN0_US;
+  uint8_t   bin = 0;
+
+  while (t != 0 && bin < LATENCY_HIST_BINS - 1)  { t >>= 1;  bin++; }
+
+  if (pHist->Bin[bin] < 0xFFFF)  pHist->Bin[bin]++;
+  pHist->Count++;
+  pHist->Total_us += time_us;
+  if (time_us > pHist->Max_us)  pHist->Max_us = time_us;
+}
+
+
+// Record the stage intervals of a note traced to an audible sample;  end the trace.
+// Called by SynthProcess() when the audio ISR has set the trace state TRACE_AUDIBLE.
+//
+void  LatencyTraceRecord(SynthVoice_t *pv)
+{
+  LatencyHistAdd(&m_LatencyHist[LATENCY_RX_TO_TRIGGER], pv->TraceTrigTime - pv->TraceRxTime);
+  LatencyHistAdd(&m_LatencyHist[LATENCY_TRIGGER_TO_AUDIO], pv->TraceAudioTime - pv->TraceTrigTime);
+  LatencyHistAdd(&m_LatencyHist[LATENCY_RX_TO_AUDIO], pv->TraceAudioTime - pv->TraceRxTime);
+  pv->TraceState = TRACE_IDLE;
+}
+
+
+/*
+ * Function:     Get a note latency histogram, optionally resetting it.
+ *
+ * Entry args:   stage = LATENCY_RX_TO_TRIGGER, _TRIGGER_TO_AUDIO or _RX_TO_AUDIO
+ *               pHist = pointer to structure to receive histogram
+ *               reset = TRUE to clear the histogram after reading
+ */
+void  SynthGetLatencyHist(uint8_t stage, LatencyHist_t *pHist, bool reset)
+{
+  if (stage >= LATENCY_STAGES)  stage = LATENCY_RX_TO_AUDIO;
+
+  memcpy(pHist, &m_LatencyHist[stage], sizeof(LatencyHist_t));
+  if (reset)  memset(&m_LatencyHist[stage], 0, sizeof(LatencyHist_t));
+}
+
+#endif  // NOTE_LATENCY_TRACE
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Reverb effect -- called by the audio ISR (render kernel) for each sample.
+ *
+ * Delay line samples are 16-bit, scaled by 2 ^ -REVERB_SAMPLE_SHIFT from fixed_t, i.e.
+ * range +/-4.0 normalized;  all products fit in 32 bits (no 64-bit multiply).  Each delay
+ * line is read, then written, at one index per sample, so the execution time per sample
+ * is constant (4 comb + 2 allpass updates in network mode).  Delay line writes are
+ * saturated, so that an extreme input level cannot cause a wrap-around "click".
+ *
+ * Entry arg:    input = reverb input signal (attenuated), normalized fixed-point
+ * Return val:   (fixed_t) reverb output signal (wet), normalized fixed-point
+ */
+static inline __attribute__((always_inline)) int16_t  ReverbSaturate(int sample)
+{
+  if (sample > 32767)  return  32767;
+  if (sample < -32767)  return  -32767;
+  return  (int16_t) sample;
+}
+
+// Single delay line with low-pass filter (Courtesy of Dan Mitchell, ref. "BasicSynth")
+//
+static inline __attribute__((always_inline)) fixed_t  ReverbSingleLine(fixed_t input)
+{
+  int  reverbOut = (ReverbBuffer[m_RvbIndex] * m_RvbDecay) >> 15;
+  int  reverbLPF = (reverbOut + m_RvbPrev) >> 1;  // simple low-pass filter
+
+  m_RvbPrev = reverbOut;
+  ReverbBuffer[m_RvbIndex] = ReverbSaturate((input >> REVERB_SAMPLE_SHIFT) + reverbLPF);
+  if (++m_RvbIndex >= m_RvbDelayLen)  m_RvbIndex = 0;  // wrap
+
+  return  (fixed_t) reverbOut << REVERB_SAMPLE_SHIFT;
+}
+
+// Network of 4 parallel comb filters and 2 allpass filters in series (see ReverbPrepare)
+//
+static inline __attribute__((always_inline)) fixed_t  ReverbNetwork(fixed_t input)
+{
+  RvbDelayLine_t  *line;
+  int  x = ((input >> REVERB_SAMPLE_SHIFT) * m_RvbInGain) >> 15;  // comb input
+  int  sum = 0;
+  int  out;
+  int  k;
+
+  for (k = 0;  k < REVERB_COMB_COUNT;  k++)
+  {
+    line = &m_RvbComb[k];
+    out = line->buf[line->idx];
+    line->filt = (out + line->filt) >> 1;  // low-pass filter in feedback loop
+    line->buf[line->idx] = ReverbSaturate(x + ((line->filt * line->gain) >> 15));
+    if (++line->idx >= line->len)  line->idx = 0;  // wrap
+    sum += out;
+  }
+
+  x = sum >> 1;  // allpass input
+  for (k = 0;  k < REVERB_ALLPASS_COUNT;  k++)
+  {
+    line = &m_RvbAllpass[k];
+    out = line->buf[line->idx];
+    line->buf[line->idx] = ReverbSaturate(x + (out >> 1));  // feedback gain = 0.5
+    x = out - x;
+    if (++line->idx >= line->len)  line->idx = 0;  // wrap
+  }
+
+  return  (fixed_t) x << (REVERB_SAMPLE_SHIFT + 1);  // wet gain x2
+}
+
+
+/*
+ * Function:     Compute one audio sample of a voice:  oscillators, mixer, limiter and
+ *               output attenuator.  Called by AudioSampleCompute() for each voice.
+ *
+ * Entry args:   pv      = pointer to voice state
+ *               limiter = TRUE to apply amplitude limiter
+ *
+ * Return val:   (fixed_t) voice output, attenuated (normalized)
+ */
+static inline __attribute__((always_inline)) fixed_t  AudioVoiceCompute(SynthVoice_t *pv, bool limiter)
+{
+  int      osc;                   // oscillator number (0..5)
+  int      n;                     // index into active osc list
+  int      nosc = pv->ActiveOscCount;  // number of active (audible) osc's
+  uint32_t angle;                 // osc phase angle (2^32 = 1 cycle)
+  fixed_t  oscSample;             // wave-table sample (normalized fixed_pt)
+  fixed_t  mixerOut = 0;          // output from mixer
+  fixed_t  attenOut = 0;          // output from variable-gain attenuator
+
+  for (n = 0;  n < nosc;  n++)
+  {
+    osc = pv->ActiveOsc[n];
+
+    // Wave-table oscillator algorithm
+    angle = pv->OscAngle[osc];
+    oscSample = OscWaveLookup(angle);  // normalized
+    pv->OscAngle[osc] = angle + pv->OscStep[osc];  // wraps at 2^32 (1 cycle)
+
+    // Apply oscillator amplitude modulation and mixer input level (combined)
+    mixerOut += (oscSample * pv->OscGain[osc]) >> 10;  // scalar multiply
+  }
+
+  // Apply Mixer Gain parameter to optimize output level
+  mixerOut = (mixerOut * v_MixerOutGain) >> 7;  // (mixerOut * v_MixerOutGain) / 128
+
+  // Apply Ampld Limiter
+  if (limiter)
+  {
+    if (mixerOut > v_LimiterLevelPos)  mixerOut = v_LimiterLevelPos;
+    if (mixerOut < v_LimiterLevelNeg)  mixerOut = v_LimiterLevelNeg;
+  }
+
+  // Output attenuator -- Apply envelope, velocity, expression, etc.
+#if AUDIO_LEVEL_RAMP
+  if (pv->OutputRampCount != 0)  // ramp to OutputLevel in progress
+  {
+    if (--pv->OutputRampCount == 0)  pv->OutputLevelFine = (uint32_t) pv->OutputLevel << 16;
+    else  pv->OutputLevelFine += pv->OutputRampStep;
+  }
+  attenOut = (mixerOut * (fixed_t)(pv->OutputLevelFine >> 16)) >> 10;  // scalar multiply
+#else
+  attenOut = (mixerOut * pv->OutputLevel) >> 10;  // scalar multiply
+#endif
+
+#if NOTE_LATENCY_TRACE
+#if AUDIO_LEVEL_RAMP
+  if (pv->TraceState == TRACE_TRIGGERED && (pv->OutputLevelFine >> 16) != 0)
+#else
+  if (pv->TraceState == TRACE_TRIGGERED && pv->OutputLevel != 0)
+#endif
+  {
+    pv->TraceAudioTime = TimeStamp_us();  // ISR may pre-empt sysTickHook()
+    pv->TraceState = TRACE_AUDIBLE;  // recorded by SynthProcess()
+  }
+#endif
+
+  return  attenOut;
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     Audio sample computation -- called by the audio ISR at the sample rate
+ *               (TC3 mode) or by AudioRenderBlock() (DMA block mode), via one of the
+ *               specialized render kernels below.
+ *
+ * The routine performs audio DSP synthesis computations which need to be executed at the
+ * sample rate, g_SampleRate (32, 40 or 48 kHz).
+ *
+ * Signal (sample) computations use 32-bit [12:20] fixed-point arithmetic, except
+ * that wave-table samples are stored as 16-bit signed integers. Wave-table samples are
+ * converted to normalized fixed-point (20-bit fraction) by shifting left 5 bit places.
+ *
+ * The Wave-table Oscillator algorithm uses a 32-bit unsigned phase angle (2^32 = 1 cycle)
+ * which wraps on overflow.  The wave-table index is the top 11 bits of the phase angle.
+ * If WAVE_TABLE_INTERPOLATE is TRUE, the output is interpolated linearly between adjacent
+ * table samples, using the next 15 bits of the phase angle as the fraction.
+ * (See OscWaveLookup().)
+ *
+ * The arguments are constants in each kernel, so the compiler removes the code which is
+ * not needed in that kernel, including the tests.
+ *
+ * The oscillators, mixer, limiter and output attenuator of each voice are computed by
+ * AudioVoiceCompute();  the voice outputs are summed (scaled by 1 / SYNTH_VOICE_COUNT,
+ * so the sum cannot exceed full scale) into the reverb and the audio DAC.
+ *
+ * Entry args:   reverb  = TRUE to apply reverb effect  (m_RvbMix != 0)
+ *               network = TRUE for reverb network, FALSE for single delay line
+ *               limiter = TRUE to apply amplitude limiter
+ *
+ * Return val:   (fixed_t) sample value to be written to the audio DAC (normalized)
+ */
+static inline __attribute__((always_inline)) fixed_t  AudioSampleCompute(bool reverb, bool network, bool limiter)
+{
+  int      voice;
+  fixed_t  attenOut = 0;          // sum of voice outputs (attenuated)
+  fixed_t  reverbOut;             // output from reverb (wet signal)
+  fixed_t  finalOutput = 0;       // output to audio DAC
+
+  for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+  {
+    attenOut += AudioVoiceCompute(&m_Voice[voice], limiter);
+  }
+#if DUAL_VOICE_ENGINE
+  attenOut = attenOut >> 1;       // sum of 2 voices, each up to full scale
+#endif
+
+  // Reverberation effect
+  if (reverb)
+  {
+    if (network)  reverbOut = ReverbNetwork((attenOut * m_RvbAtten) >> 7);
+    else  reverbOut = ReverbSingleLine((attenOut * m_RvbAtten) >> 7);
+    // Add reverb output to dry signal according to reverb mix setting...
+    finalOutput = (attenOut * (128 - m_RvbMix)) >> 7;  // Dry portion
+    finalOutput += (reverbOut * m_RvbMix) >> 7;   // Wet portion
+  }
+  else  finalOutput = attenOut;
+
+  return  finalOutput;
+}
+
+// Audio render kernels...  One of these is installed in v_AudioKernel by AudioKernelSelect().
+//
+static fixed_t  AudioKernelMute(void)       { return  0; }
+static fixed_t  AudioKernelDry(void)        { return  AudioSampleCompute(FALSE, FALSE, FALSE); }
+static fixed_t  AudioKernelDryLim(void)     { return  AudioSampleCompute(FALSE, FALSE, TRUE); }
+static fixed_t  AudioKernelReverb(void)     { return  AudioSampleCompute(TRUE, FALSE, FALSE); }
+static fixed_t  AudioKernelReverbLim(void)  { return  AudioSampleCompute(TRUE, FALSE, TRUE); }
+static fixed_t  AudioKernelNetwork(void)    { return  AudioSampleCompute(TRUE, TRUE, FALSE); }
+static fixed_t  AudioKernelNetworkLim(void) { return  AudioSampleCompute(TRUE, TRUE, TRUE); }
+
+/*
+ * Function:     Select the audio render kernel to suit the synth state:  muted (synth not
+ *               enabled), reverb off, single-line or network, and limiter needed or not.
+ *
+ * Called by SynthPrepare(), SynthSetReverbMix() and OscAmpldModulation() (every 5ms).
+ * The limiter is applied (to every voice) if it is needed by any voice.
+ */
+static void  AudioKernelSelect(void)
+{
+  bool  limiterNeeded = FALSE;
+  int   voice;
+
+  for (voice = 0;  voice < SYNTH_VOICE_COUNT;  voice++)
+  {
+    if (m_Voice[voice].LimiterNeeded)  limiterNeeded = TRUE;
+  }
+
+  if (!v_SynthEnable)  v_AudioKernel = AudioKernelMute;
+  else if (m_RvbMix && g_Config.ReverbMode == REVERB_MODE_NETWORK)
+    v_AudioKernel = (limiterNeeded) ? AudioKernelNetworkLim : AudioKernelNetwork;
+  else if (m_RvbMix)
+    v_AudioKernel = (limiterNeeded) ? AudioKernelReverbLim : AudioKernelReverb;
+  else
+    v_AudioKernel = (limiterNeeded) ? AudioKernelDryLim : AudioKernelDry;
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     Measure the worst-case execution time of the audio ISR at the default
+ *               sample rate.  The result is used by SynthSetSampleRate() to decide whether
+ *               a higher sample rate can be supported.
+ *
+ * Called by setup() once, after the audio ISR is started and before any note is played.
+ * All 6 oscillators of every voice are computed, with reverb network and limiter applied,
+ * for 50 ms.  The osc gains are zero at this point, so the output is silent.
+ *
+ * If AUDIO_ISR_LOAD_MONITOR is FALSE, no measurement is made and only the default
+ * sample rate is allowed.
+ */
+void  SynthBenchmarkAudio()
+{
+#if AUDIO_ISR_LOAD_MONITOR
+  AudioIsrStats_t  stats;
+  SynthVoice_t  *pv;
+  int  osc;
+
+  noInterrupts();
+  for (pv = m_Voice;  pv < &m_Voice[SYNTH_VOICE_COUNT];  pv++)
+  {
+    for (osc = 0;  osc < 6;  osc++)  { pv->ActiveOsc[osc] = osc; }
+    pv->ActiveOscCount = 6;
+    pv->OscActiveMask = 0x3F;
+  }
+  v_AudioKernel = AudioKernelNetworkLim;  // worst case
+  interrupts();
+
+  delay(10);
+  SynthGetIsrStats(&stats, TRUE);  // discard start-up measurements
+  delay(50);
+  SynthGetIsrStats(&stats, TRUE);
+  m_IsrBenchCycles = stats.CyclesMax + ISR_ENTRY_EXIT_CYCLES;
+
+  AudioKernelSelect();  // restore kernel for current synth state
+#endif
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     Set the audio sample rate.  The timer period (TC3 or TCC0), osc phase
+ *               steps, reverb delay length and osc mute threshold are all derived from
+ *               g_SampleRate.  Audio output is muted and the reverb delay line is cleared;
+ *               the synth engine is re-initialized by SynthPrepare().
+ *
+ * A rate other than SAMPLE_RATE_DEFAULT is refused if the audio ISR load at that rate,
+ * estimated from the boot benchmark, would exceed SAMPLE_RATE_LOAD_MAX_PC.
+ *
+ * Entry args:   rate_Hz = sample rate (Hz): 32000, 40000 or 48000 (F_CPU multiples)
+ *
+ * Return val:   (bool) TRUE if the sample rate is set, FALSE if refused
+ */
+bool  SynthSetSampleRate(uint16_t rate_Hz)
+{
+  if (rate_Hz != 32000 && rate_Hz != 40000 && rate_Hz != 48000)  return FALSE;
+
+  if (rate_Hz != SAMPLE_RATE_DEFAULT)
+  {
+    if (m_IsrBenchCycles == 0)  return FALSE;  // not measured
+    if ((m_IsrBenchCycles * rate_Hz) > (F_CPU / 100) * SAMPLE_RATE_LOAD_MAX_PC)
+      return FALSE;
+  }
+  if (rate_Hz == g_SampleRate)  return TRUE;
+
+  v_SynthEnable = 0;  // mute audio
+  AudioKernelSelect();
+  g_SampleRate = rate_Hz;
+  m_IsrPeriodCycles = F_CPU / rate_Hz;
+  m_MaxOscFreq = rate_Hz * MAX_OSC_FREQ_FACTOR;
+  m_OscStepScale = (fixed_t)(((int64_t) SAMPLE_RATE_DEFAULT << 20) / rate_Hz);
+#if AUDIO_LEVEL_RAMP
+  m_RampSamples = rate_Hz / 1000;
+  m_RampStepRecip = 65536 / m_RampSamples;
+#endif
+
+#if USE_DMA_AUDIO_OUTPUT
+  TCC0->PERB.reg = m_IsrPeriodCycles - 1;  // buffered -- takes effect at next period
+  while (TCC0->SYNCBUSY.bit.PERB) ;
+#else
+  fast_samd21_tc3_stop();
+  fast_samd21_tc3_configure((float) 1000000 / g_SampleRate);
+  fast_samd21_tc3_start();
+#endif
+
+  SynthPrepare();
+  return TRUE;
+}
+
+
+#if (!USE_DMA_AUDIO_OUTPUT)
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     Timer-Counter-3 interrupt service routine (Audio ISR)
+ *
+ * The ISR computes one audio sample per interrupt and writes it to the audio DAC.
+ */
+void  TC3_Handler(void)
+{
+  fixed_t  finalOutput = 0;       // output to audio DAC
+  uint16_t   spiDACdata;            // SPI DAC register data
+#if AUDIO_ISR_LOAD_MONITOR
+  uint32_t  tEntry = CYCLE_COUNT();
+#endif
+
+  digitalWrite(TESTPOINT1, HIGH);  // pin pulses high during ISR execution
+
+  finalOutput = (*v_AudioKernel)();
+  v_SampleCount++;
+
+#if USE_SPI_DAC_FOR_AUDIO
+  spiDACdata = (uint16_t)(2048 + (int)(finalOutput >> 9));  // 12 LS bits
+  digitalWrite(SPI_DAC_CS, LOW);
+  SPI.transfer16(spiDACdata | 0x3000 );
+  digitalWrite(SPI_DAC_CS, HIGH);
 #else
   analogWrite(A0, 512 + (int)(finalOutput >> 11));  // use on-chip DAC (10 bits)
 #endif
 
   digitalWrite(TESTPOINT1, LOW);
   TC3->COUNT16.INTFLAG.bit.MC0 = 1;  // clear the IRQ
+#if AUDIO_ISR_LOAD_MONITOR
+  IsrLoadMeasure(tEntry, 1);
+#endif
+}
+
+#else  // USE_DMA_AUDIO_OUTPUT
+/*
+ * DMA block audio output...
+ *
+ * Timer TCC0 runs in NPWM mode with period = 1 sample.  Waveform output WO[0]/WO[4]
+ * (CC0) drives the DAC chip-select pin:  CS is low from the start of each period until
+ * the CC0 match, then high, so the DAC latches its data at the CC0 match.
+ * DMA channel DAC_DMA_CH_MSB is triggered by TCC0 overflow and writes the MS byte of
+ * the next DAC word to the SERCOM SPI data register.  On completion of each beat it
+ * strobes an event (via EVSYS) which triggers channel DAC_DMA_CH_LSB to write the LS byte.
+ * The SERCOM TX buffer is double-buffered, so the two bytes go out back-to-back.
+ *
+ * Each channel has two linked descriptors, one per half of m_DacBlockBuffer[][], linked
+ * in a loop.  At the end of each block, channel DAC_DMA_CH_LSB raises an interrupt and
+ * DMAC_Handler() renders the next block into the half which has just been sent.
+ */
+#include <wiring_private.h>
+
+#define DAC_DMA_CH_MSB       0       // DMA channel (0..3; needs event I/O)
+#define DAC_DMA_CH_LSB       1       // DMA channel (0..3; needs event I/O)
+#define DAC_SPI_SERCOM       SERCOM4       // SERCOM used by Arduino 'SPI' object
+#define DAC_CS_HIGH_COUNT    (F_CPU / 500000)  // TCC0 counts to CS rising edge (2us)
+#define DAC_WORD_IDLE        (2048 | 0x3000)   // DAC word for zero output (mid-scale)
+
+static DmacDescriptor  m_DmaBaseDescr[2] __attribute__ ((aligned (16)));
+static DmacDescriptor  m_DmaWrbkDescr[2] __attribute__ ((aligned (16)));
+static DmacDescriptor  m_DmaLinkDescr[2] __attribute__ ((aligned (16)));
+
+static uint16_t  m_DacBlockBuffer[2][AUDIO_BLOCK_SIZE];  // DAC words, double-buffered
+
+
+/*
+ * Function:     Render a block of audio samples into a DAC buffer.
+ *
+ * Entry args:   dacBuf = pointer to buffer to receive SPI DAC words
+ *               count  = number of samples to render
+ */
+static void  AudioRenderBlock(uint16_t *dacBuf, int count)
+{
+  pfnAudioKernel  audioKernel = v_AudioKernel;  // same kernel for whole block
+  fixed_t  finalOutput;
+  int  n;
+
+  for (n = 0;  n < count;  n++)
+  {
+    finalOutput = (*audioKernel)();
+    *dacBuf++ = (uint16_t)(2048 + (int)(finalOutput >> 9)) | 0x3000;
+  }
+  v_SampleCount += count;
+}
+
+
+/*
+ * Function:     Set up one DMA descriptor to transfer a block of DAC data bytes
+ *               to the SPI data register.
+ *
+ * Entry args:   descr   = pointer to descriptor
+ *               srcBuf  = DAC buffer (block)
+ *               byteSel = byte of each DAC word to transfer (1: MS byte, 0: LS byte)
+ *               next    = pointer to next descriptor (linked)
+ *               control = additional BTCTRL flags (event output, block action)
+ */
+static void  AudioDmaDescrSetup(DmacDescriptor *descr, uint16_t *srcBuf, int byteSel,
+                              DmacDescriptor *next, uint16_t control)
+{
+  descr->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_SRCINC
+                    | DMAC_BTCTRL_STEPSEL_SRC | DMAC_BTCTRL_STEPSIZE_X2 | control;
+  descr->BTCNT.reg = AUDIO_BLOCK_SIZE;
+  // Source address is the end address of the block (+1 step)
+  descr->SRCADDR.reg = (uint32_t)((uint8_t *)srcBuf + byteSel + AUDIO_BLOCK_SIZE * 2);
+  descr->DSTADDR.reg = (uint32_t) &DAC_SPI_SERCOM->SPI.DATA.reg;
+  descr->DESCADDR.reg = (uint32_t) next;
 }
 
 
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     Start the audio output DMA stream.  Called once at start-up, after
+ *               SynthPrepare(), instead of starting the TC3 audio ISR.
+ *
+ * Sets up DMA channels, event system and timer TCC0 as described above.
+ */
+void  SynthAudioStartDMA()
+{
+  int  i;
+
+  for (i = 0;  i < AUDIO_BLOCK_SIZE;  i++)  // DAC word 0x0000 would shut down the DAC
+  {
+    m_DacBlockBuffer[0][i] = DAC_WORD_IDLE;
+    m_DacBlockBuffer[1][i] = DAC_WORD_IDLE;
+  }
+
+  // Enable clocks for DMAC, EVSYS and TCC0
+  PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+  PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+  PM->APBCMASK.reg |= PM_APBCMASK_EVSYS | PM_APBCMASK_TCC0;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_TCC0_TCC1;
+  while (GCLK->STATUS.bit.SYNCBUSY) ;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_EVSYS_0;
+  while (GCLK->STATUS.bit.SYNCBUSY) ;
+
+  // DMA descriptors:  MS byte and LS byte of each DAC word, 2 blocks linked in a loop
+  AudioDmaDescrSetup(&m_DmaBaseDescr[DAC_DMA_CH_MSB], m_DacBlockBuffer[0], 1,
+                     &m_DmaLinkDescr[DAC_DMA_CH_MSB], DMAC_BTCTRL_EVOSEL_BEAT);
+  AudioDmaDescrSetup(&m_DmaLinkDescr[DAC_DMA_CH_MSB], m_DacBlockBuffer[1], 1,
+                     &m_DmaBaseDescr[DAC_DMA_CH_MSB], DMAC_BTCTRL_EVOSEL_BEAT);
+  AudioDmaDescrSetup(&m_DmaBaseDescr[DAC_DMA_CH_LSB], m_DacBlockBuffer[0], 0,
+                     &m_DmaLinkDescr[DAC_DMA_CH_LSB], DMAC_BTCTRL_BLOCKACT_INT);
+  AudioDmaDescrSetup(&m_DmaLinkDescr[DAC_DMA_CH_LSB], m_DacBlockBuffer[1], 0,
+                     &m_DmaBaseDescr[DAC_DMA_CH_LSB], DMAC_BTCTRL_BLOCKACT_INT);
+
+  DMAC->CTRL.reg = 0;
+  while (DMAC->CTRL.bit.DMAENABLE) ;
+  DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+  while (DMAC->CTRL.bit.SWRST) ;
+  DMAC->BASEADDR.reg = (uint32_t) m_DmaBaseDescr;
+  DMAC->WRBADDR.reg = (uint32_t) m_DmaWrbkDescr;
+  DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+  // Channel MSB: triggered by TCC0 overflow, 1 beat per trigger, event out per beat
+  DMAC->CHID.reg = DMAC_CHID_ID(DAC_DMA_CH_MSB);
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+  while (DMAC->CHCTRLA.bit.SWRST) ;
+  DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(TCC0_DMAC_ID_OVF)
+                    | DMAC_CHCTRLB_TRIGACT_BEAT | DMAC_CHCTRLB_EVOE;
+
+  // Channel LSB: triggered by event from channel MSB, interrupt on block complete
+  DMAC->CHID.reg = DMAC_CHID_ID(DAC_DMA_CH_LSB);
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+  while (DMAC->CHCTRLA.bit.SWRST) ;
+  DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(0) | DMAC_CHCTRLB_TRIGACT_BEAT
+                    | DMAC_CHCTRLB_EVIE | DMAC_CHCTRLB_EVACT_TRIG;
+  DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+
+  // Event system: EVSYS channel 0 routes DMAC channel MSB event to channel LSB
+  EVSYS->USER.reg = EVSYS_USER_USER(EVSYS_ID_USER_DMAC_CH_0 + DAC_DMA_CH_LSB)
+                  | EVSYS_USER_CHANNEL(1);  // EVSYS channel 0 (n + 1)
+  EVSYS->CHANNEL.reg = EVSYS_CHANNEL_CHANNEL(0) | EVSYS_CHANNEL_EDGSEL_RISING_EDGE
+                     | EVSYS_CHANNEL_PATH_RESYNCHRONIZED
+                     | EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_DMAC_CH_0 + DAC_DMA_CH_MSB);
+
+  NVIC_SetPriority(DMAC_IRQn, 0);
+  NVIC_EnableIRQ(DMAC_IRQn);
+
+  DMAC->CHID.reg = DMAC_CHID_ID(DAC_DMA_CH_LSB);
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+  DMAC->CHID.reg = DMAC_CHID_ID(DAC_DMA_CH_MSB);
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+
+  // Timer TCC0:  period = 1 sample;  CC0 output = DAC chip-select (low at start of period)
+  pinPeripheral(SPI_DAC_CS, (SPI_DAC_CS == 2) ? PIO_TIMER_ALT : PIO_TIMER);  // PA14 / PA08
+  TCC0->CTRLA.reg = TCC_CTRLA_SWRST;
+  while (TCC0->SYNCBUSY.bit.SWRST) ;
+  TCC0->WAVE.reg = TCC_WAVE_WAVEGEN_NPWM | TCC_WAVE_POL0;
+  while (TCC0->SYNCBUSY.bit.WAVE) ;
+  TCC0->PER.reg = m_IsrPeriodCycles - 1;
+  while (TCC0->SYNCBUSY.bit.PER) ;
+  TCC0->CC[0].reg = DAC_CS_HIGH_COUNT;
+  while (TCC0->SYNCBUSY.bit.CC0) ;
+  TCC0->CTRLA.reg = TCC_CTRLA_PRESCALER_DIV1 | TCC_CTRLA_ENABLE;
+  while (TCC0->SYNCBUSY.bit.ENABLE) ;
+}
+
+
+/*`````````````````````````````````````````````````````````````````````````````````````````````````
+ * Function:     DMA controller interrupt service routine (Audio block ISR)
+ *
+ * Called when the DMA has finished sending a block of samples to the DAC.
+ * The block just sent is refilled while the DMA sends the other block.
+ * If the other block has also been sent by the time rendering is done (block-done flag
+ * set again), the DMA has run into the block being refilled -- counted as an overrun.
+ */
+void  DMAC_Handler(void)
+{
+  static uint8_t  blockFree;   // index of DAC buffer block just sent (0 or 1)
+#if AUDIO_ISR_LOAD_MONITOR
+  uint32_t  tEntry = CYCLE_COUNT();
+#endif
+
+  DMAC->CHID.reg = DMAC_CHID_ID(DAC_DMA_CH_LSB);
+  DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;  // clear the IRQ
+
+  digitalWrite(TESTPOINT1, HIGH);  // pin pulses high during block rendering
+
+  AudioRenderBlock(m_DacBlockBuffer[blockFree], AUDIO_BLOCK_SIZE);
+  blockFree ^= 1;
+
+  digitalWrite(TESTPOINT1, LOW);
+#if AUDIO_ISR_LOAD_MONITOR
+  if (DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL)  v_IsrOverruns++;  // render too slow
+  IsrLoadMeasure(tEntry, AUDIO_BLOCK_SIZE);
+#endif
+}
+
+#endif  // USE_DMA_AUDIO_OUTPUT
+
+
 /*`````````````````````````````````````````````````````````````````````````````````````````````````
  * Function:    Base-2 exponential transfer function using look-up table with interpolation.
  *              Resolution (precision) is better than +/-0.0001
@@ -1047,10 +2275,10 @@ void  TC3_Handler(void)
 fixed_t  Base2Exp(fixed_t xval)
 {
   int   ixval;        // 13-bit integer representing x-axis coordinate
-  int   idx;          // 10 MS bits of ixval = array index into LUT, g_base2exp[]
+  int   idx;          // 10 MS bits of ixval = array index into LUT, g_base2exp
   int   irem3;        // 3 LS bits of ixval for interpolation
-  long ydelta;       // change in y value between 2 adjacent points in LUT
-  long yval;         // y value (from LUT) with interpolation
+  int32_t  ydelta;    // change in y value between 2 adjacent points in LUT
+  int32_t  yval;      // y value (from LUT) with interpolation
 
   if (xval < IntToFixedPt(-1) || xval > IntToFixedPt(1))  xval = 0;
 
@@ -1063,8 +2291,8 @@ fixed_t  Base2Exp(fixed_t xval)
     yval = 2 << 14;  // maximum value in 18:14 bit format
   else
   {
-    yval = (long) g_base2exp[idx];
-    ydelta = (((long) g_base2exp[idx+1] - yval) * irem3) / 8;
+    yval = (int32_t) g_base2exp.v[idx];
+    ydelta = (((int32_t) g_base2exp.v[idx+1] - yval) * irem3) / 8;
     yval = yval + ydelta;
   }
 
@@ -1072,362 +2300,4 @@ fixed_t  Base2Exp(fixed_t xval)
 }
 
 
-// Lookup table to transform linear variable to base-2 exponential.
-// Index value range 0..1024 (integer) represents linear axis range -1.0 ~ +1.0.
-// Lookup value range is 0.5 to 2.0 (fixed point).  Centre (zero) value is 1.00.
-//
-// <!>  g_base2exp[] values are in 18:14 bit fixed-point format.
-//      Shift left 6 bit places to convert to 12:20 fixed-point.
-//      ````````````````````````````````````````````````````````
-// For higher precision, where required, use the function: Base2Exp()
-//
-const  uint16_t  g_base2exp[] =
-{
-    0x2000, 0x200B, 0x2016, 0x2021, 0x202C, 0x2037, 0x2042, 0x204E,
-    0x2059, 0x2064, 0x206F, 0x207A, 0x2086, 0x2091, 0x209C, 0x20A8,
-    0x20B3, 0x20BE, 0x20CA, 0x20D5, 0x20E0, 0x20EC, 0x20F7, 0x2103,
-    0x210E, 0x211A, 0x2125, 0x2130, 0x213C, 0x2148, 0x2153, 0x215F,
-    0x216A, 0x2176, 0x2181, 0x218D, 0x2199, 0x21A4, 0x21B0, 0x21BC,
-    0x21C7, 0x21D3, 0x21DF, 0x21EB, 0x21F6, 0x2202, 0x220E, 0x221A,
-    0x2226, 0x2231, 0x223D, 0x2249, 0x2255, 0x2261, 0x226D, 0x2279,
-    0x2285, 0x2291, 0x229D, 0x22A9, 0x22B5, 0x22C1, 0x22CD, 0x22D9,
-    0x22E5, 0x22F1, 0x22FD, 0x2309, 0x2315, 0x2322, 0x232E, 0x233A,
-    0x2346, 0x2352, 0x235F, 0x236B, 0x2377, 0x2384, 0x2390, 0x239C,
-    0x23A9, 0x23B5, 0x23C1, 0x23CE, 0x23DA, 0x23E7, 0x23F3, 0x23FF,
-    0x240C, 0x2418, 0x2425, 0x2432, 0x243E, 0x244B, 0x2457, 0x2464,
-    0x2470, 0x247D, 0x248A, 0x2496, 0x24A3, 0x24B0, 0x24BD, 0x24C9,
-    0x24D6, 0x24E3, 0x24F0, 0x24FC, 0x2509, 0x2516, 0x2523, 0x2530,
-    0x253D, 0x254A, 0x2557, 0x2564, 0x2570, 0x257D, 0x258A, 0x2598,
-    0x25A5, 0x25B2, 0x25BF, 0x25CC, 0x25D9, 0x25E6, 0x25F3, 0x2600,
-    0x260D, 0x261B, 0x2628, 0x2635, 0x2642, 0x2650, 0x265D, 0x266A,
-    0x2678, 0x2685, 0x2692, 0x26A0, 0x26AD, 0x26BA, 0x26C8, 0x26D5,
-    0x26E3, 0x26F0, 0x26FE, 0x270B, 0x2719, 0x2726, 0x2734, 0x2742,
-    0x274F, 0x275D, 0x276A, 0x2778, 0x2786, 0x2794, 0x27A1, 0x27AF,
-    0x27BD, 0x27CB, 0x27D8, 0x27E6, 0x27F4, 0x2802, 0x2810, 0x281E,
-    0x282C, 0x283A, 0x2847, 0x2855, 0x2863, 0x2871, 0x287F, 0x288E,
-    0x289C, 0x28AA, 0x28B8, 0x28C6, 0x28D4, 0x28E2, 0x28F0, 0x28FF,
-    0x290D, 0x291B, 0x2929, 0x2938, 0x2946, 0x2954, 0x2962, 0x2971,
-    0x297F, 0x298E, 0x299C, 0x29AA, 0x29B9, 0x29C7, 0x29D6, 0x29E4,
-    0x29F3, 0x2A01, 0x2A10, 0x2A1F, 0x2A2D, 0x2A3C, 0x2A4A, 0x2A59,
-    0x2A68, 0x2A77, 0x2A85, 0x2A94, 0x2AA3, 0x2AB2, 0x2AC0, 0x2ACF,
-    0x2ADE, 0x2AED, 0x2AFC, 0x2B0B, 0x2B1A, 0x2B29, 0x2B38, 0x2B47,
-    0x2B56, 0x2B65, 0x2B74, 0x2B83, 0x2B92, 0x2BA1, 0x2BB0, 0x2BBF,
-    0x2BCE, 0x2BDE, 0x2BED, 0x2BFC, 0x2C0B, 0x2C1B, 0x2C2A, 0x2C39,
-    0x2C48, 0x2C58, 0x2C67, 0x2C77, 0x2C86, 0x2C95, 0x2CA5, 0x2CB4,
-    0x2CC4, 0x2CD3, 0x2CE3, 0x2CF3, 0x2D02, 0x2D12, 0x2D21, 0x2D31,
-    0x2D41, 0x2D50, 0x2D60, 0x2D70, 0x2D80, 0x2D8F, 0x2D9F, 0x2DAF,
-    0x2DBF, 0x2DCF, 0x2DDF, 0x2DEF, 0x2DFE, 0x2E0E, 0x2E1E, 0x2E2E,
-    0x2E3E, 0x2E4E, 0x2E5F, 0x2E6F, 0x2E7F, 0x2E8F, 0x2E9F, 0x2EAF,
-    0x2EBF, 0x2ED0, 0x2EE0, 0x2EF0, 0x2F00, 0x2F11, 0x2F21, 0x2F31,
-    0x2F42, 0x2F52, 0x2F62, 0x2F73, 0x2F83, 0x2F94, 0x2FA4, 0x2FB5,
-    0x2FC5, 0x2FD6, 0x2FE7, 0x2FF7, 0x3008, 0x3018, 0x3029, 0x303A,
-    0x304B, 0x305B, 0x306C, 0x307D, 0x308E, 0x309F, 0x30AF, 0x30C0,
-    0x30D1, 0x30E2, 0x30F3, 0x3104, 0x3115, 0x3126, 0x3137, 0x3148,
-    0x3159, 0x316A, 0x317C, 0x318D, 0x319E, 0x31AF, 0x31C0, 0x31D2,
-    0x31E3, 0x31F4, 0x3205, 0x3217, 0x3228, 0x323A, 0x324B, 0x325C,
-    0x326E, 0x327F, 0x3291, 0x32A2, 0x32B4, 0x32C6, 0x32D7, 0x32E9,
-    0x32FB, 0x330C, 0x331E, 0x3330, 0x3341, 0x3353, 0x3365, 0x3377,
-    0x3389, 0x339B, 0x33AC, 0x33BE, 0x33D0, 0x33E2, 0x33F4, 0x3406,
-    0x3418, 0x342A, 0x343C, 0x344F, 0x3461, 0x3473, 0x3485, 0x3497,
-    0x34AA, 0x34BC, 0x34CE, 0x34E0, 0x34F3, 0x3505, 0x3517, 0x352A,
-    0x353C, 0x354F, 0x3561, 0x3574, 0x3586, 0x3599, 0x35AB, 0x35BE,
-    0x35D1, 0x35E3, 0x35F6, 0x3609, 0x361C, 0x362E, 0x3641, 0x3654,
-    0x3667, 0x367A, 0x368D, 0x369F, 0x36B2, 0x36C5, 0x36D8, 0x36EB,
-    0x36FE, 0x3712, 0x3725, 0x3738, 0x374B, 0x375E, 0x3771, 0x3784,
-    0x3798, 0x37AB, 0x37BE, 0x37D2, 0x37E5, 0x37F8, 0x380C, 0x381F,
-    0x3833, 0x3846, 0x385A, 0x386D, 0x3881, 0x3894, 0x38A8, 0x38BC,
-    0x38CF, 0x38E3, 0x38F7, 0x390B, 0x391E, 0x3932, 0x3946, 0x395A,
-    0x396E, 0x3982, 0x3996, 0x39AA, 0x39BE, 0x39D2, 0x39E6, 0x39FA,
-    0x3A0E, 0x3A22, 0x3A36, 0x3A4A, 0x3A5F, 0x3A73, 0x3A87, 0x3A9B,
-    0x3AB0, 0x3AC4, 0x3AD8, 0x3AED, 0x3B01, 0x3B16, 0x3B2A, 0x3B3F,
-    0x3B53, 0x3B68, 0x3B7C, 0x3B91, 0x3BA6, 0x3BBA, 0x3BCF, 0x3BE4,
-    0x3BF9, 0x3C0D, 0x3C22, 0x3C37, 0x3C4C, 0x3C61, 0x3C76, 0x3C8B,
-    0x3CA0, 0x3CB5, 0x3CCA, 0x3CDF, 0x3CF4, 0x3D09, 0x3D1E, 0x3D34,
-    0x3D49, 0x3D5E, 0x3D73, 0x3D89, 0x3D9E, 0x3DB3, 0x3DC9, 0x3DDE,
-    0x3DF4, 0x3E09, 0x3E1F, 0x3E34, 0x3E4A, 0x3E5F, 0x3E75, 0x3E8B,
-    0x3EA0, 0x3EB6, 0x3ECC, 0x3EE2, 0x3EF7, 0x3F0D, 0x3F23, 0x3F39,
-    0x3F4F, 0x3F65, 0x3F7B, 0x3F91, 0x3FA7, 0x3FBD, 0x3FD3, 0x3FE9,
-    0x4000, 0x4016, 0x402C, 0x4042, 0x4058, 0x406F, 0x4085, 0x409C,
-    0x40B2, 0x40C8, 0x40DF, 0x40F5, 0x410C, 0x4122, 0x4139, 0x4150,
-    0x4166, 0x417D, 0x4194, 0x41AA, 0x41C1, 0x41D8, 0x41EF, 0x4206,
-    0x421D, 0x4234, 0x424A, 0x4261, 0x4278, 0x4290, 0x42A7, 0x42BE,
-    0x42D5, 0x42EC, 0x4303, 0x431B, 0x4332, 0x4349, 0x4360, 0x4378,
-    0x438F, 0x43A7, 0x43BE, 0x43D6, 0x43ED, 0x4405, 0x441C, 0x4434,
-    0x444C, 0x4463, 0x447B, 0x4493, 0x44AA, 0x44C2, 0x44DA, 0x44F2,
-    0x450A, 0x4522, 0x453A, 0x4552, 0x456A, 0x4582, 0x459A, 0x45B2,
-    0x45CA, 0x45E3, 0x45FB, 0x4613, 0x462B, 0x4644, 0x465C, 0x4675,
-    0x468D, 0x46A5, 0x46BE, 0x46D6, 0x46EF, 0x4708, 0x4720, 0x4739,
-    0x4752, 0x476A, 0x4783, 0x479C, 0x47B5, 0x47CE, 0x47E7, 0x47FF,
-    0x4818, 0x4831, 0x484A, 0x4864, 0x487D, 0x4896, 0x48AF, 0x48C8,
-    0x48E1, 0x48FB, 0x4914, 0x492D, 0x4947, 0x4960, 0x497A, 0x4993,
-    0x49AD, 0x49C6, 0x49E0, 0x49F9, 0x4A13, 0x4A2D, 0x4A46, 0x4A60,
-    0x4A7A, 0x4A94, 0x4AAE, 0x4AC8, 0x4AE1, 0x4AFB, 0x4B15, 0x4B30,
-    0x4B4A, 0x4B64, 0x4B7E, 0x4B98, 0x4BB2, 0x4BCC, 0x4BE7, 0x4C01,
-    0x4C1B, 0x4C36, 0x4C50, 0x4C6B, 0x4C85, 0x4CA0, 0x4CBA, 0x4CD5,
-    0x4CF0, 0x4D0A, 0x4D25, 0x4D40, 0x4D5B, 0x4D75, 0x4D90, 0x4DAB,
-    0x4DC6, 0x4DE1, 0x4DFC, 0x4E17, 0x4E32, 0x4E4D, 0x4E69, 0x4E84,
-    0x4E9F, 0x4EBA, 0x4ED5, 0x4EF1, 0x4F0C, 0x4F28, 0x4F43, 0x4F5F,
-    0x4F7A, 0x4F96, 0x4FB1, 0x4FCD, 0x4FE9, 0x5004, 0x5020, 0x503C,
-    0x5058, 0x5074, 0x508F, 0x50AB, 0x50C7, 0x50E3, 0x50FF, 0x511C,
-    0x5138, 0x5154, 0x5170, 0x518C, 0x51A9, 0x51C5, 0x51E1, 0x51FE,
-    0x521A, 0x5237, 0x5253, 0x5270, 0x528C, 0x52A9, 0x52C5, 0x52E2,
-    0x52FF, 0x531C, 0x5339, 0x5355, 0x5372, 0x538F, 0x53AC, 0x53C9,
-    0x53E6, 0x5403, 0x5421, 0x543E, 0x545B, 0x5478, 0x5495, 0x54B3,
-    0x54D0, 0x54EE, 0x550B, 0x5529, 0x5546, 0x5564, 0x5581, 0x559F,
-    0x55BD, 0x55DA, 0x55F8, 0x5616, 0x5634, 0x5652, 0x5670, 0x568E,
-    0x56AC, 0x56CA, 0x56E8, 0x5706, 0x5724, 0x5742, 0x5761, 0x577F,
-    0x579D, 0x57BC, 0x57DA, 0x57F9, 0x5817, 0x5836, 0x5854, 0x5873,
-    0x5891, 0x58B0, 0x58CF, 0x58EE, 0x590D, 0x592B, 0x594A, 0x5969,
-    0x5988, 0x59A7, 0x59C7, 0x59E6, 0x5A05, 0x5A24, 0x5A43, 0x5A63,
-    0x5A82, 0x5AA1, 0x5AC1, 0x5AE0, 0x5B00, 0x5B1F, 0x5B3F, 0x5B5F,
-    0x5B7E, 0x5B9E, 0x5BBE, 0x5BDE, 0x5BFD, 0x5C1D, 0x5C3D, 0x5C5D,
-    0x5C7D, 0x5C9D, 0x5CBE, 0x5CDE, 0x5CFE, 0x5D1E, 0x5D3E, 0x5D5F,
-    0x5D7F, 0x5DA0, 0x5DC0, 0x5DE1, 0x5E01, 0x5E22, 0x5E42, 0x5E63,
-    0x5E84, 0x5EA5, 0x5EC5, 0x5EE6, 0x5F07, 0x5F28, 0x5F49, 0x5F6A,
-    0x5F8B, 0x5FAC, 0x5FCE, 0x5FEF, 0x6010, 0x6031, 0x6053, 0x6074,
-    0x6096, 0x60B7, 0x60D9, 0x60FA, 0x611C, 0x613E, 0x615F, 0x6181,
-    0x61A3, 0x61C5, 0x61E7, 0x6209, 0x622B, 0x624D, 0x626F, 0x6291,
-    0x62B3, 0x62D5, 0x62F8, 0x631A, 0x633C, 0x635F, 0x6381, 0x63A4,
-    0x63C6, 0x63E9, 0x640B, 0x642E, 0x6451, 0x6474, 0x6497, 0x64B9,
-    0x64DC, 0x64FF, 0x6522, 0x6545, 0x6569, 0x658C, 0x65AF, 0x65D2,
-    0x65F6, 0x6619, 0x663C, 0x6660, 0x6683, 0x66A7, 0x66CA, 0x66EE,
-    0x6712, 0x6736, 0x6759, 0x677D, 0x67A1, 0x67C5, 0x67E9, 0x680D,
-    0x6831, 0x6855, 0x6879, 0x689E, 0x68C2, 0x68E6, 0x690B, 0x692F,
-    0x6954, 0x6978, 0x699D, 0x69C1, 0x69E6, 0x6A0B, 0x6A2F, 0x6A54,
-    0x6A79, 0x6A9E, 0x6AC3, 0x6AE8, 0x6B0D, 0x6B32, 0x6B57, 0x6B7D,
-    0x6BA2, 0x6BC7, 0x6BED, 0x6C12, 0x6C38, 0x6C5D, 0x6C83, 0x6CA8,
-    0x6CCE, 0x6CF4, 0x6D1A, 0x6D3F, 0x6D65, 0x6D8B, 0x6DB1, 0x6DD7,
-    0x6DFD, 0x6E24, 0x6E4A, 0x6E70, 0x6E96, 0x6EBD, 0x6EE3, 0x6F09,
-    0x6F30, 0x6F57, 0x6F7D, 0x6FA4, 0x6FCB, 0x6FF1, 0x7018, 0x703F,
-    0x7066, 0x708D, 0x70B4, 0x70DB, 0x7102, 0x7129, 0x7151, 0x7178,
-    0x719F, 0x71C7, 0x71EE, 0x7216, 0x723D, 0x7265, 0x728D, 0x72B4,
-    0x72DC, 0x7304, 0x732C, 0x7354, 0x737C, 0x73A4, 0x73CC, 0x73F4,
-    0x741C, 0x7444, 0x746D, 0x7495, 0x74BE, 0x74E6, 0x750F, 0x7537,
-    0x7560, 0x7589, 0x75B1, 0x75DA, 0x7603, 0x762C, 0x7655, 0x767E,
-    0x76A7, 0x76D0, 0x76F9, 0x7723, 0x774C, 0x7775, 0x779F, 0x77C8,
-    0x77F2, 0x781B, 0x7845, 0x786F, 0x7899, 0x78C2, 0x78EC, 0x7916,
-    0x7940, 0x796A, 0x7994, 0x79BF, 0x79E9, 0x7A13, 0x7A3D, 0x7A68,
-    0x7A92, 0x7ABD, 0x7AE7, 0x7B12, 0x7B3D, 0x7B67, 0x7B92, 0x7BBD,
-    0x7BE8, 0x7C13, 0x7C3E, 0x7C69, 0x7C94, 0x7CBF, 0x7CEB, 0x7D16,
-    0x7D41, 0x7D6D, 0x7D98, 0x7DC4, 0x7DEF, 0x7E1B, 0x7E47, 0x7E73,
-    0x7E9F, 0x7ECA, 0x7EF6, 0x7F22, 0x7F4F, 0x7F7B, 0x7FA7, 0x7FD3,
-    0x8000
-};
-
-
-/*```````````````````````````````````````````````````````````````````````````````````````
- * Wave-table definition ...
- * Table name: g_sine_wave
- * Size: 2048 samples
- * Peak value:  +/-32000
- */
-const  short  g_sine_wave[] =
-{
-         0,     97,    196,    293,    392,    490,    588,    686,    785,    882,
-       981,   1079,   1177,   1275,   1373,   1471,   1569,   1667,   1765,   1863,
-      1961,   2059,   2157,   2255,   2353,   2451,   2548,   2647,   2745,   2842,
-      2940,   3038,   3135,   3233,   3331,   3428,   3526,   3624,   3721,   3819,
-      3916,   4013,   4111,   4208,   4305,   4403,   4500,   4597,   4694,   4791,
-      4888,   4986,   5083,   5179,   5276,   5373,   5469,   5566,   5663,   5759,
-      5856,   5953,   6049,   6145,   6242,   6338,   6434,   6531,   6626,   6722,
-      6818,   6915,   7010,   7106,   7202,   7297,   7393,   7488,   7583,   7679,
-      7774,   7870,   7964,   8059,   8155,   8250,   8344,   8439,   8534,   8628,
-      8722,   8817,   8912,   9005,   9100,   9194,   9288,   9381,   9475,   9569,
-      9663,   9756,   9850,   9943,  10037,  10129,  10223,  10316,  10409,  10501,
-     10594,  10687,  10779,  10872,  10963,  11056,  11148,  11240,  11332,  11423,
-     11515,  11607,  11699,  11790,  11880,  11972,  12063,  12154,  12245,  12335,
-     12425,  12516,  12606,  12697,  12787,  12876,  12966,  13056,  13146,  13235,
-     13325,  13414,  13502,  13591,  13680,  13769,  13858,  13946,  14035,  14123,
-     14210,  14298,  14386,  14474,  14561,  14649,  14736,  14823,  14910,  14997,
-     15083,  15169,  15256,  15342,  15428,  15514,  15600,  15686,  15771,  15857,
-     15942,  16027,  16112,  16197,  16281,  16366,  16450,  16534,  16618,  16702,
-     16786,  16869,  16953,  17036,  17119,  17202,  17284,  17367,  17449,  17531,
-     17613,  17695,  17777,  17858,  17940,  18021,  18102,  18183,  18263,  18344,
-     18424,  18504,  18584,  18665,  18744,  18824,  18903,  18982,  19061,  19139,
-     19218,  19296,  19375,  19453,  19531,  19608,  19686,  19763,  19840,  19917,
-     19994,  20071,  20147,  20223,  20299,  20375,  20451,  20526,  20601,  20676,
-     20750,  20826,  20900,  20974,  21048,  21122,  21196,  21269,  21342,  21416,
-     21488,  21561,  21633,  21706,  21778,  21849,  21921,  21993,  22064,  22134,
-     22206,  22276,  22346,  22416,  22487,  22556,  22625,  22695,  22764,  22833,
-     22902,  22970,  23039,  23106,  23174,  23242,  23309,  23376,  23443,  23510,
-     23577,  23643,  23708,  23775,  23840,  23906,  23970,  24036,  24100,  24165,
-     24229,  24293,  24357,  24420,  24484,  24546,  24610,  24672,  24735,  24796,
-     24859,  24920,  24982,  25043,  25104,  25165,  25225,  25286,  25345,  25406,
-     25465,  25524,  25583,  25642,  25701,  25759,  25817,  25875,  25933,  25991,
-     26047,  26104,  26161,  26217,  26274,  26330,  26385,  26441,  26496,  26550,
-     26605,  26660,  26713,  26768,  26822,  26875,  26928,  26981,  27034,  27085,
-     27138,  27190,  27242,  27292,  27344,  27395,  27446,  27496,  27546,  27596,
-     27645,  27695,  27744,  27792,  27841,  27889,  27937,  27985,  28033,  28080,
-     28126,  28173,  28219,  28266,  28312,  28357,  28403,  28448,  28493,  28537,
-     28582,  28625,  28669,  28712,  28755,  28798,  28841,  28883,  28926,  28967,
-     29009,  29050,  29091,  29132,  29172,  29213,  29252,  29292,  29332,  29371,
-     29410,  29449,  29487,  29525,  29562,  29600,  29637,  29673,  29710,  29747,
-     29783,  29819,  29854,  29889,  29924,  29958,  29993,  30027,  30061,  30094,
-     30127,  30161,  30193,  30225,  30257,  30290,  30321,  30352,  30383,  30414,
-     30444,  30474,  30503,  30534,  30563,  30591,  30621,  30649,  30676,  30705,
-     30732,  30759,  30786,  30813,  30839,  30865,  30891,  30916,  30941,  30966,
-     30991,  31015,  31040,  31063,  31086,  31109,  31132,  31155,  31177,  31199,
-     31220,  31242,  31263,  31284,  31304,  31325,  31344,  31364,  31383,  31402,
-     31421,  31439,  31458,  31475,  31493,  31510,  31527,  31543,  31560,  31576,
-     31591,  31607,  31623,  31637,  31652,  31666,  31680,  31694,  31707,  31720,
-     31733,  31746,  31757,  31769,  31781,  31792,  31803,  31814,  31824,  31834,
-     31844,  31853,  31863,  31872,  31880,  31888,  31896,  31904,  31912,  31918,
-     31925,  31932,  31938,  31944,  31950,  31955,  31959,  31964,  31968,  31972,
-     31976,  31980,  31983,  31986,  31989,  31991,  31993,  31995,  31996,  31997,
-     31998,  31998,  31999,  31998,  31998,  31997,  31996,  31995,  31993,  31991,
-     31989,  31986,  31983,  31980,  31976,  31972,  31968,  31964,  31959,  31955,
-     31950,  31944,  31938,  31932,  31925,  31918,  31912,  31904,  31896,  31888,
-     31880,  31872,  31863,  31853,  31844,  31834,  31824,  31814,  31803,  31792,
-     31781,  31769,  31757,  31746,  31733,  31720,  31707,  31694,  31680,  31666,
-     31652,  31637,  31623,  31607,  31591,  31576,  31560,  31543,  31527,  31510,
-     31493,  31475,  31458,  31439,  31421,  31402,  31383,  31364,  31344,  31325,
-     31304,  31284,  31263,  31242,  31220,  31199,  31177,  31155,  31132,  31109,
-     31086,  31063,  31040,  31015,  30991,  30966,  30941,  30916,  30891,  30865,
-     30839,  30813,  30786,  30759,  30732,  30705,  30676,  30649,  30621,  30591,
-     30563,  30534,  30503,  30474,  30444,  30414,  30383,  30352,  30321,  30290,
-     30257,  30225,  30193,  30161,  30127,  30094,  30061,  30027,  29993,  29958,
-     29924,  29889,  29854,  29819,  29783,  29747,  29710,  29673,  29637,  29600,
-     29562,  29525,  29487,  29449,  29410,  29371,  29332,  29292,  29252,  29213,
-     29172,  29132,  29091,  29050,  29009,  28967,  28926,  28883,  28841,  28798,
-     28755,  28712,  28669,  28625,  28582,  28537,  28493,  28448,  28403,  28357,
-     28312,  28266,  28219,  28173,  28126,  28080,  28033,  27985,  27937,  27889,
-     27841,  27792,  27744,  27695,  27645,  27596,  27546,  27496,  27446,  27395,
-     27344,  27292,  27242,  27190,  27138,  27085,  27034,  26981,  26928,  26875,
-     26822,  26768,  26713,  26660,  26605,  26550,  26496,  26441,  26385,  26330,
-     26274,  26217,  26161,  26104,  26047,  25991,  25933,  25875,  25817,  25759,
-     25701,  25642,  25583,  25524,  25465,  25406,  25345,  25286,  25225,  25165,
-     25104,  25043,  24982,  24920,  24859,  24796,  24735,  24672,  24610,  24546,
-     24484,  24420,  24357,  24293,  24229,  24165,  24100,  24036,  23970,  23906,
-     23840,  23775,  23708,  23643,  23577,  23510,  23443,  23376,  23309,  23242,
-     23174,  23106,  23039,  22970,  22902,  22833,  22764,  22695,  22625,  22556,
-     22487,  22416,  22346,  22276,  22206,  22134,  22064,  21993,  21921,  21849,
-     21778,  21706,  21633,  21561,  21488,  21416,  21342,  21269,  21196,  21122,
-     21048,  20974,  20900,  20826,  20750,  20676,  20601,  20526,  20451,  20375,
-     20299,  20223,  20147,  20071,  19994,  19917,  19840,  19763,  19686,  19608,
-     19531,  19453,  19375,  19296,  19218,  19139,  19061,  18982,  18903,  18824,
-     18744,  18665,  18584,  18504,  18424,  18344,  18263,  18183,  18102,  18021,
-     17940,  17858,  17777,  17695,  17613,  17531,  17449,  17367,  17284,  17202,
-     17119,  17036,  16953,  16869,  16786,  16702,  16618,  16534,  16450,  16366,
-     16281,  16197,  16112,  16027,  15942,  15857,  15771,  15686,  15600,  15514,
-     15428,  15342,  15256,  15169,  15083,  14997,  14910,  14823,  14736,  14649,
-     14561,  14474,  14386,  14298,  14210,  14123,  14035,  13946,  13858,  13769,
-     13680,  13591,  13502,  13414,  13325,  13235,  13146,  13056,  12966,  12876,
-     12787,  12697,  12606,  12516,  12425,  12335,  12245,  12154,  12063,  11972,
-     11880,  11790,  11699,  11607,  11515,  11423,  11332,  11240,  11148,  11056,
-     10963,  10872,  10779,  10687,  10594,  10501,  10409,  10316,  10223,  10129,
-     10037,   9943,   9850,   9756,   9663,   9569,   9475,   9381,   9288,   9194,
-      9100,   9005,   8912,   8817,   8722,   8628,   8534,   8439,   8344,   8250,
-      8155,   8059,   7964,   7870,   7774,   7679,   7583,   7488,   7393,   7297,
-      7202,   7106,   7010,   6915,   6818,   6722,   6626,   6531,   6434,   6338,
-      6242,   6145,   6049,   5953,   5856,   5759,   5663,   5566,   5469,   5373,
-      5276,   5179,   5083,   4986,   4888,   4791,   4694,   4597,   4500,   4403,
-      4305,   4208,   4111,   4013,   3916,   3819,   3721,   3624,   3526,   3428,
-      3331,   3233,   3135,   3038,   2940,   2842,   2745,   2647,   2548,   2451,
-      2353,   2255,   2157,   2059,   1961,   1863,   1765,   1667,   1569,   1471,
-      1373,   1275,   1177,   1079,    981,    882,    785,    686,    588,    490,
-       392,    293,    196,     97,      0,    -97,   -196,   -293,   -392,   -490,
-      -588,   -686,   -785,   -882,   -981,  -1079,  -1177,  -1275,  -1373,  -1471,
-     -1569,  -1667,  -1765,  -1863,  -1961,  -2059,  -2157,  -2255,  -2353,  -2451,
-     -2548,  -2647,  -2745,  -2842,  -2940,  -3038,  -3135,  -3233,  -3331,  -3428,
-     -3526,  -3624,  -3721,  -3819,  -3916,  -4013,  -4111,  -4208,  -4305,  -4403,
-     -4500,  -4597,  -4694,  -4791,  -4888,  -4986,  -5083,  -5179,  -5276,  -5373,
-     -5469,  -5566,  -5663,  -5759,  -5856,  -5953,  -6049,  -6145,  -6242,  -6338,
-     -6434,  -6531,  -6626,  -6722,  -6818,  -6915,  -7010,  -7106,  -7202,  -7297,
-     -7393,  -7488,  -7583,  -7679,  -7774,  -7870,  -7964,  -8059,  -8155,  -8250,
-     -8344,  -8439,  -8534,  -8628,  -8722,  -8817,  -8912,  -9005,  -9100,  -9194,
-     -9288,  -9381,  -9475,  -9569,  -9663,  -9756,  -9850,  -9943, -10037, -10129,
-    -10223, -10316, -10409, -10501, -10594, -10687, -10779, -10872, -10963, -11056,
-    -11148, -11240, -11332, -11423, -11515, -11607, -11699, -11790, -11880, -11972,
-    -12063, -12154, -12245, -12335, -12425, -12516, -12606, -12697, -12787, -12876,
-    -12966, -13056, -13146, -13235, -13325, -13414, -13502, -13591, -13680, -13769,
-    -13858, -13946, -14035, -14123, -14210, -14298, -14386, -14474, -14561, -14649,
-    -14736, -14823, -14910, -14997, -15083, -15169, -15256, -15342, -15428, -15514,
-    -15600, -15686, -15771, -15857, -15942, -16027, -16112, -16197, -16281, -16366,
-    -16450, -16534, -16618, -16702, -16786, -16869, -16953, -17036, -17119, -17202,
-    -17284, -17367, -17449, -17531, -17613, -17695, -17777, -17858, -17940, -18021,
-    -18102, -18183, -18263, -18344, -18424, -18504, -18584, -18665, -18744, -18824,
-    -18903, -18982, -19061, -19139, -19218, -19296, -19375, -19453, -19531, -19608,
-    -19686, -19763, -19840, -19917, -19994, -20071, -20147, -20223, -20299, -20375,
-    -20451, -20526, -20601, -20676, -20750, -20826, -20900, -20974, -21048, -21122,
-    -21196, -21269, -21342, -21416, -21488, -21561, -21633, -21706, -21778, -21849,
-    -21921, -21993, -22064, -22134, -22206, -22276, -22346, -22416, -22487, -22556,
-    -22625, -22695, -22764, -22833, -22902, -22970, -23039, -23106, -23174, -23242,
-    -23309, -23376, -23443, -23510, -23577, -23643, -23708, -23775, -23840, -23906,
-    -23970, -24036, -24100, -24165, -24229, -24293, -24357, -24420, -24484, -24546,
-    -24610, -24672, -24735, -24796, -24859, -24920, -24982, -25043, -25104, -25165,
-    -25225, -25286, -25345, -25406, -25465, -25524, -25583, -25642, -25701, -25759,
-    -25817, -25875, -25933, -25991, -26047, -26104, -26161, -26217, -26274, -26330,
-    -26385, -26441, -26496, -26550, -26605, -26660, -26713, -26768, -26822, -26875,
-    -26928, -26981, -27034, -27085, -27138, -27190, -27242, -27292, -27344, -27395,
-    -27446, -27496, -27546, -27596, -27645, -27695, -27744, -27792, -27841, -27889,
-    -27937, -27985, -28033, -28080, -28126, -28173, -28219, -28266, -28312, -28357,
-    -28403, -28448, -28493, -28537, -28582, -28625, -28669, -28712, -28755, -28798,
-    -28841, -28883, -28926, -28967, -29009, -29050, -29091, -29132, -29172, -29213,
-    -29252, -29292, -29332, -29371, -29410, -29449, -29487, -29525, -29562, -29600,
-    -29637, -29673, -29710, -29747, -29783, -29819, -29854, -29889, -29924, -29958,
-    -29993, -30027, -30061, -30094, -30127, -30161, -30193, -30225, -30257, -30290,
-    -30321, -30352, -30383, -30414, -30444, -30474, -30503, -30534, -30563, -30591,
-    -30621, -30649, -30676, -30705, -30732, -30759, -30786, -30813, -30839, -30865,
-    -30891, -30916, -30941, -30966, -30991, -31015, -31040, -31063, -31086, -31109,
-    -31132, -31155, -31177, -31199, -31220, -31242, -31263, -31284, -31304, -31325,
-    -31344, -31364, -31383, -31402, -31421, -31439, -31458, -31475, -31493, -31510,
-    -31527, -31543, -31560, -31576, -31591, -31607, -31623, -31637, -31652, -31666,
-    -31680, -31694, -31707, -31720, -31733, -31746, -31757, -31769, -31781, -31792,
-    -31803, -31814, -31824, -31834, -31844, -31853, -31863, -31872, -31880, -31888,
-    -31896, -31904, -31912, -31918, -31925, -31932, -31938, -31944, -31950, -31955,
-    -31959, -31964, -31968, -31972, -31976, -31980, -31983, -31986, -31989, -31991,
-    -31993, -31995, -31996, -31997, -31998, -31998, -31999, -31998, -31998, -31997,
-    -31996, -31995, -31993, -31991, -31989, -31986, -31983, -31980, -31976, -31972,
-    -31968, -31964, -31959, -31955, -31950, -31944, -31938, -31932, -31925, -31918,
-    -31912, -31904, -31896, -31888, -31880, -31872, -31863, -31853, -31844, -31834,
-    -31824, -31814, -31803, -31792, -31781, -31769, -31757, -31746, -31733, -31720,
-    -31707, -31694, -31680, -31666, -31652, -31637, -31623, -31607, -31591, -31576,
-    -31560, -31543, -31527, -31510, -31493, -31475, -31458, -31439, -31421, -31402,
-    -31383, -31364, -31344, -31325, -31304, -31284, -31263, -31242, -31220, -31199,
-    -31177, -31155, -31132, -31109, -31086, -31063, -31040, -31015, -30991, -30966,
-    -30941, -30916, -30891, -30865, -30839, -30813, -30786, -30759, -30732, -30705,
-    -30676, -30649, -30621, -30591, -30563, -30534, -30503, -30474, -30444, -30414,
-    -30383, -30352, -30321, -30290, -30257, -30225, -30193, -30161, -30127, -30094,
-    -30061, -30027, -29993, -29958, -29924, -29889, -29854, -29819, -29783, -29747,
-    -29710, -29673, -29637, -29600, -29562, -29525, -29487, -29449, -29410, -29371,
-    -29332, -29292, -29252, -29213, -29172, -29132, -29091, -29050, -29009, -28967,
-    -28926, -28883, -28841, -28798, -28755, -28712, -28669, -28625, -28582, -28537,
-    -28493, -28448, -28403, -28357, -28312, -28266, -28219, -28173, -28126, -28080,
-    -28033, -27985, -27937, -27889, -27841, -27792, -27744, -27695, -27645, -27596,
-    -27546, -27496, -27446, -27395, -27344, -27292, -27242, -27190, -27138, -27085,
-    -27034, -26981, -26928, -26875, -26822, -26768, -26713, -26660, -26605, -26550,
-    -26496, -26441, -26385, -26330, -26274, -26217, -26161, -26104, -26047, -25991,
-    -25933, -25875, -25817, -25759, -25701, -25642, -25583, -25524, -25465, -25406,
-    -25345, -25286, -25225, -25165, -25104, -25043, -24982, -24920, -24859, -24796,
-    -24735, -24672, -24610, -24546, -24484, -24420, -24357, -24293, -24229, -24165,
-    -24100, -24036, -23970, -23906, -23840, -23775, -23708, -23643, -23577, -23510,
-    -23443, -23376, -23309, -23242, -23174, -23106, -23039, -22970, -22902, -22833,
-    -22764, -22695, -22625, -22556, -22487, -22416, -22346, -22276, -22206, -22134,
-    -22064, -21993, -21921, -21849, -21778, -21706, -21633, -21561, -21488, -21416,
-    -21342, -21269, -21196, -21122, -21048, -20974, -20900, -20826, -20750, -20676,
-    -20601, -20526, -20451, -20375, -20299, -20223, -20147, -20071, -19994, -19917,
-    -19840, -19763, -19686, -19608, -19531, -19453, -19375, -19296, -19218, -19139,
-    -19061, -18982, -18903, -18824, -18744, -18665, -18584, -18504, -18424, -18344,
-    -18263, -18183, -18102, -18021, -17940, -17858, -17777, -17695, -17613, -17531,
-    -17449, -17367, -17284, -17202, -17119, -17036, -16953, -16869, -16786, -16702,
-    -16618, -16534, -16450, -16366, -16281, -16197, -16112, -16027, -15942, -15857,
-    -15771, -15686, -15600, -15514, -15428, -15342, -15256, -15169, -15083, -14997,
-    -14910, -14823, -14736, -14649, -14561, -14474, -14386, -14298, -14210, -14123,
-    -14035, -13946, -13858, -13769, -13680, -13591, -13502, -13414, -13325, -13235,
-    -13146, -13056, -12966, -12876, -12787, -12697, -12606, -12516, -12425, -12335,
-    -12245, -12154, -12063, -11972, -11880, -11790, -11699, -11607, -11515, -11423,
-    -11332, -11240, -11148, -11056, -10963, -10872, -10779, -10687, -10594, -10501,
-    -10409, -10316, -10223, -10129, -10037,  -9943,  -9850,  -9756,  -9663,  -9569,
-     -9475,  -9381,  -9288,  -9194,  -9100,  -9005,  -8912,  -8817,  -8722,  -8628,
-     -8534,  -8439,  -8344,  -8250,  -8155,  -8059,  -7964,  -7870,  -7774,  -7679,
-     -7583,  -7488,  -7393,  -7297,  -7202,  -7106,  -7010,  -6915,  -6818,  -6722,
-     -6626,  -6531,  -6434,  -6338,  -6242,  -6145,  -6049,  -5953,  -5856,  -5759,
-     -5663,  -5566,  -5469,  -5373,  -5276,  -5179,  -5083,  -4986,  -4888,  -4791,
-     -4694,  -4597,  -4500,  -4403,  -4305,  -4208,  -4111,  -4013,  -3916,  -3819,
-     -3721,  -3624,  -3526,  -3428,  -3331,  -3233,  -3135,  -3038,  -2940,  -2842,
-     -2745,  -2647,  -2548,  -2451,  -2353,  -2255,  -2157,  -2059,  -1961,  -1863,
-     -1765,  -1667,  -1569,  -1471,  -1373,  -1275,  -1177,  -1079,   -981,   -882,
-      -785,   -686,   -588,   -490,   -392,   -293,   -196,    -97
-};
-
 // end of file
@@ -0,0 +1,177 @@
+/**
+ *   File:    m0_synth_tables.h
+ *
+ *   Compile-time generated look-up tables for the Sigma-6 synth engine:
+ *   ```````````````````````````````````````````````````````````````````
+ *   Sine wave-table (full cycle or quarter cycle), base-2 exponential function,
+ *   note frequencies and oscillator phase steps per note and Osc Freq Multiplier.
+ *
+ *   The tables are computed by the compiler (C++11 constexpr functions), so they are
+ *   stored in flash as constant data, as before;  no code is executed at run-time to
+ *   generate them.  The table resolution is set by the definitions below and by
+ *   WAVE_TABLE_SIZE (in m0_synth_def.h).
+ *
+ *   The Arduino IDE does not generate function prototypes for code in header files,
+ *   hence the templates and constexpr functions are defined here, not in a .ino file.
+ *   This file is to be included by m0_synth_engine.ino only.
+ */
+#ifndef M0_SYNTH_TABLES_H
+#define M0_SYNTH_TABLES_H
+
+#define SINE_TABLE_PEAK           32000    // sine wave-table peak value (max. 32767)
+#define BASE2EXP_TABLE_SIZE        1025    // g_base2exp[] entries (-1.0 ~ +1.0)
+#define NOTE_TABLE_FIRST             12    // MIDI note number of first entry (C0)
+#define NOTE_TABLE_SIZE             109    // notes C0 (12) ~ C9 (120)
+#define OSC_FREQ_MULT_COUNT          12    // number of Osc Freq Multiplier options
+
+// Osc Freq Multiplier values -- see g_FreqMultConst[] and g_NoteStep ...
+#define OSC_FREQ_MULT_VALUES  0.5, 1.0, 1.333333, 1.5, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0
+
+constexpr double  c_OscFreqMult[OSC_FREQ_MULT_COUNT] = { OSC_FREQ_MULT_VALUES };
+
+constexpr double  c_Pi = 3.14159265358979323846;
+constexpr double  c_Ln2 = 0.69314718055994530942;
+
+
+// Table structure -- an array wrapped in a struct, so that it can be returned by value
+// from a constexpr generator function.  Table entries are accessed as:  table.v[index]
+//
+template <typename T, unsigned N>
+struct  ConstTable
+{
+  T  v[N];
+};
+
+
+// Compile-time integer sequence 0, 1, 2, ... N-1  (as std::index_sequence in C++14).
+// MakeIndexSeq splits the range in halves, so template recursion depth is log2(N).
+//
+template <unsigned... I>  struct  IndexSeq  { };
+
+template <class A, class B>  struct  IndexSeqJoin;
+
+template <unsigned... I, unsigned... J>
+struct  IndexSeqJoin< IndexSeq<I...>, IndexSeq<J...> >
+{
+  typedef  IndexSeq< I..., (sizeof...(I) + J)... >  type;
+};
+
+template <unsigned N>
+struct  MakeIndexSeq
+{
+  typedef  typename IndexSeqJoin< typename MakeIndexSeq<N / 2>::type,
+                                  typename MakeIndexSeq<N - N / 2>::type >::type  type;
+};
+
+template <>  struct  MakeIndexSeq<0>  { typedef  IndexSeq<>  type; };
+template <>  struct  MakeIndexSeq<1>  { typedef  IndexSeq<0>  type; };
+
+
+// Compile-time maths functions (C++11 constexpr:  one return statement per function).
+//
+// Sine by Taylor series, for x in range 0 ~ pi/2.  Terms to x^25;  error < 1e-15.
+constexpr double  ConstSinTerm(double x2, double term, int n)
+{
+  return  (n > 25) ? 0.0 : term + ConstSinTerm(x2, -term * x2 / ((n + 1) * (n + 2)), n + 2);
+}
+
+constexpr double  ConstSinQuarter(double x)
+{
+  return  ConstSinTerm(x * x, x, 1);
+}
+
+// Exponential by Taylor series, for x in range -1.0 ~ +1.0.  Terms to x^20.
+constexpr double  ConstExpTerm(double x, double term, int n)
+{
+  return  (n > 20) ? 0.0 : term + ConstExpTerm(x, term * x / (n + 1), n + 1);
+}
+
+// 2 ** x for any x:  2 ** (integer part) x exp(fraction part x ln2)
+constexpr double  ConstExp2(double x)
+{
+  return  (x > 0.5) ? 2.0 * ConstExp2(x - 1.0)
+        : (x < -0.5) ? 0.5 * ConstExp2(x + 1.0)
+        : ConstExpTerm(x * c_Ln2, 1.0, 0);
+}
+
+constexpr int32_t  ConstRound(double x)
+{
+  return  (x >= 0) ? (int32_t)(x + 0.5) : -(int32_t)(0.5 - x);
+}
+
+
+// Sine wave-table sample at index i, for a full-cycle table of size N (multiple of 4).
+// The value is taken from the first quarter cycle by symmetry, so table samples are
+// exactly symmetrical, as required for the quarter-wave table option.
+//
+constexpr int16_t  SineQuarterValue(unsigned i, unsigned N)
+{
+  return  (int16_t) ConstRound(SINE_TABLE_PEAK * ConstSinQuarter(2.0 * c_Pi * i / N));
+}
+
+constexpr int16_t  SineTableValue(unsigned i, unsigned N)
+{
+  return  (i % (N / 2) <= N / 4) ? ((i % N < N / 2) ? 1 : -1) * SineQuarterValue(i % (N / 2), N)
+                                 : ((i % N < N / 2) ? 1 : -1) * SineQuarterValue(N / 2 - i % (N / 2), N);
+}
+
+template <unsigned... I>
+constexpr ConstTable<int16_t, sizeof...(I)>  SineTableGen(IndexSeq<I...>, unsigned N)
+{
+  return  {{ SineTableValue(I, N)... }};
+}
+
+
+// Base-2 exponential table: index 0..1024 represents x = -1.0 ~ +1.0;  value = 2 ** x
+// in 18:14 bit fixed-point format (range 0x2000 ~ 0x8000).
+//
+constexpr uint16_t  Base2ExpValue(unsigned i)
+{
+  return  (uint16_t) ConstRound(16384.0 * ConstExp2(((double) i - 512) / 512));
+}
+
+template <unsigned... I>
+constexpr ConstTable<uint16_t, sizeof...(I)>  Base2ExpTableGen(IndexSeq<I...>)
+{
+  return  {{ Base2ExpValue(I)... }};
+}
+
+
+// Equal-tempered note frequency (Hz), A4 (MIDI note 69) = 440 Hz.
+//
+constexpr double  NoteFrequency(unsigned note)
+{
+  return  440.0 * ConstExp2(((double) note - 69) / 12);
+}
+
+template <unsigned... I>
+constexpr ConstTable<float, sizeof...(I)>  NoteFreqTableGen(IndexSeq<I...>)
+{
+  return  {{ (float) NoteFrequency(NOTE_TABLE_FIRST + I)... }};
+}
+
+
+// Oscillator phase step (2^32 = 1 cycle) at the default sample rate, for table entry i
+// = note index x OSC_FREQ_MULT_COUNT + freq mult.  Steps for frequencies above the
+// sample rate, which are muted anyway, are limited to 0xFFFFFFFF.
+//
+constexpr uint32_t  NoteStepLimit(double step)
+{
+  return  (step >= 4294967295.0) ? 0xFFFFFFFF : (uint32_t)(step + 0.5);
+}
+
+constexpr uint32_t  NoteStepValue(unsigned i)
+{
+  return  NoteStepLimit(NoteFrequency(NOTE_TABLE_FIRST + i / OSC_FREQ_MULT_COUNT)
+                        * c_OscFreqMult[i % OSC_FREQ_MULT_COUNT]
+                        * 4294967296.0 / SAMPLE_RATE_DEFAULT);
+}
+
+template <unsigned... I>
+constexpr ConstTable<uint32_t[OSC_FREQ_MULT_COUNT], NOTE_TABLE_SIZE>  NoteStepTableGen(IndexSeq<I...>)
+{
+  return  {{ NoteStepValue(I)... }};
+}
+
+
+#endif // M0_SYNTH_TABLES_H
@@ -0,0 +1,40 @@
+/*
+ * File:       host_io.h
+ *
+ * Module:     Host (desktop) render harness -- interface between the harness and the
+ *             voice firmware compiled for the host (voice_build.cpp).
+ *
+ * The hardware shim (shim/Arduino.h, SPI.h, etc) routes the firmware "I/O" into the
+ * structure g_HostIO, so that the harness can collect DAC output samples and drive the
+ * firmware clock (millis, micros).
+ */
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <stdint.h>
+
+typedef struct host_io_state
+{
+  uint32_t  micros;         // Simulated time (us) -- returned by millis(), micros()
+  uint16_t  dacWord;        // Last word written to audio DAC (12 LS bits = DAC code)
+  uint32_t  dacWrites;      // Number of DAC writes (samples output)
+  uint32_t  uartTxBytes;    // Number of bytes written to Serial1 (MIDI/Sysex reply)
+
+} HostIO_t;
+
+extern HostIO_t  g_HostIO;
+
+// Firmware entry points called by the harness...
+void   TC3_Handler(void);
+void   SynthProcess();
+void   PresetSelect(uint8_t preset);
+void   SynthPrepare();
+int    GetNumberOfPresets(void);
+
+// Functions defined in voice_build.cpp...
+void   HostVoiceInit(uint8_t midiChannel);
+bool   HostMidiDispatch(uint8_t *midiMessage, short msgLength);
+bool   HostSetSampleRate(uint8_t rate_kHz);
+int    HostSampleRate(void);
+
+#endif // HOST_IO_H
@@ -0,0 +1,692 @@
+/*
+ * File:       host_render.cpp
+ *
+ * Module:     Host (desktop) offline render and benchmark harness for the Sigma-6 voice
+ *             synthesizer engine.
+ *
+ * The voice firmware (compiled for the host in voice_build.cpp) is driven exactly as on
+ * the target MCU:  MIDI messages are passed to ProcessMidiMessage(), SynthProcess() is
+ * called every millisecond and the audio ISR, TC3_Handler(), is called g_SampleRate times
+ * per second.  The audio DAC output is written to a WAV file (16-bit mono PCM).
+ *
+ * Input is a Standard MIDI File (format 0 or 1), or if no file is given, a built-in test
+ * phrase.  Each render is done in a child process, so that every preset starts from the
+ * same (power-on) engine state.  A summary of each render, including a hash of the audio
+ * output and execution times of each stage (MIDI, SynthProcess, audio ISR), is printed
+ * and optionally written to a JSON file.  A JSON file written previously may be used as
+ * a "golden" reference to check that a code change does not alter the audio output.
+ *
+ * Usage:  host_render [options] [file.mid]
+ *
+ *   -p <n>     Preset number (default 13, as per voice setup())
+ *   -a         Render all presets in g_PresetPatch[]
+ *   -c <n>     Voice MIDI channel 1..15, or 0 = Omni On (default 0)
+ *   -o <name>  Output WAV file name (default "render");  ".wav" or "_NN.wav" appended
+ *   -n         No WAV output  (benchmark / regression check only)
+ *   -t <ms>    Time to render after the last MIDI event (default 2000 ms)
+ *   -r <n>     Repeat each render n times;  minimum execution times are reported
+ *   -j <file>  Write JSON summary to file
+ *   -g <file>  Compare audio output hashes with (golden) JSON summary file
+ *   -s <kHz>   Audio sample rate 32, 40 or 48 kHz, set by CC90 (default 32 kHz)
+ *   -x <n>     Patch change test:  a Program Change to preset n is sent mid-note (at
+ *              PATCH_SWAP_MS), so the patch is swapped by SynthPatchLoad() while the synth
+ *              is running;  the output must have no discontinuity (see RenderSequence)
+ *
+ * Exit status:  0 = OK,  1 = error,  2 = audio output differs from golden file, or a
+ *               discontinuity was found at the patch change (-x).
+ *
+ * Licence:    Open Source (Unlicensed) -- free to copy, distribute, modify
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "host_io.h"
+
+#define DEFAULT_PRESET       13
+#define DEFAULT_TAIL_MS    2000
+#define PATCH_SWAP_MS       400    // Time of patch change for option -x (first test note)
+#define SWAP_WINDOW_MS       10    // Patch fade-out + fade-in time, with margin
+
+typedef std::chrono::steady_clock  Clock;
+
+typedef struct midi_event
+{
+  uint32_t  time_us;        // event time from start of sequence (us)
+  uint32_t  order;          // order of arrival, to keep sort stable
+  std::vector<uint8_t>  msg;
+
+} MidiEvent_t;
+
+typedef struct render_result
+{
+  int       preset;
+  uint32_t  samples;        // number of samples rendered
+  int32_t   peak;           // peak absolute sample value (16-bit PCM)
+  double    rms;            // RMS sample value (16-bit PCM)
+  double    dc;             // mean sample value (16-bit PCM)
+  uint32_t  hash;           // FNV-1a hash of DAC output words
+  uint32_t  midiMsgs;       // number of MIDI messages processed
+  uint32_t  synthCalls;     // number of calls to SynthProcess()
+  double    midi_ns;        // total execution time: ProcessMidiMessage()
+  double    synth_ns;       // total execution time: SynthProcess()
+  double    audio_ns;       // total execution time: TC3_Handler()
+  int32_t   swapStep[3];    // max. sample step before, during and after swap window
+
+} RenderResult_t;
+
+typedef struct options
+{
+  int       preset;
+  bool      allPresets;
+  uint8_t   midiChannel;
+  const char  *wavName;
+  bool      noWav;
+  uint32_t  tail_ms;
+  int       repeats;
+  const char  *jsonFile;
+  const char  *goldenFile;
+  const char  *midiFile;
+  uint8_t   sampleRate_kHz;
+  int       swapPreset;     // preset swapped in mid-note (-x), or -1
+
+} Options_t;
+
+static Options_t  m_Opt = { DEFAULT_PRESET, false, 0, "render", false, DEFAULT_TAIL_MS,
+                            1, NULL, NULL, NULL, 0, -1 };
+
+static std::vector<MidiEvent_t>  m_Events;
+
+// Built-in test phrase:  { time (ms), status, data1, data2 } -- exercises attack,
+// release, velocity, legato note change, pitch-bend and modulation.
+static const uint16_t  m_TestPhrase[][4] =
+{
+  {    0, 0x90, 60, 100 },  {  800, 0x80, 60, 0 },
+  { 1000, 0x90, 64,  64 },  { 1300, 0x80, 64, 0 },
+  { 1400, 0x90, 67, 127 },  { 1600, 0x80, 67, 0 },
+  { 1800, 0x90, 72, 100 },
+  { 1900, 0xE0, 0x00, 0x50 },  { 2000, 0xE0, 0x00, 0x60 },  { 2100, 0xE0, 0x7F, 0x7F },
+  { 2200, 0xB0, 1, 64 },  { 2300, 0xB0, 1, 127 },
+  { 2400, 0xE0, 0x00, 0x40 },  { 2500, 0xB0, 1, 0 },
+  { 2600, 0x90, 74, 90 },  { 2700, 0x80, 72, 0 },  { 3200, 0x80, 74, 0 },
+};
+
+
+static uint32_t  GetBigEndian(const uint8_t *p, int nbytes)
+{
+  uint32_t  value = 0;
+
+  while (nbytes--)  { value = (value << 8) | *p++; }
+  return  value;
+}
+
+
+static uint32_t  GetVarLength(const uint8_t *data, size_t size, size_t *pos)
+{
+  uint32_t  value = 0;
+  uint8_t   c;
+
+  do
+  {
+    if (*pos >= size)  break;
+    c = data[(*pos)++];
+    value = (value << 7) | (c & 0x7F);
+  } while (c & 0x80);
+
+  return  value;
+}
+
+
+/*
+ * Function:     Load a Standard MIDI File (format 0 or 1) into m_Events[].
+ *               Events from all tracks are merged and event times are converted to
+ *               microseconds using the tempo map (meta event 0x51, global).
+ *               Meta events and SysEx escape (F7) events are discarded.
+ *
+ * Return val:   true if successful, else false
+ */
+static bool  LoadMidiFile(const char *fileName)
+{
+  typedef struct { uint32_t tick;  uint32_t order;  std::vector<uint8_t> msg; } TickEvent_t;
+  typedef struct { uint32_t tick;  uint32_t tempo; } TempoChange_t;
+
+  std::vector<uint8_t>  data;
+  std::vector<TickEvent_t>  tickEvents;
+  std::vector<TempoChange_t>  tempoMap;
+  FILE     *fp = fopen(fileName, "rb");
+  size_t   pos, trackEnd;
+  uint32_t  division, order = 0;
+  int      ntracks, track, c;
+
+  if (fp == NULL)  { fprintf(stderr, "Cannot open MIDI file: %s\n", fileName);  return false; }
+  while ((c = fgetc(fp)) != EOF)  data.push_back((uint8_t) c);
+  fclose(fp);
+
+  if (data.size() < 14 || memcmp(&data[0], "MThd", 4) != 0)
+  {
+    fprintf(stderr, "Not a Standard MIDI File: %s\n", fileName);
+    return false;
+  }
+  ntracks = GetBigEndian(&data[10], 2);
+  division = GetBigEndian(&data[12], 2);
+  pos = 8 + GetBigEndian(&data[4], 4);
+
+  for (track = 0;  track < ntracks && pos + 8 <= data.size();  track++)
+  {
+    uint32_t  tick = 0;
+    uint8_t   runningStatus = 0;
+
+    trackEnd = pos + 8 + GetBigEndian(&data[pos + 4], 4);
+    if (memcmp(&data[pos], "MTrk", 4) != 0)  { pos = trackEnd;  continue; }  // alien chunk
+    if (trackEnd > data.size())  trackEnd = data.size();
+    pos += 8;
+
+    while (pos < trackEnd)
+    {
+      TickEvent_t  event;
+      uint8_t   status;
+      uint32_t  length;
+
+      tick += GetVarLength(&data[0], trackEnd, &pos);
+      if (pos >= trackEnd)  break;
+      status = data[pos];
+      if (status & 0x80)  pos++;
+      else  status = runningStatus;  // running status
+      if (status == 0)  break;  // corrupt track
+
+      if (status == 0xFF)  // meta event
+      {
+        uint8_t  type = data[pos++];
+        length = GetVarLength(&data[0], trackEnd, &pos);
+        if (type == 0x51 && length == 3 && pos + 3 <= trackEnd)
+        {
+          TempoChange_t  change = { tick, GetBigEndian(&data[pos], 3) };
+          tempoMap.push_back(change);
+        }
+        if (type == 0x2F)  break;  // end of track
+        pos += length;
+        continue;
+      }
+      if (status == 0xF0 || status == 0xF7)  // SysEx
+      {
+        length = GetVarLength(&data[0], trackEnd, &pos);
+        if (status == 0xF0 && pos + length <= trackEnd)
+        {
+          event.msg.push_back(0xF0);
+          event.msg.insert(event.msg.end(), &data[pos], &data[pos] + length);
+          if (event.msg.back() != 0xF7)  event.msg.push_back(0xF7);
+          event.tick = tick;
+          event.order = order++;
+          tickEvents.push_back(event);
+        }
+        pos += length;
+        continue;
+      }
+
+      runningStatus = status;
+      length = ((status & 0xE0) == 0xC0) ? 1 : 2;  // Program change, Channel pressure
+      if (pos + length > trackEnd)  break;
+      event.msg.push_back(status);
+      event.msg.insert(event.msg.end(), &data[pos], &data[pos] + length);
+      event.tick = tick;
+      event.order = order++;
+      tickEvents.push_back(event);
+      pos += length;
+    }
+    pos = trackEnd;
+  }
+
+  std::stable_sort(tickEvents.begin(), tickEvents.end(),
+      [](const TickEvent_t &a, const TickEvent_t &b) { return a.tick < b.tick; });
+  std::stable_sort(tempoMap.begin(), tempoMap.end(),
+      [](const TempoChange_t &a, const TempoChange_t &b) { return a.tick < b.tick; });
+
+  // Convert ticks to microseconds...
+  double    time_us = 0;
+  uint32_t  lastTick = 0, tempo = 500000;  // default 120 BPM
+  size_t    tmap = 0;
+  double    usPerTick;
+
+  for (size_t i = 0;  i < tickEvents.size();  i++)
+  {
+    while (tmap < tempoMap.size() && tempoMap[tmap].tick <= tickEvents[i].tick)
+    {
+      usPerTick = (division & 0x8000) ? 0 : (double) tempo / division;
+      time_us += (tempoMap[tmap].tick - lastTick) * usPerTick;
+      lastTick = tempoMap[tmap].tick;
+      tempo = tempoMap[tmap++].tempo;
+    }
+    if (division & 0x8000)  // SMPTE time division
+      usPerTick = 1e6 / ((256 - (division >> 8)) * (division & 0xFF));
+    else  usPerTick = (double) tempo / division;
+
+    MidiEvent_t  event;
+    event.time_us = (uint32_t)(time_us + (tickEvents[i].tick - lastTick) * usPerTick);
+    event.order = tickEvents[i].order;
+    event.msg = tickEvents[i].msg;
+    m_Events.push_back(event);
+  }
+
+  return true;
+}
+
+
+static void  LoadTestPhrase(void)
+{
+  for (size_t i = 0;  i < sizeof(m_TestPhrase) / sizeof(m_TestPhrase[0]);  i++)
+  {
+    MidiEvent_t  event;
+    event.time_us = m_TestPhrase[i][0] * 1000;
+    event.order = i;
+    event.msg.push_back((uint8_t) m_TestPhrase[i][1]);
+    event.msg.push_back((uint8_t) m_TestPhrase[i][2]);
+    event.msg.push_back((uint8_t) m_TestPhrase[i][3]);
+    m_Events.push_back(event);
+  }
+}
+
+
+static void  PutLE(FILE *fp, uint32_t value, int nbytes)
+{
+  while (nbytes--)  { fputc(value & 0xFF, fp);  value >>= 8; }
+}
+
+
+static bool  WriteWavFile(const char *fileName, const std::vector<int16_t> &pcm, int sampleRate)
+{
+  FILE  *fp = fopen(fileName, "wb");
+  uint32_t  dataSize = pcm.size() * 2;
+
+  if (fp == NULL)  { fprintf(stderr, "Cannot write WAV file: %s\n", fileName);  return false; }
+
+  fwrite("RIFF", 1, 4, fp);  PutLE(fp, 36 + dataSize, 4);
+  fwrite("WAVEfmt ", 1, 8, fp);
+  PutLE(fp, 16, 4);  PutLE(fp, 1, 2);  PutLE(fp, 1, 2);  // PCM, mono
+  PutLE(fp, sampleRate, 4);  PutLE(fp, sampleRate * 2, 4);
+  PutLE(fp, 2, 2);  PutLE(fp, 16, 2);
+  fwrite("data", 1, 4, fp);  PutLE(fp, dataSize, 4);
+  for (size_t i = 0;  i < pcm.size();  i++)  PutLE(fp, (uint16_t) pcm[i], 2);
+  fclose(fp);
+
+  return true;
+}
+
+
+static double  Nanoseconds(Clock::time_point tBegin, Clock::time_point tEnd)
+{
+  return  std::chrono::duration<double, std::nano>(tEnd - tBegin).count();
+}
+
+
+// Insert a Program Change to the given preset at PATCH_SWAP_MS, in time order (option -x).
+//
+static void  InsertPatchChange(int preset)
+{
+  MidiEvent_t  event;
+  size_t  i = 0;
+
+  while (i < m_Events.size() && m_Events[i].time_us <= PATCH_SWAP_MS * 1000)  i++;
+  event.time_us = PATCH_SWAP_MS * 1000;
+  event.order = (uint32_t) m_Events.size();
+  event.msg.push_back(0xC0);  // Program Change, channel 1
+  event.msg.push_back((uint8_t) preset);
+  m_Events.insert(m_Events.begin() + i, event);
+}
+
+
+/*
+ * Function:     Render the MIDI event sequence using a given preset.
+ *
+ * Every millisecond, MIDI events due are processed, then SynthProcess() is called,
+ * then the audio ISR is called for each sample period in the millisecond.
+ * Execution time of each stage is accumulated in the result structure.
+ *
+ * The largest step between successive samples is found in three windows of
+ * SWAP_WINDOW_MS:  before, from and after PATCH_SWAP_MS.  With a patch change at
+ * PATCH_SWAP_MS (option -x), a step in the swap window more than twice as large as in
+ * the windows either side of it is a discontinuity (click), i.e. the patch fade did not
+ * work.  (The new patch may be brighter than the old one, hence the margin.)
+ *
+ * Entry args:   preset = preset number
+ *               pResult = pointer to result structure (output)
+ *               pPCM = pointer to buffer for audio output, or NULL if not wanted
+ */
+static void  RenderSequence(int preset, RenderResult_t *pResult, std::vector<int16_t> *pPCM)
+{
+  int       sampleRate = HostSampleRate();
+  uint32_t  end_ms = m_Opt.tail_ms;
+  uint32_t  hash = 2166136261u;  // FNV-1a offset basis
+  double    sum = 0, sumSquares = 0;
+  int16_t   prevSample = 0;
+  int       window;
+  size_t    next = 0;
+  uint32_t  ms, samples, n;
+  Clock::time_point  t0, t1;
+
+  memset(pResult, 0, sizeof(RenderResult_t));
+  pResult->preset = preset;
+  if (!m_Events.empty())  end_ms += (m_Events.back().time_us + 999) / 1000;
+
+  PresetSelect(preset);  // glitch-free patch swap, if synth running...
+  SynthPrepare();        // ... completed now, so every render starts from the same state
+
+  for (ms = 0;  ms < end_ms;  ms++)
+  {
+    g_HostIO.micros = ms * 1000;
+
+    while (next < m_Events.size() && m_Events[next].time_us <= g_HostIO.micros)
+    {
+      std::vector<uint8_t>  &msg = m_Events[next++].msg;
+      t0 = Clock::now();
+      bool  processed = HostMidiDispatch(&msg[0], (short) msg.size());
+      t1 = Clock::now();
+      if (processed)  { pResult->midi_ns += Nanoseconds(t0, t1);  pResult->midiMsgs++; }
+    }
+
+    t0 = Clock::now();
+    SynthProcess();
+    t1 = Clock::now();
+    pResult->synth_ns += Nanoseconds(t0, t1);
+    pResult->synthCalls++;
+
+    // Number of sample periods in this millisecond (rate not necessarily a multiple of 1k)
+    samples = ((uint64_t)(ms + 1) * sampleRate) / 1000 - ((uint64_t) ms * sampleRate) / 1000;
+
+    t0 = Clock::now();
+    for (n = 0;  n < samples;  n++)
+    {
+      TC3_Handler();
+      if (pPCM != NULL)  pPCM->push_back((int16_t)((g_HostIO.dacWord - 2048) << 4));
+    }
+    t1 = Clock::now();
+    pResult->audio_ns += Nanoseconds(t0, t1);
+
+    // Output analysis -- not included in execution time
+    if (pPCM != NULL)
+    {
+      window = ((int) ms - (PATCH_SWAP_MS - SWAP_WINDOW_MS)) / SWAP_WINDOW_MS;  // 0..2
+      if (ms < PATCH_SWAP_MS - SWAP_WINDOW_MS)  window = -1;
+
+      for (n = pPCM->size() - samples;  n < pPCM->size();  n++)
+      {
+        int16_t  sample = (*pPCM)[n];
+        hash = (hash ^ (uint16_t) sample) * 16777619u;
+        sum += sample;
+        sumSquares += (double) sample * sample;
+        if (abs(sample) > pResult->peak)  pResult->peak = abs(sample);
+        if (window >= 0 && window <= 2 && abs(sample - prevSample) > pResult->swapStep[window])
+          pResult->swapStep[window] = abs(sample - prevSample);
+        prevSample = sample;
+      }
+    }
+    pResult->samples += samples;
+  }
+
+  if (pResult->samples != 0)
+  {
+    pResult->dc = sum / pResult->samples;
+    pResult->rms = sqrt(sumSquares / pResult->samples);
+  }
+  pResult->hash = hash;
+}
+
+
+/*
+ * Function:     Render one preset, in a child process so that the engine starts from the
+ *               power-on state.  The child writes the WAV file (if wanted) and passes the
+ *               render result back to the parent through a pipe.
+ *
+ * Return val:   true if successful, else false
+ */
+static bool  RenderPreset(int preset, RenderResult_t *pResult)
+{
+  int    fd[2];
+  pid_t  pid;
+  int    status = 0;
+
+  fflush(stdout);
+  if (pipe(fd) != 0 || (pid = fork()) < 0)  { perror("fork");  return false; }
+
+  if (pid == 0)  // child process
+  {
+    std::vector<int16_t>  pcm;
+    RenderResult_t  result, repeat;
+    char  wavName[256];
+    bool  ok = true;
+
+    close(fd[0]);
+    HostVoiceInit(m_Opt.midiChannel);
+    if (m_Opt.sampleRate_kHz)  HostSetSampleRate(m_Opt.sampleRate_kHz);
+    pcm.reserve((size_t) HostSampleRate() * 10);
+    RenderSequence(preset, &result, &pcm);
+
+    for (int i = 1;  i < m_Opt.repeats;  i++)  // keep minimum execution times
+    {
+      RenderSequence(preset, &repeat, NULL);
+      result.midi_ns = std::min(result.midi_ns, repeat.midi_ns);
+      result.synth_ns = std::min(result.synth_ns, repeat.synth_ns);
+      result.audio_ns = std::min(result.audio_ns, repeat.audio_ns);
+    }
+
+    if (!m_Opt.noWav)
+    {
+      if (m_Opt.allPresets)  snprintf(wavName, sizeof(wavName), "%s_%02d.wav", m_Opt.wavName, preset);
+      else  snprintf(wavName, sizeof(wavName), "%s.wav", m_Opt.wavName);
+      ok = WriteWavFile(wavName, pcm, HostSampleRate());
+    }
+    if (write(fd[1], &result, sizeof(result)) != sizeof(result))  ok = false;
+    close(fd[1]);
+    _exit(ok ? 0 : 1);
+  }
+
+  close(fd[1]);
+  bool  ok = (read(fd[0], pResult, sizeof(RenderResult_t)) == sizeof(RenderResult_t));
+  close(fd[0]);
+  waitpid(pid, &status, 0);
+
+  return  ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+/*
+ * Function:     Look up the audio output hash of a preset in a JSON summary file written
+ *               previously by this program (one render per line).
+ *
+ * Return val:   true if found, else false
+ */
+static bool  GetGoldenHash(const char *fileName, int preset, uint32_t *pHash)
+{
+  FILE  *fp = fopen(fileName, "r");
+  char  line[512];
+  const char  *field;
+  int   linePreset;
+  bool  found = false;
+
+  if (fp == NULL)  return false;
+  while (!found && fgets(line, sizeof(line), fp) != NULL)
+  {
+    field = strstr(line, "\"preset\": ");
+    if (field == NULL || sscanf(field, "\"preset\": %d", &linePreset) != 1)  continue;
+    if (linePreset != preset)  continue;
+    field = strstr(line, "\"hash\": \"");
+    if (field != NULL && sscanf(field, "\"hash\": \"%8x\"", pHash) == 1)  found = true;
+  }
+  fclose(fp);
+
+  return  found;
+}
+
+
+static void  PrintUsage(void)
+{
+  printf("Usage:  host_render [options] [file.mid]\n");
+  printf("  -p <n>     Preset number (default %d)\n", DEFAULT_PRESET);
+  printf("  -a         Render all presets\n");
+  printf("  -c <n>     Voice MIDI channel 1..15, 0 = Omni On (default 0)\n");
+  printf("  -o <name>  Output WAV file name (default \"render\")\n");
+  printf("  -n         No WAV output\n");
+  printf("  -t <ms>    Render time after last MIDI event (default %d ms)\n", DEFAULT_TAIL_MS);
+  printf("  -r <n>     Repeat each render n times, report minimum execution times\n");
+  printf("  -j <file>  Write JSON summary to file\n");
+  printf("  -g <file>  Compare audio output with golden JSON summary file\n");
+  printf("  -s <kHz>   Audio sample rate 32, 40 or 48 kHz (default 32)\n");
+  printf("  -x <n>     Patch change test: Program Change to preset n mid-note\n");
+}
+
+
+int  main(int argc, char **argv)
+{
+  std::vector<RenderResult_t>  results;
+  RenderResult_t  total;
+  int   opt, preset, firstPreset, lastPreset;
+  int   mismatches = 0, clicks = 0;
+  FILE  *fp;
+
+  while ((opt = getopt(argc, argv, "p:ac:o:nt:r:j:g:s:x:h")) != -1)
+  {
+    switch (opt)
+    {
+      case 'p':  m_Opt.preset = atoi(optarg);  break;
+      case 'a':  m_Opt.allPresets = true;  break;
+      case 'c':  m_Opt.midiChannel = (uint8_t) atoi(optarg);  break;
+      case 'o':  m_Opt.wavName = optarg;  break;
+      case 'n':  m_Opt.noWav = true;  break;
+      case 't':  m_Opt.tail_ms = atoi(optarg);  break;
+      case 'r':  m_Opt.repeats = std::max(1, atoi(optarg));  break;
+      case 'j':  m_Opt.jsonFile = optarg;  break;
+      case 'g':  m_Opt.goldenFile = optarg;  break;
+      case 's':  m_Opt.sampleRate_kHz = (uint8_t) atoi(optarg);  break;
+      case 'x':  m_Opt.swapPreset = atoi(optarg);  break;
+      default:   PrintUsage();  return 1;
+    }
+  }
+  if (optind < argc)  m_Opt.midiFile = argv[optind];
+  if (m_Opt.midiChannel > 15)  { fprintf(stderr, "Invalid MIDI channel\n");  return 1; }
+  if (m_Opt.swapPreset >= 0 && m_Opt.goldenFile != NULL)
+  {
+    fprintf(stderr, "Options -x and -g cannot be combined\n");
+    return 1;
+  }
+  if (m_Opt.sampleRate_kHz)  // check that the voice accepts the rate (parent process)
+  {
+    HostVoiceInit(m_Opt.midiChannel);
+    if (!HostSetSampleRate(m_Opt.sampleRate_kHz))
+    {
+      fprintf(stderr, "Sample rate refused by voice: %d kHz\n", m_Opt.sampleRate_kHz);
+      return 1;
+    }
+  }
+
+  if (m_Opt.midiFile != NULL)
+  {
+    if (!LoadMidiFile(m_Opt.midiFile))  return 1;
+  }
+  else  LoadTestPhrase();
+
+  firstPreset = lastPreset = m_Opt.preset;
+  if (m_Opt.allPresets)  { firstPreset = 0;  lastPreset = GetNumberOfPresets() - 1; }
+  if (firstPreset < 0 || lastPreset >= GetNumberOfPresets())
+  {
+    fprintf(stderr, "Invalid preset number (0..%d)\n", GetNumberOfPresets() - 1);
+    return 1;
+  }
+  if (m_Opt.swapPreset >= GetNumberOfPresets())
+  {
+    fprintf(stderr, "Invalid preset number for -x (0..%d)\n", GetNumberOfPresets() - 1);
+    return 1;
+  }
+  if (m_Opt.swapPreset >= 0)  InsertPatchChange(m_Opt.swapPreset);
+
+  printf("Sample rate: %d Hz,  MIDI events: %d,  input: %s\n\n", HostSampleRate(),
+         (int) m_Events.size(), m_Opt.midiFile ? m_Opt.midiFile : "(test phrase)");
+  printf("Preset  Samples   Peak    RMS      Hash      MIDI ns/msg  Synth ns/call  Audio ns/sample\n");
+
+  memset(&total, 0, sizeof(total));
+  for (preset = firstPreset;  preset <= lastPreset;  preset++)
+  {
+    RenderResult_t  result;
+    uint32_t  goldenHash;
+    const char  *check = "";
+
+    if (!RenderPreset(preset, &result))
+    {
+      fprintf(stderr, "Render failed: preset %d\n", preset);
+      return 1;
+    }
+    if (m_Opt.goldenFile != NULL)
+    {
+      if (!GetGoldenHash(m_Opt.goldenFile, preset, &goldenHash))  check = "  (no golden)";
+      else if (goldenHash == result.hash)  check = "  OK";
+      else  { check = "  ** MISMATCH **";  mismatches++; }
+    }
+    if (m_Opt.swapPreset >= 0)
+    {
+      if (result.swapStep[1] <= 2 * std::max(result.swapStep[0], result.swapStep[2]))
+        check = "  swap OK";
+      else  { check = "  ** CLICK **";  clicks++; }
+    }
+    printf("  %2d   %8u  %6d  %8.1f  %08x  %10.1f  %12.1f  %14.2f%s\n", result.preset,
+           result.samples, result.peak, result.rms, result.hash,
+           result.midiMsgs ? result.midi_ns / result.midiMsgs : 0.0,
+           result.synth_ns / result.synthCalls, result.audio_ns / result.samples, check);
+
+    total.samples += result.samples;
+    total.midiMsgs += result.midiMsgs;
+    total.synthCalls += result.synthCalls;
+    total.midi_ns += result.midi_ns;
+    total.synth_ns += result.synth_ns;
+    total.audio_ns += result.audio_ns;
+    results.push_back(result);
+  }
+
+  double  realTime_ns = 1e9 * total.samples / HostSampleRate();
+  double  realTimeFactor = realTime_ns / (total.midi_ns + total.synth_ns + total.audio_ns);
+
+  printf("\nTotal:  MIDI %.1f ns/msg,  SynthProcess %.1f ns/call,  Audio ISR %.2f ns/sample\n",
+         total.midiMsgs ? total.midi_ns / total.midiMsgs : 0.0,
+         total.synth_ns / total.synthCalls, total.audio_ns / total.samples);
+  printf("Real-time factor: %.1f  (audio ISR %.1f%%, SynthProcess %.1f%%, MIDI %.2f%% of time)\n",
+         realTimeFactor, 100 * total.audio_ns / realTime_ns, 100 * total.synth_ns / realTime_ns,
+         100 * total.midi_ns / realTime_ns);
+  if (m_Opt.goldenFile != NULL)
+    printf("Golden file check: %s  (%d mismatches)\n", mismatches ? "FAILED" : "PASSED", mismatches);
+  if (m_Opt.swapPreset >= 0)
+    printf("Patch change test (to preset %d at %d ms): %s  (%d clicks)\n", m_Opt.swapPreset,
+           PATCH_SWAP_MS, clicks ? "FAILED" : "PASSED", clicks);
+
+  if (m_Opt.jsonFile != NULL && (fp = fopen(m_Opt.jsonFile, "w")) != NULL)
+  {
+    fprintf(fp, "{\n  \"sample_rate_hz\": %d,\n  \"input\": \"%s\",\n  \"tail_ms\": %u,\n",
+            HostSampleRate(), m_Opt.midiFile ? m_Opt.midiFile : "(test phrase)", m_Opt.tail_ms);
+    fprintf(fp, "  \"renders\": [\n");
+    for (size_t i = 0;  i < results.size();  i++)
+    {
+      RenderResult_t  &r = results[i];
+      fprintf(fp, "    { \"preset\": %d, \"samples\": %u, \"peak\": %d, \"rms\": %.2f, "
+              "\"dc\": %.2f, \"hash\": \"%08x\", \"midi_msgs\": %u, \"midi_ns_per_msg\": %.1f, "
+              "\"synth_ns_per_call\": %.1f, \"audio_ns_per_sample\": %.2f }%s\n",
+              r.preset, r.samples, r.peak, r.rms, r.dc, r.hash, r.midiMsgs,
+              r.midiMsgs ? r.midi_ns / r.midiMsgs : 0.0, r.synth_ns / r.synthCalls,
+              r.audio_ns / r.samples, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(fp, "  ],\n  \"timing\": { \"midi_ns_per_msg\": %.1f, \"synth_ns_per_call\": %.1f, "
+            "\"audio_ns_per_sample\": %.2f, \"realtime_factor\": %.1f }\n}\n",
+            total.midiMsgs ? total.midi_ns / total.midiMsgs : 0.0,
+            total.synth_ns / total.synthCalls, total.audio_ns / total.samples, realTimeFactor);
+    fclose(fp);
+  }
+  else if (m_Opt.jsonFile != NULL)
+  {
+    fprintf(stderr, "Cannot write JSON file: %s\n", m_Opt.jsonFile);
+    return 1;
+  }
+
+  return  (mismatches || clicks) ? 2 : 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * File:       Arduino.h  (host shim)
+ *
+ * Minimal Arduino/SAMD21 API for compiling the voice firmware on a desktop host.
+ * Only what the voice firmware uses is provided.  Pin I/O and peripheral set-up
+ * calls do nothing;  the audio DAC output and the system clock are routed to the
+ * host render harness via g_HostIO (see host_io.h).
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "host_io.h"
+
+typedef uint8_t  byte;
+typedef bool     boolean;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define HEX            16
+#define DEC            10
+#define A0             14
+#define A1             15
+#define A2             16
+#define A3             17
+#define A4             18
+#define A5             19
+#define PIO_SERCOM      2
+#define PIO_SERCOM_ALT  3
+#define PIO_TIMER       4
+#define PIO_TIMER_ALT   5
+#define F_CPU    48000000UL
+
+inline void  pinMode(int, int) { }
+inline void  digitalWrite(int, int) { }
+inline int   digitalRead(int) { return HIGH; }
+inline int   analogRead(int) { return 0; }
+inline void  analogReadResolution(int) { }
+inline void  analogWriteResolution(int) { }
+inline void  pinPeripheral(int, int) { }
+
+// On-chip DAC (pin A0, 10 bits) -- scaled to 12 bits, same as SPI DAC code
+inline void  analogWrite(int, int value)
+{
+  g_HostIO.dacWord = (uint16_t)((value << 2) & 0x0FFF);
+  g_HostIO.dacWrites++;
+}
+
+inline uint32_t  millis(void) { return g_HostIO.micros / 1000; }
+inline uint32_t  micros(void) { return g_HostIO.micros; }
+inline void  delay(uint32_t ms) { g_HostIO.micros += ms * 1000; }
+inline void  delayMicroseconds(uint32_t us) { g_HostIO.micros += us; }
+
+inline void  noInterrupts(void) { }
+inline void  interrupts(void) { }
+
+template <class T> T  min(T a, T b) { return (a < b) ? a : b; }
+template <class T> T  max(T a, T b) { return (a > b) ? a : b; }
+#define constrain(x, lo, hi)  ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+// Serial ports -- no input;  output is counted, not stored
+class HostSerial
+{
+public:
+  void    begin(unsigned long) { }
+  int     available(void) { return 0; }
+  int     read(void) { return -1; }
+  int     peek(void) { return -1; }
+  int     availableForWrite(void) { return 64; }
+  void    flush(void) { }
+  size_t  write(uint8_t) { g_HostIO.uartTxBytes++;  return 1; }
+  size_t  write(const uint8_t *, size_t n) { g_HostIO.uartTxBytes += n;  return n; }
+  template <class T> size_t  print(T, int = DEC) { return 0; }
+  template <class T> size_t  println(T, int = DEC) { return 0; }
+  size_t  println(void) { return 0; }
+  operator bool() { return true; }
+};
+
+extern HostSerial  Serial;
+extern HostSerial  Serial1;
+
+// SAMD21 registers accessed directly by the firmware...
+typedef struct { volatile uint32_t reg; } HostReg_t;
+typedef struct { HostReg_t  DIR, DIRCLR, DIRSET, DIRTGL, OUT, OUTCLR, OUTSET, OUTTGL, IN; } HostPortGroup_t;
+typedef struct { HostPortGroup_t  Group[2]; } HostPort_t;
+typedef struct { struct { union { struct { uint8_t MC0:1, MC1:1; } bit;  uint8_t reg; } INTFLAG; } COUNT16; } HostTc_t;
+typedef struct { volatile uint32_t  CTRL, LOAD, VAL, CALIB; } HostSysTick_t;
+
+extern HostPort_t     g_HostPort;
+extern HostTc_t       g_HostTC3;
+extern HostSysTick_t  g_HostSysTick;
+
+#define PORT          (&g_HostPort)
+#define PORT_IOBUS    (&g_HostPort)
+#define TC3           (&g_HostTC3)
+#define SysTick       (&g_HostSysTick)
+
+#endif // HOST_ARDUINO_H
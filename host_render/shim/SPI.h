@@ -0,0 +1,41 @@
+/*
+ * File:       SPI.h  (host shim)
+ *
+ * SPI transfers are assumed to be audio DAC writes (MCP49xx): the last word written
+ * is captured in g_HostIO for the host render harness.
+ */
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0   0
+#define SPI_MODE3   3
+#define MSBFIRST    1
+#define LSBFIRST    0
+
+class SPISettings
+{
+public:
+  SPISettings() { }
+  SPISettings(uint32_t, int, int) { }
+};
+
+class SPIClass
+{
+public:
+  void  begin(void) { }
+  void  beginTransaction(SPISettings) { }
+  void  endTransaction(void) { }
+  uint8_t  transfer(uint8_t data) { return data; }
+  uint16_t  transfer16(uint16_t data)
+  {
+    g_HostIO.dacWord = data & 0x0FFF;
+    g_HostIO.dacWrites++;
+    return 0;
+  }
+};
+
+extern SPIClass  SPI;
+
+#endif // HOST_SPI_H
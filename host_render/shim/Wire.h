@@ -0,0 +1,24 @@
+/*
+ * File:       Wire.h  (host shim) -- I2C is not used by the host render harness.
+ */
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire
+{
+public:
+  void  begin(void) { }
+  void  setClock(uint32_t) { }
+  void  beginTransmission(uint8_t) { }
+  uint8_t  endTransmission(bool = true) { return 0; }
+  size_t  write(uint8_t) { return 1; }
+  uint8_t  requestFrom(uint8_t, uint8_t) { return 0; }
+  int   available(void) { return 0; }
+  int   read(void) { return -1; }
+};
+
+extern TwoWire  Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,13 @@
+/*
+ * File:       fast_samd21_tc3.h  (host shim)
+ *
+ * The audio ISR (TC3_Handler) is called by the host render harness at the sample rate.
+ */
+#ifndef HOST_FAST_SAMD21_TC3_H
+#define HOST_FAST_SAMD21_TC3_H
+
+inline void  fast_samd21_tc3_configure(float) { }
+inline void  fast_samd21_tc3_start(void) { }
+inline void  fast_samd21_tc3_stop(void) { }
+
+#endif // HOST_FAST_SAMD21_TC3_H
@@ -0,0 +1,37 @@
+/*
+ * File:       sketch_protos.h
+ *
+ * Prototypes for voice firmware functions which are not declared in "m0_synth_def.h".
+ * (The Arduino IDE generates these automatically when the sketch is compiled.)
+ * If a function is added to the voice firmware and the host build fails with an
+ * "undeclared identifier" error, add the function prototype here.
+ */
+#ifndef SKETCH_PROTOS_H
+#define SKETCH_PROTOS_H
+
+void      setup();
+void      loop();
+void      SendIsrStatsReply(uint8_t chan, bool reset);
+uint8_t  *SysExPutValue(uint8_t *pBuf, uint32_t value, int nbytes);
+bool      PatchParamsValid(PatchParamTable_t *patch);
+
+fixed_t   GetPitchBendFactor();
+void      ReverbPrepare();
+void      PatchSwapControl();
+uint16_t  ReverbPrimeLength(uint16_t len48k);
+fixed_t   EnvDecayCoeff(uint16_t segTime_ms);
+void      AmpldEnvelopeGenerator(SynthVoice_t *pv);
+void      TransientEnvelopeGen(SynthVoice_t *pv);
+void      ContourGenerator(SynthVoice_t *pv);
+void      AudioLevelController(SynthVoice_t *pv);
+void      LowFrequencyOscillator();
+void      VibratoRampGenerator(SynthVoice_t *pv);
+void      OscFreqModulation(SynthVoice_t *pv);
+void      OscAmpldModulation(SynthVoice_t *pv);
+void      OscActiveListUpdate(SynthVoice_t *pv);
+void      IsrLoadUpdate();
+void      LatencyHistAdd(LatencyHist_t *pHist, uint32_t time_us);
+void      LatencyTraceRecord(SynthVoice_t *pv);
+fixed_t   Base2Exp(fixed_t xval);
+
+#endif // SKETCH_PROTOS_H
@@ -0,0 +1,94 @@
+/*
+ * File:       voice_build.cpp
+ *
+ * Module:     Host (desktop) render harness -- voice firmware compiled for the host.
+ *
+ * The voice firmware source files are compiled here, unmodified, against the hardware
+ * shim in "shim/".  This file also provides the harness with a start-up function
+ * equivalent to setup() and a MIDI message dispatcher equivalent to MidiInputService().
+ */
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+
+#include "m0_synth_def.h"
+#include "sketch_protos.h"
+
+#if USE_DMA_AUDIO_OUTPUT
+#error "Host render requires USE_DMA_AUDIO_OUTPUT = FALSE (TC3 audio ISR)"
+#endif
+
+#include "Sigma_6_Poly_voice.ino"
+#include "m0_synth_engine.ino"
+
+HostIO_t       g_HostIO;
+HostSerial     Serial;
+HostSerial     Serial1;
+SPIClass       SPI;
+TwoWire        Wire;
+HostPort_t     g_HostPort;
+HostTc_t       g_HostTC3;
+HostSysTick_t  g_HostSysTick = { 0, (F_CPU / 1000) - 1, 0, 0 };
+
+
+/*
+ * Function:     Initialize the voice firmware as per setup(), without hardware set-up.
+ *
+ * Entry args:   midiChannel = MIDI channel (1..15) as per channel-select switches,
+ *                             or 0 for 'Omni On' mode (respond to all channels)
+ */
+void  HostVoiceInit(uint8_t midiChannel)
+{
+  g_MidiChannel = midiChannel;
+  if (midiChannel == 0)  g_MidiMode = OMNI_ON_MONO;
+  else  g_MidiMode = OMNI_OFF_MONO;
+
+  DefaultConfigData();
+  SynthInit();
+  PresetSelect(13);   // as per setup()
+  SynthBenchmarkAudio();
+}
+
+
+/*
+ * Function:     Set the audio sample rate by the config CC message sent by the master
+ *               (CC90, broadcast channel), as per InitializeVoiceModules().
+ *
+ * Entry args:   rate_kHz = sample rate (kHz): 32, 40 or 48
+ *
+ * Return val:   TRUE if the voice accepted the sample rate, else FALSE (refused).
+ */
+bool  HostSetSampleRate(uint8_t rate_kHz)
+{
+  uint8_t  midiMessage[3] = { CONTROL_CHANGE_CMD | 15, 90, rate_kHz };
+
+  HostMidiDispatch(midiMessage, 3);
+  return  (g_SampleRate == (uint16_t) rate_kHz * 1000);
+}
+
+
+/*
+ * Function:     Pass a complete MIDI message to ProcessMidiMessage(), subject to the same
+ *               channel filter as applied by MidiInputService().
+ *
+ * Return val:   TRUE if the message was processed, else FALSE (ignored).
+ */
+bool  HostMidiDispatch(uint8_t *midiMessage, short msgLength)
+{
+  uint8_t  msgChannel = (midiMessage[0] & 0x0F) + 1;  // 1..16
+
+  if (msgChannel == g_MidiChannel || msgChannel == 16
+  ||  g_MidiMode == OMNI_ON_MONO  || midiMessage[0] == SYS_EXCLUSIVE_MSG
+  ||  (DUAL_VOICE_ENGINE && msgChannel == g_MidiChannel + 1))
+  {
+    ProcessMidiMessage(midiMessage, msgLength);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+int  HostSampleRate(void)
+{
+  return  g_SampleRate;
+}